@@ -4557,6 +4557,42 @@ gsk_text_node_new (PangoFont              *font,
   return node;
 }
 
+/*<private>
+ * gsk_text_node_new_translated:
+ * @node: (type GskTextNode): a text `GskRenderNode`
+ * @dx: horizontal offset to add
+ * @dy: vertical offset to add
+ *
+ * Creates a copy of @node that is moved by @dx and @dy,
+ * without measuring the glyphs again.
+ *
+ * Returns: (transfer full) (type GskTextNode): a new `GskRenderNode`
+ */
+GskRenderNode *
+gsk_text_node_new_translated (const GskRenderNode *node,
+                              float                dx,
+                              float                dy)
+{
+  const GskTextNode *other = (const GskTextNode *) node;
+  GskTextNode *self;
+  GskRenderNode *result;
+
+  self = gsk_render_node_alloc (GSK_TEXT_NODE);
+  result = (GskRenderNode *) self;
+  result->offscreen_for_opacity = FALSE;
+
+  self->font = g_object_ref (other->font);
+  self->color = other->color;
+  self->offset = GRAPHENE_POINT_INIT (other->offset.x + dx, other->offset.y + dy);
+  self->has_color_glyphs = other->has_color_glyphs;
+  self->glyphs = g_memdup2 (other->glyphs, other->num_glyphs * sizeof (PangoGlyphInfo));
+  self->num_glyphs = other->num_glyphs;
+
+  graphene_rect_offset_r (&node->bounds, dx, dy, &result->bounds);
+
+  return result;
+}
+
 /**
  * gsk_text_node_get_color:
  * @node: (type GskTextNode): a text `GskRenderNode`
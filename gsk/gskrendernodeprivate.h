@@ -105,6 +105,9 @@ bool            gsk_border_node_get_uniform_color       (const GskRenderNode
 
 void            gsk_text_node_serialize_glyphs          (GskRenderNode               *self,
                                                          GString                     *str);
+GskRenderNode * gsk_text_node_new_translated            (const GskRenderNode         *node,
+                                                         float                        dx,
+                                                         float                        dy);
 
 GskRenderNode ** gsk_container_node_get_children        (const GskRenderNode *node,
                                                          guint               *n_children);
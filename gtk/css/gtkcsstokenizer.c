@@ -825,12 +825,60 @@ gtk_css_tokenizer_consume_char (GtkCssTokenizer *tokenizer,
     }
 }
 
+/*
+ * gtk_css_tokenizer_consume_text:
+ * @tokenizer: a tokenizer
+ * @end: the position to advance to
+ *
+ * Advances the tokenizer to @end, which must be inside the
+ * remaining data and on a character boundary. Unlike the other
+ * consume functions, the skipped text may contain newlines.
+ *
+ * This is used to skip large chunks of input like comments without
+ * looking at every character individually.
+ */
+static void
+gtk_css_tokenizer_consume_text (GtkCssTokenizer *tokenizer,
+                                const char      *end)
+{
+  while (tokenizer->data < end)
+    {
+      const char *data;
+      gsize n_chars = 0;
+
+      for (data = tokenizer->data; data < end && !is_newline (*data); data++)
+        {
+          /* count everything but UTF-8 continuation bytes */
+          if ((*data & 0xC0) != 0x80)
+            n_chars++;
+        }
+
+      gtk_css_tokenizer_consume (tokenizer, data - tokenizer->data, n_chars);
+
+      if (tokenizer->data < end)
+        gtk_css_tokenizer_consume_newline (tokenizer);
+    }
+}
+
 static void
 gtk_css_tokenizer_read_whitespace (GtkCssTokenizer *tokenizer,
                                    GtkCssToken     *token)
 {
   do {
-    gtk_css_tokenizer_consume_whitespace (tokenizer);
+    const char *data;
+
+    /* Indentation is by far the most common whitespace, so skip
+     * runs of spaces and tabs in one go.
+     */
+    for (data = tokenizer->data;
+         data < tokenizer->end && (*data == ' ' || *data == '\t');
+         data++)
+      ;
+
+    if (data > tokenizer->data)
+      gtk_css_tokenizer_consume (tokenizer, data - tokenizer->data, data - tokenizer->data);
+    else
+      gtk_css_tokenizer_consume_newline (tokenizer);
   } while (tokenizer->data != tokenizer->end &&
            is_whitespace (*tokenizer->data));
 
@@ -878,7 +926,28 @@ gtk_css_tokenizer_read_escape (GtkCssTokenizer *tokenizer)
 static char *
 gtk_css_tokenizer_read_name (GtkCssTokenizer *tokenizer)
 {
-  g_string_set_size (tokenizer->name_buffer, 0);
+  const char *data;
+
+  /* Fast path: Almost all names are plain ASCII without escapes,
+   * so we can copy them straight out of the input.
+   */
+  for (data = tokenizer->data;
+       data < tokenizer->end && is_name (*data) && !is_multibyte (*data);
+       data++)
+    ;
+
+  if (data == tokenizer->end || (*data != '\\' && !is_multibyte (*data)))
+    {
+      const char *start = tokenizer->data;
+
+      gtk_css_tokenizer_consume (tokenizer, data - start, data - start);
+
+      return g_strndup (start, data - start);
+    }
+
+  g_string_truncate (tokenizer->name_buffer, 0);
+  g_string_append_len (tokenizer->name_buffer, tokenizer->data, data - tokenizer->data);
+  gtk_css_tokenizer_consume (tokenizer, data - tokenizer->data, data - tokenizer->data);
 
   do {
       if (*tokenizer->data == '\\')
@@ -1234,7 +1303,16 @@ gtk_css_tokenizer_read_string (GtkCssTokenizer  *tokenizer,
         }
       else
         {
-          gtk_css_tokenizer_consume_char (tokenizer, string);
+          const char *data;
+
+          /* Append the whole run of plain characters at once */
+          for (data = tokenizer->data + 1;
+               data < tokenizer->end && *data != end && *data != '\\' && !is_newline (*data);
+               data++)
+            ;
+
+          g_string_append_len (string, tokenizer->data, data - tokenizer->data);
+          gtk_css_tokenizer_consume_text (tokenizer, data);
         }
     }
 
@@ -1248,20 +1326,25 @@ gtk_css_tokenizer_read_comment (GtkCssTokenizer  *tokenizer,
                                 GtkCssToken      *token,
                                 GError          **error)
 {
+  const char *data;
+
   gtk_css_tokenizer_consume (tokenizer, 2, 2);
 
-  while (tokenizer->data < tokenizer->end)
+  for (data = memchr (tokenizer->data, '*', tokenizer->end - tokenizer->data);
+       data != NULL && data + 1 < tokenizer->end;
+       data = memchr (data + 1, '*', tokenizer->end - data - 1))
     {
-      if (gtk_css_tokenizer_remaining (tokenizer) > 1 &&
-          tokenizer->data[0] == '*' && tokenizer->data[1] == '/')
+      if (data[1] == '/')
         {
+          gtk_css_tokenizer_consume_text (tokenizer, data);
           gtk_css_tokenizer_consume (tokenizer, 2, 2);
           gtk_css_token_init (token, GTK_CSS_TOKEN_COMMENT);
           return TRUE;
         }
-      gtk_css_tokenizer_consume_char (tokenizer, NULL);
     }
 
+  gtk_css_tokenizer_consume_text (tokenizer, tokenizer->end);
+
   gtk_css_token_init (token, GTK_CSS_TOKEN_COMMENT);
   gtk_css_tokenizer_parse_error (error, "Comment not terminated at end of document.");
   return FALSE;
@@ -27,10 +27,13 @@
 #include "gtktextviewprivate.h"
 #include "gtkwidgetprivate.h"
 #include "gtkcsscolorvalueprivate.h"
+#include "gdk/gdkprofilerprivate.h"
 
 #include <math.h>
+#include <string.h>
 
 #include <pango/pango.h>
+#include <pango/pangocairo.h>
 #include <cairo.h>
 
 G_DEFINE_TYPE (GskPangoRenderer, gsk_pango_renderer, PANGO_TYPE_RENDERER)
@@ -451,6 +454,416 @@ gsk_pango_renderer_release (GskPangoRenderer *renderer)
     g_object_unref (renderer);
 }
 
+/* The layout cache
+ *
+ * Lists and grids tend to contain many labels with the same text,
+ * like "Yes", "No" or dates, that are rendered in the same font and
+ * color. We keep the render nodes for recently rendered layouts in
+ * a cache shared by all widgets, so that they don't need to be
+ * turned into text nodes again, which needs the ink extents of all
+ * their glyphs.
+ *
+ * The key is everything that affects the output: the text and
+ * attributes, the layout and context settings, the fontmap and the
+ * color. Entries are evicted in least-recently-used order once the
+ * cache grows over its size budget.
+ *
+ * The nodes are recorded without a transform and replayed at the
+ * current offset of the snapshot, so the result is the same as
+ * when rendering the layout directly. Layouts that need other
+ * nodes than text and color nodes, like error underlines, are
+ * remembered as such and always rendered directly.
+ */
+
+#define LAYOUT_CACHE_MAX_BYTES (2 * 1024 * 1024)
+#define LAYOUT_CACHE_MAX_TEXT 1024
+
+typedef struct _LayoutCacheEntry LayoutCacheEntry;
+
+struct _LayoutCacheEntry
+{
+  GList link;
+  gsize size;
+  guint hash;
+
+  char *text;
+  PangoAttrList *attrs;
+  PangoFontDescription *font_desc;
+  PangoFontDescription *context_font_desc;
+  cairo_font_options_t *font_options;
+
+  PangoFontMap *fontmap;
+  guint fontmap_serial;
+  PangoLanguage *language;
+  double resolution;
+  PangoDirection base_dir;
+  PangoGravity gravity;
+  PangoGravityHint gravity_hint;
+  gboolean round_glyph_positions;
+
+  int width;
+  int height;
+  int indent;
+  int spacing;
+  float line_spacing;
+  PangoWrapMode wrap;
+  PangoEllipsizeMode ellipsize;
+  PangoAlignment alignment;
+  gboolean justify;
+  gboolean justify_last_line;
+  gboolean auto_dir;
+  gboolean single_paragraph;
+
+  GdkRGBA color;
+
+  GskRenderNode *node; /* NULL if nothing is drawn */
+  gboolean replayable;
+};
+
+static GHashTable *layout_cache; /* MT-safe */
+static GQueue layout_cache_lru = G_QUEUE_INIT;
+static gsize layout_cache_size;
+static guint64 layout_cache_hits;
+static guint64 layout_cache_misses;
+static guint layout_cache_hits_counter;
+static guint layout_cache_misses_counter;
+static guint layout_cache_size_counter;
+G_LOCK_DEFINE_STATIC (layout_cache);
+
+static guint
+layout_cache_entry_hash (gconstpointer data)
+{
+  const LayoutCacheEntry *entry = data;
+
+  return entry->hash;
+}
+
+static gboolean
+font_description_equal (const PangoFontDescription *desc1,
+                        const PangoFontDescription *desc2)
+{
+  if (desc1 == NULL || desc2 == NULL)
+    return desc1 == desc2;
+
+  return pango_font_description_equal (desc1, desc2);
+}
+
+static gboolean
+layout_cache_entry_equal (gconstpointer data1,
+                          gconstpointer data2)
+{
+  const LayoutCacheEntry *entry1 = data1;
+  const LayoutCacheEntry *entry2 = data2;
+
+  if (entry1->fontmap != entry2->fontmap ||
+      entry1->fontmap_serial != entry2->fontmap_serial ||
+      entry1->language != entry2->language ||
+      entry1->resolution != entry2->resolution ||
+      entry1->base_dir != entry2->base_dir ||
+      entry1->gravity != entry2->gravity ||
+      entry1->gravity_hint != entry2->gravity_hint ||
+      entry1->round_glyph_positions != entry2->round_glyph_positions ||
+      entry1->width != entry2->width ||
+      entry1->height != entry2->height ||
+      entry1->indent != entry2->indent ||
+      entry1->spacing != entry2->spacing ||
+      entry1->line_spacing != entry2->line_spacing ||
+      entry1->wrap != entry2->wrap ||
+      entry1->ellipsize != entry2->ellipsize ||
+      entry1->alignment != entry2->alignment ||
+      entry1->justify != entry2->justify ||
+      entry1->justify_last_line != entry2->justify_last_line ||
+      entry1->auto_dir != entry2->auto_dir ||
+      entry1->single_paragraph != entry2->single_paragraph ||
+      !gdk_rgba_equal (&entry1->color, &entry2->color))
+    return FALSE;
+
+  if (strcmp (entry1->text, entry2->text) != 0)
+    return FALSE;
+
+  if (!font_description_equal (entry1->font_desc, entry2->font_desc) ||
+      !font_description_equal (entry1->context_font_desc, entry2->context_font_desc))
+    return FALSE;
+
+  if (entry1->font_options == NULL || entry2->font_options == NULL)
+    {
+      if (entry1->font_options != entry2->font_options)
+        return FALSE;
+    }
+  else if (!cairo_font_options_equal (entry1->font_options, entry2->font_options))
+    return FALSE;
+
+  if (entry1->attrs == NULL || entry2->attrs == NULL)
+    return entry1->attrs == entry2->attrs;
+
+  return pango_attr_list_equal (entry1->attrs, entry2->attrs);
+}
+
+static void
+layout_cache_entry_free (gpointer data)
+{
+  LayoutCacheEntry *entry = data;
+
+  g_free (entry->text);
+  g_clear_pointer (&entry->attrs, pango_attr_list_unref);
+  g_clear_pointer (&entry->font_desc, pango_font_description_free);
+  g_clear_pointer (&entry->context_font_desc, pango_font_description_free);
+  g_clear_pointer (&entry->font_options, cairo_font_options_destroy);
+  g_clear_object (&entry->fontmap);
+  g_clear_pointer (&entry->node, gsk_render_node_unref);
+
+  g_free (entry);
+}
+
+static gboolean
+filter_uncacheable (PangoAttribute *attr,
+                    gpointer        data)
+{
+  gboolean *uncacheable = data;
+
+  /* Shapes are drawn by callbacks, and appearances depend on
+   * the renderer state.
+   */
+  if (attr->klass->type == PANGO_ATTR_SHAPE ||
+      attr->klass->type == gtk_text_attr_appearance_type)
+    *uncacheable = TRUE;
+
+  return FALSE;
+}
+
+/* Fills in @key with borrowed values from @layout, returns
+ * %FALSE if the rendering of @layout can't be cached.
+ */
+static gboolean
+layout_cache_key_init (LayoutCacheEntry *key,
+                       PangoLayout      *layout,
+                       const GdkRGBA    *color)
+{
+  PangoContext *context = pango_layout_get_context (layout);
+  const char *text;
+  gboolean uncacheable = FALSE;
+
+  text = pango_layout_get_text (layout);
+  if (strlen (text) > LAYOUT_CACHE_MAX_TEXT)
+    return FALSE;
+
+  if (pango_layout_get_tabs (layout) != NULL ||
+      pango_context_get_matrix (context) != NULL)
+    return FALSE;
+
+  key->attrs = pango_layout_get_attributes (layout);
+  if (key->attrs)
+    {
+      PangoAttrList *filtered;
+
+      filtered = pango_attr_list_filter (key->attrs, filter_uncacheable, &uncacheable);
+      g_clear_pointer (&filtered, pango_attr_list_unref);
+      if (uncacheable)
+        return FALSE;
+    }
+
+  key->text = (char *) text;
+  key->font_desc = (PangoFontDescription *) pango_layout_get_font_description (layout);
+  key->context_font_desc = pango_context_get_font_description (context);
+  key->font_options = (cairo_font_options_t *) pango_cairo_context_get_font_options (context);
+
+  key->fontmap = pango_context_get_font_map (context);
+  key->fontmap_serial = pango_font_map_get_serial (key->fontmap);
+  key->language = pango_context_get_language (context);
+  key->resolution = pango_cairo_context_get_resolution (context);
+  key->base_dir = pango_context_get_base_dir (context);
+  key->gravity = pango_context_get_base_gravity (context);
+  key->gravity_hint = pango_context_get_gravity_hint (context);
+  key->round_glyph_positions = pango_context_get_round_glyph_positions (context);
+
+  key->width = pango_layout_get_width (layout);
+  key->height = pango_layout_get_height (layout);
+  key->indent = pango_layout_get_indent (layout);
+  key->spacing = pango_layout_get_spacing (layout);
+  key->line_spacing = pango_layout_get_line_spacing (layout);
+  key->wrap = pango_layout_get_wrap (layout);
+  key->ellipsize = pango_layout_get_ellipsize (layout);
+  key->alignment = pango_layout_get_alignment (layout);
+  key->justify = pango_layout_get_justify (layout);
+  key->justify_last_line = pango_layout_get_justify_last_line (layout);
+  key->auto_dir = pango_layout_get_auto_dir (layout);
+  key->single_paragraph = pango_layout_get_single_paragraph_mode (layout);
+
+  key->color = *color;
+
+  key->hash = g_str_hash (text)
+              ^ (key->context_font_desc ? pango_font_description_hash (key->context_font_desc) : 0)
+              ^ ((guint) key->width * 31)
+              ^ gdk_rgba_hash (color);
+
+  return TRUE;
+}
+
+static void
+layout_cache_update_counters (void)
+{
+  if (!GDK_PROFILER_IS_RUNNING)
+    return;
+
+  gdk_profiler_set_int_counter (layout_cache_hits_counter, layout_cache_hits);
+  gdk_profiler_set_int_counter (layout_cache_misses_counter, layout_cache_misses);
+  gdk_profiler_set_int_counter (layout_cache_size_counter, layout_cache_size);
+}
+
+/* Looks up @key and returns the recorded node in @node and
+ * whether it can be replayed in @replayable.
+ */
+static gboolean
+layout_cache_lookup (const LayoutCacheEntry  *key,
+                     GskRenderNode          **node,
+                     gboolean                *replayable)
+{
+  LayoutCacheEntry *entry;
+
+  G_LOCK (layout_cache);
+
+  if (G_UNLIKELY (layout_cache == NULL))
+    {
+      layout_cache = g_hash_table_new_full (layout_cache_entry_hash,
+                                            layout_cache_entry_equal,
+                                            NULL,
+                                            layout_cache_entry_free);
+      layout_cache_hits_counter = gdk_profiler_define_int_counter ("layout-cache-hits", "Layouts rendered from the cache");
+      layout_cache_misses_counter = gdk_profiler_define_int_counter ("layout-cache-misses", "Layouts rendered and added to the cache");
+      layout_cache_size_counter = gdk_profiler_define_int_counter ("layout-cache-size", "Estimated size of the layout cache in bytes");
+    }
+
+  entry = g_hash_table_lookup (layout_cache, key);
+  if (entry)
+    {
+      g_queue_unlink (&layout_cache_lru, &entry->link);
+      g_queue_push_head_link (&layout_cache_lru, &entry->link);
+      *node = entry->node ? gsk_render_node_ref (entry->node) : NULL;
+      *replayable = entry->replayable;
+      layout_cache_hits++;
+    }
+  else
+    layout_cache_misses++;
+
+  layout_cache_update_counters ();
+
+  G_UNLOCK (layout_cache);
+
+  return entry != NULL;
+}
+
+static void
+layout_cache_insert (const LayoutCacheEntry *key,
+                     GskRenderNode          *node,
+                     gboolean                replayable)
+{
+  LayoutCacheEntry *entry;
+  gsize len;
+
+  len = strlen (key->text);
+
+  entry = g_memdup2 (key, sizeof (LayoutCacheEntry));
+  entry->link.data = entry;
+  entry->link.prev = entry->link.next = NULL;
+  entry->text = g_strndup (key->text, len);
+  if (key->attrs)
+    entry->attrs = pango_attr_list_copy (key->attrs);
+  if (key->font_desc)
+    entry->font_desc = pango_font_description_copy (key->font_desc);
+  if (key->context_font_desc)
+    entry->context_font_desc = pango_font_description_copy (key->context_font_desc);
+  if (key->font_options)
+    entry->font_options = cairo_font_options_copy (key->font_options);
+  /* Keep the fontmap, so no other one can show up at its address */
+  g_object_ref (entry->fontmap);
+  entry->node = node ? gsk_render_node_ref (node) : NULL;
+  entry->replayable = replayable;
+
+  /* A rough estimate: roughly one glyph per byte of text */
+  entry->size = sizeof (LayoutCacheEntry) + len + len * sizeof (PangoGlyphInfo) + 256;
+
+  G_LOCK (layout_cache);
+
+  if (g_hash_table_contains (layout_cache, entry))
+    {
+      G_UNLOCK (layout_cache);
+      layout_cache_entry_free (entry);
+      return;
+    }
+
+  g_hash_table_add (layout_cache, entry);
+  g_queue_push_head_link (&layout_cache_lru, &entry->link);
+  layout_cache_size += entry->size;
+
+  while (layout_cache_size > LAYOUT_CACHE_MAX_BYTES)
+    {
+      LayoutCacheEntry *last = g_queue_peek_tail (&layout_cache_lru);
+
+      g_queue_unlink (&layout_cache_lru, &last->link);
+      layout_cache_size -= last->size;
+      g_hash_table_remove (layout_cache, last);
+    }
+
+  layout_cache_update_counters ();
+
+  G_UNLOCK (layout_cache);
+}
+
+static gboolean
+layout_cache_can_replay (GskRenderNode *node)
+{
+  guint i;
+
+  switch ((int) gsk_render_node_get_node_type (node))
+    {
+    case GSK_TEXT_NODE:
+    case GSK_COLOR_NODE:
+      return TRUE;
+
+    case GSK_CONTAINER_NODE:
+      for (i = 0; i < gsk_container_node_get_n_children (node); i++)
+        {
+          if (!layout_cache_can_replay (gsk_container_node_get_child (node, i)))
+            return FALSE;
+        }
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/* Appends the nodes that rendering the layout into @snapshot
+ * would have created.
+ */
+static void
+layout_cache_replay (GtkSnapshot   *snapshot,
+                     GskRenderNode *node)
+{
+  graphene_rect_t bounds;
+  guint i;
+
+  switch ((int) gsk_render_node_get_node_type (node))
+    {
+    case GSK_TEXT_NODE:
+      gtk_snapshot_append_text_node (snapshot, node);
+      break;
+
+    case GSK_COLOR_NODE:
+      gsk_render_node_get_bounds (node, &bounds);
+      gtk_snapshot_append_color (snapshot, gsk_color_node_get_color (node), &bounds);
+      break;
+
+    case GSK_CONTAINER_NODE:
+      for (i = 0; i < gsk_container_node_get_n_children (node); i++)
+        layout_cache_replay (snapshot, gsk_container_node_get_child (node, i));
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
+
 /**
  * gtk_snapshot_append_layout:
  * @snapshot: a `GtkSnapshot`
@@ -467,10 +880,58 @@ gtk_snapshot_append_layout (GtkSnapshot   *snapshot,
                             const GdkRGBA *color)
 {
   GskPangoRenderer *crenderer;
+  LayoutCacheEntry key;
+  GskRenderNode *node = NULL;
+  gboolean cacheable, replayable;
 
   g_return_if_fail (snapshot != NULL);
   g_return_if_fail (PANGO_IS_LAYOUT (layout));
 
+  cacheable = layout_cache_key_init (&key, layout, color);
+  if (cacheable && layout_cache_lookup (&key, &node, &replayable))
+    {
+      if (replayable)
+        {
+          if (node)
+            {
+              layout_cache_replay (snapshot, node);
+              gsk_render_node_unref (node);
+            }
+          return;
+        }
+
+      cacheable = FALSE;
+    }
+
+  if (cacheable)
+    {
+      crenderer = gsk_pango_renderer_acquire ();
+      crenderer->snapshot = gtk_snapshot_new ();
+      crenderer->fg_color = color;
+
+      pango_renderer_draw_layout (PANGO_RENDERER (crenderer), layout, 0, 0);
+
+      node = gtk_snapshot_free_to_node (crenderer->snapshot);
+      crenderer->snapshot = NULL;
+      gsk_pango_renderer_release (crenderer);
+
+      replayable = node == NULL || layout_cache_can_replay (node);
+      layout_cache_insert (&key, replayable ? node : NULL, replayable);
+
+      if (replayable)
+        {
+          if (node)
+            {
+              layout_cache_replay (snapshot, node);
+              gsk_render_node_unref (node);
+            }
+          return;
+        }
+
+      /* Rare enough to just render it again */
+      g_clear_pointer (&node, gsk_render_node_unref);
+    }
+
   crenderer = gsk_pango_renderer_acquire ();
 
   crenderer->snapshot = snapshot;
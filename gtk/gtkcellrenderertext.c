@@ -1528,7 +1528,7 @@ get_size (GtkCellRenderer    *cell,
 
       style_context = gtk_widget_get_style_context (widget);
 
-      font_desc = gtk_css_style_get_pango_font (gtk_style_context_lookup_style (style_context));
+      font_desc = pango_font_description_copy (gtk_css_style_get_pango_font (gtk_style_context_lookup_style (style_context)));
       pango_font_description_merge_static (font_desc, priv->font, TRUE);
 
       if (priv->scale_set)
@@ -119,29 +119,7 @@ gtk_css_animated_style_init (GtkCssAnimatedStyle *style)
 {
 }
 
-#define DEFINE_UNSHARE(TYPE, NAME) \
-static inline void \
-unshare_ ## NAME (GtkCssAnimatedStyle *animated) \
-{ \
-  GtkCssStyle *style = (GtkCssStyle *)animated; \
-  if (style->NAME == animated->style->NAME) \
-    { \
-      gtk_css_values_unref ((GtkCssValues *)style->NAME); \
-      style->NAME = (TYPE *)gtk_css_values_copy ((GtkCssValues *)animated->style->NAME); \
-    } \
-}
-
-DEFINE_UNSHARE (GtkCssCoreValues, core)
-DEFINE_UNSHARE (GtkCssBackgroundValues, background)
-DEFINE_UNSHARE (GtkCssBorderValues, border)
-DEFINE_UNSHARE (GtkCssIconValues, icon)
-DEFINE_UNSHARE (GtkCssOutlineValues, outline)
-DEFINE_UNSHARE (GtkCssFontValues, font)
-DEFINE_UNSHARE (GtkCssFontVariantValues, font_variant)
-DEFINE_UNSHARE (GtkCssAnimationValues, animation)
-DEFINE_UNSHARE (GtkCssTransitionValues, transition)
-DEFINE_UNSHARE (GtkCssSizeValues, size)
-DEFINE_UNSHARE (GtkCssOtherValues, other)
+#define GET_VALUES(v) (GtkCssValue **)((guint8*)(v) + sizeof (GtkCssValues))
 
 static inline void
 gtk_css_take_value (GtkCssValue **variable,
@@ -158,385 +136,27 @@ gtk_css_animated_style_set_animated_value (GtkCssAnimatedStyle *animated,
                                            GtkCssValue         *value)
 {
   GtkCssStyle *style = (GtkCssStyle *)animated;
+  const GtkCssPropertySlot *slot;
+  GtkCssValues **values;
+  GtkCssValue **v;
 
   gtk_internal_return_if_fail (GTK_IS_CSS_ANIMATED_STYLE (style));
   gtk_internal_return_if_fail (value != NULL);
 
-  switch (id)
+  slot = gtk_css_static_style_get_property_slot (id);
+  values = &G_STRUCT_MEMBER (GtkCssValues *, style, slot->offset);
+
+  /* Groups are shared with the base style until we animate a value in them */
+  if (*values == G_STRUCT_MEMBER (GtkCssValues *, animated->style, slot->offset))
     {
-    case GTK_CSS_PROPERTY_COLOR:
-      unshare_core (animated);
-      gtk_css_take_value (&style->core->color, value);
-      break;
-    case GTK_CSS_PROPERTY_DPI:
-      unshare_core (animated);
-      gtk_css_take_value (&style->core->dpi, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_SIZE:
-      unshare_core (animated);
-      gtk_css_take_value (&style->core->font_size, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_PALETTE:
-      unshare_core (animated);
-      gtk_css_take_value (&style->core->icon_palette, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_COLOR:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_color, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_FAMILY:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_family, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_STYLE:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_style, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_WEIGHT:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_weight, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_STRETCH:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_stretch, value);
-      break;
-    case GTK_CSS_PROPERTY_LETTER_SPACING:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->letter_spacing, value);
-      break;
-    case GTK_CSS_PROPERTY_LINE_HEIGHT:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->line_height, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_LINE:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->text_decoration_line, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_COLOR:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->text_decoration_color, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_STYLE:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->text_decoration_style, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_TRANSFORM:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->text_transform, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_KERNING:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_kerning, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_LIGATURES:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_ligatures, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_POSITION:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_position, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_CAPS:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_caps, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_NUMERIC:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_numeric, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_ALTERNATES:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_alternates, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_EAST_ASIAN:
-      unshare_font_variant (animated);
-      gtk_css_take_value (&style->font_variant->font_variant_east_asian, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_SHADOW:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->text_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_BOX_SHADOW:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->box_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_TOP:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->margin_top, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_LEFT:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->margin_left, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_BOTTOM:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->margin_bottom, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_RIGHT:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->margin_right, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_TOP:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->padding_top, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_LEFT:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->padding_left, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_BOTTOM:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->padding_bottom, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_RIGHT:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->padding_right, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_STYLE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_top_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_WIDTH:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_top_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_STYLE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_left_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_WIDTH:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_left_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_STYLE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_bottom_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_WIDTH:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_bottom_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_STYLE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_right_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_WIDTH:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_right_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_LEFT_RADIUS:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_top_left_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_RIGHT_RADIUS:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_top_right_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_RIGHT_RADIUS:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_bottom_right_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_LEFT_RADIUS:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_bottom_left_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_STYLE:
-      unshare_outline (animated);
-      gtk_css_take_value (&style->outline->outline_style, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_WIDTH:
-      unshare_outline (animated);
-      gtk_css_take_value (&style->outline->outline_width, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_OFFSET:
-      unshare_outline (animated);
-      gtk_css_take_value (&style->outline->outline_offset, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_CLIP:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_clip, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_ORIGIN:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_origin, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_SIZE:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_size, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_POSITION:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_position, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_COLOR:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_top_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_COLOR:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_right_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_COLOR:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_bottom_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_COLOR:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_left_color, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_COLOR:
-      unshare_outline (animated);
-      gtk_css_take_value (&style->outline->outline_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_REPEAT:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_repeat, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_IMAGE:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_image, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_BLEND_MODE:
-      unshare_background (animated);
-      gtk_css_take_value (&style->background->background_blend_mode, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_SOURCE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_image_source, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_REPEAT:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_image_repeat, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_SLICE:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_image_slice, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_WIDTH:
-      unshare_border (animated);
-      gtk_css_take_value (&style->border->border_image_width, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SOURCE:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->icon_source, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SIZE:
-      unshare_icon (animated);
-      gtk_css_take_value (&style->icon->icon_size, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SHADOW:
-      unshare_icon (animated);
-      gtk_css_take_value (&style->icon->icon_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_STYLE:
-      unshare_icon (animated);
-      gtk_css_take_value (&style->icon->icon_style, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_TRANSFORM:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->icon_transform, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_FILTER:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->icon_filter, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_SPACING:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->border_spacing, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSFORM:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->transform, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSFORM_ORIGIN:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->transform_origin, value);
-      break;
-    case GTK_CSS_PROPERTY_MIN_WIDTH:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->min_width, value);
-      break;
-    case GTK_CSS_PROPERTY_MIN_HEIGHT:
-      unshare_size (animated);
-      gtk_css_take_value (&style->size->min_height, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_PROPERTY:
-      unshare_transition (animated);
-      gtk_css_take_value (&style->transition->transition_property, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_DURATION:
-      unshare_transition (animated);
-      gtk_css_take_value (&style->transition->transition_duration, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_TIMING_FUNCTION:
-      unshare_transition (animated);
-      gtk_css_take_value (&style->transition->transition_timing_function, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_DELAY:
-      unshare_transition (animated);
-      gtk_css_take_value (&style->transition->transition_delay, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_NAME:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_name, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DURATION:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_duration, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_TIMING_FUNCTION:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_timing_function, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_ITERATION_COUNT:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_iteration_count, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DIRECTION:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_direction, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_PLAY_STATE:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_play_state, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DELAY:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_delay, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_FILL_MODE:
-      unshare_animation (animated);
-      gtk_css_take_value (&style->animation->animation_fill_mode, value);
-      break;
-    case GTK_CSS_PROPERTY_OPACITY:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->opacity, value);
-      break;
-    case GTK_CSS_PROPERTY_FILTER:
-      unshare_other (animated);
-      gtk_css_take_value (&style->other->filter, value);
-      break;
-    case GTK_CSS_PROPERTY_CARET_COLOR:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->caret_color, value);
-      break;
-    case GTK_CSS_PROPERTY_SECONDARY_CARET_COLOR:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->secondary_caret_color, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_FEATURE_SETTINGS:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_feature_settings, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIATION_SETTINGS:
-      unshare_font (animated);
-      gtk_css_take_value (&style->font->font_variation_settings, value);
-      break;
-
-    default:
-      g_assert_not_reached ();
-      break;
+      GtkCssValues *copy = gtk_css_values_copy (*values);
+
+      gtk_css_values_unref (*values);
+      *values = copy;
     }
+
+  v = GET_VALUES (*values);
+  gtk_css_take_value (&v[slot->index], value);
 }
 
 GtkCssValue *
@@ -858,6 +478,34 @@ gtk_css_animated_style_create_css_animations (GPtrArray        *animations,
 
 /* PUBLIC API */
 
+static GtkCssAnimatedStyle *
+gtk_css_animated_style_alloc (GtkCssStyle *base_style,
+                              gint64       timestamp)
+{
+  GtkCssAnimatedStyle *result;
+  GtkCssStyle *style;
+
+  result = g_object_new (GTK_TYPE_CSS_ANIMATED_STYLE, NULL);
+
+  result->style = g_object_ref (base_style);
+  result->current_time = timestamp;
+
+  style = (GtkCssStyle *)result;
+  style->core = (GtkCssCoreValues *)gtk_css_values_ref ((GtkCssValues *)base_style->core);
+  style->background = (GtkCssBackgroundValues *)gtk_css_values_ref ((GtkCssValues *)base_style->background);
+  style->border = (GtkCssBorderValues *)gtk_css_values_ref ((GtkCssValues *)base_style->border);
+  style->icon = (GtkCssIconValues *)gtk_css_values_ref ((GtkCssValues *)base_style->icon);
+  style->outline = (GtkCssOutlineValues *)gtk_css_values_ref ((GtkCssValues *)base_style->outline);
+  style->font = (GtkCssFontValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font);
+  style->font_variant = (GtkCssFontVariantValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font_variant);
+  style->animation = (GtkCssAnimationValues *)gtk_css_values_ref ((GtkCssValues *)base_style->animation);
+  style->transition = (GtkCssTransitionValues *)gtk_css_values_ref ((GtkCssValues *)base_style->transition);
+  style->size = (GtkCssSizeValues *)gtk_css_values_ref ((GtkCssValues *)base_style->size);
+  style->other = (GtkCssOtherValues *)gtk_css_values_ref ((GtkCssValues *)base_style->other);
+
+  return result;
+}
+
 static void
 gtk_css_animated_style_apply_animations (GtkCssAnimatedStyle *style)
 {
@@ -879,7 +527,6 @@ gtk_css_animated_style_new (GtkCssStyle      *base_style,
                             GtkCssStyle      *previous_style)
 {
   GtkCssAnimatedStyle *result;
-  GtkCssStyle *style;
   GPtrArray *animations = NULL;
 
   gtk_internal_return_val_if_fail (GTK_IS_CSS_STYLE (base_style), NULL);
@@ -899,26 +546,10 @@ gtk_css_animated_style_new (GtkCssStyle      *base_style,
   if (animations == NULL)
     return g_object_ref (base_style);
 
-  result = g_object_new (GTK_TYPE_CSS_ANIMATED_STYLE, NULL);
-
-  result->style = g_object_ref (base_style);
-  result->current_time = timestamp;
+  result = gtk_css_animated_style_alloc (base_style, timestamp);
   result->n_animations = animations->len;
   result->animations = g_ptr_array_free (animations, FALSE);
 
-  style = (GtkCssStyle *)result;
-  style->core = (GtkCssCoreValues *)gtk_css_values_ref ((GtkCssValues *)base_style->core);
-  style->background = (GtkCssBackgroundValues *)gtk_css_values_ref ((GtkCssValues *)base_style->background);
-  style->border = (GtkCssBorderValues *)gtk_css_values_ref ((GtkCssValues *)base_style->border);
-  style->icon = (GtkCssIconValues *)gtk_css_values_ref ((GtkCssValues *)base_style->icon);
-  style->outline = (GtkCssOutlineValues *)gtk_css_values_ref ((GtkCssValues *)base_style->outline);
-  style->font = (GtkCssFontValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font);
-  style->font_variant = (GtkCssFontVariantValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font_variant);
-  style->animation = (GtkCssAnimationValues *)gtk_css_values_ref ((GtkCssValues *)base_style->animation);
-  style->transition = (GtkCssTransitionValues *)gtk_css_values_ref ((GtkCssValues *)base_style->transition);
-  style->size = (GtkCssSizeValues *)gtk_css_values_ref ((GtkCssValues *)base_style->size);
-  style->other = (GtkCssOtherValues *)gtk_css_values_ref ((GtkCssValues *)base_style->other);
-
   gtk_css_animated_style_apply_animations (result);
 
   return GTK_CSS_STYLE (result);
@@ -930,9 +561,7 @@ gtk_css_animated_style_new_advance (GtkCssAnimatedStyle *source,
                                     gint64               timestamp)
 {
   GtkCssAnimatedStyle *result;
-  GtkCssStyle *style;
-  GPtrArray *animations;
-  guint i;
+  guint i, n_animations;
 
   gtk_internal_return_val_if_fail (GTK_IS_CSS_ANIMATED_STYLE (source), NULL);
   gtk_internal_return_val_if_fail (GTK_IS_CSS_STYLE (base_style), NULL);
@@ -942,45 +571,36 @@ gtk_css_animated_style_new_advance (GtkCssAnimatedStyle *source,
 
   gtk_internal_return_val_if_fail (timestamp > source->current_time, NULL);
 
-  animations = NULL;
+  n_animations = 0;
   for (i = 0; i < source->n_animations; i ++)
     {
-      GtkStyleAnimation *animation = source->animations[i];
-
-      if (_gtk_style_animation_is_finished (animation))
-        continue;
-
-      if (!animations)
-        animations = g_ptr_array_sized_new (16);
-
-      animation = _gtk_style_animation_advance (animation, timestamp);
-      g_ptr_array_add (animations, animation);
+      if (!_gtk_style_animation_is_finished (source->animations[i]))
+        n_animations++;
     }
 
-  if (animations == NULL)
+  if (n_animations == 0)
     return g_object_ref (source->style);
 
-  result = g_object_new (GTK_TYPE_CSS_ANIMATED_STYLE, NULL);
+  result = gtk_css_animated_style_alloc (base_style, timestamp);
+  result->animations = g_new (gpointer, n_animations);
 
-  result->style = g_object_ref (base_style);
-  result->current_time = timestamp;
-  result->n_animations = animations->len;
-  result->animations = g_ptr_array_free (animations, FALSE);
+  /* Advance and apply this node's animations in one pass. Every
+   * node still gets a new style per tick, as nodes own their styles.
+   * Only the groups that contain animated values get unshared from
+   * the base style, everything else keeps pointing at the static
+   * values.
+   */
+  for (i = 0; i < source->n_animations; i ++)
+    {
+      GtkStyleAnimation *animation = source->animations[i];
 
-  style = (GtkCssStyle *)result;
-  style->core = (GtkCssCoreValues *)gtk_css_values_ref ((GtkCssValues *)base_style->core);
-  style->background = (GtkCssBackgroundValues *)gtk_css_values_ref ((GtkCssValues *)base_style->background);
-  style->border = (GtkCssBorderValues *)gtk_css_values_ref ((GtkCssValues *)base_style->border);
-  style->icon = (GtkCssIconValues *)gtk_css_values_ref ((GtkCssValues *)base_style->icon);
-  style->outline = (GtkCssOutlineValues *)gtk_css_values_ref ((GtkCssValues *)base_style->outline);
-  style->font = (GtkCssFontValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font);
-  style->font_variant = (GtkCssFontVariantValues *)gtk_css_values_ref ((GtkCssValues *)base_style->font_variant);
-  style->animation = (GtkCssAnimationValues *)gtk_css_values_ref ((GtkCssValues *)base_style->animation);
-  style->transition = (GtkCssTransitionValues *)gtk_css_values_ref ((GtkCssValues *)base_style->transition);
-  style->size = (GtkCssSizeValues *)gtk_css_values_ref ((GtkCssValues *)base_style->size);
-  style->other = (GtkCssOtherValues *)gtk_css_values_ref ((GtkCssValues *)base_style->other);
+      if (_gtk_style_animation_is_finished (animation))
+        continue;
 
-  gtk_css_animated_style_apply_animations (result);
+      animation = _gtk_style_animation_advance (animation, timestamp);
+      result->animations[result->n_animations++] = animation;
+      _gtk_style_animation_apply_values (animation, result);
+    }
 
   return GTK_CSS_STYLE (result);
 }
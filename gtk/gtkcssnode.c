@@ -112,6 +112,7 @@ enum {
   PROP_NAME,
   PROP_STATE,
   PROP_VISIBLE,
+  PROP_N_VALIDATED,
   NUM_PROPERTIES
 };
 
@@ -188,6 +189,10 @@ gtk_css_node_get_property (GObject    *object,
       g_value_set_boolean (value, gtk_css_node_get_visible (cssnode));
       break;
 
+    case PROP_N_VALIDATED:
+      g_value_set_uint (value, gtk_css_node_get_n_validated (cssnode));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
     }
@@ -624,6 +629,11 @@ gtk_css_node_class_init (GtkCssNodeClass *klass)
                           TRUE,
                           G_PARAM_READWRITE
                           | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+  cssnode_properties[PROP_N_VALIDATED] =
+    g_param_spec_uint ("n-validated", NULL, NULL,
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READABLE
+                       | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (object_class, NUM_PROPERTIES, cssnode_properties);
 
@@ -977,6 +987,8 @@ gtk_css_node_do_ensure_style (GtkCssNode                   *cssnode,
 
   gtk_css_node_propagate_pending_changes (cssnode, style_changed);
 
+  if (cssnode->style_is_invalid)
+    cssnode->validated_changes = cssnode->pending_changes;
   cssnode->pending_changes = 0;
   cssnode->style_is_invalid = FALSE;
 }
@@ -1312,6 +1324,17 @@ gtk_css_node_invalidate (GtkCssNode   *cssnode,
   if (change == 0)
     return;
 
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      char *decl = gtk_css_node_declaration_to_string (cssnode->decl);
+      char *reason = gtk_css_change_to_string (change);
+
+      gdk_profiler_add_markf (GDK_PROFILER_CURRENT_TIME, 0, "css invalidation", "%s: %s", decl, reason);
+
+      g_free (reason);
+      g_free (decl);
+    }
+
   cssnode->pending_changes |= change;
 
   if (cssnode->parent)
@@ -1319,16 +1342,24 @@ gtk_css_node_invalidate (GtkCssNode   *cssnode,
   gtk_css_node_invalidate_style (cssnode);
 }
 
-static void
+/* Returns the number of styles that were updated in the subtree */
+static guint
 gtk_css_node_validate_internal (GtkCssNode             *cssnode,
                                 GtkCountingBloomFilter *filter,
-                                gint64                  timestamp)
+                                gint64                  timestamp,
+                                gboolean                parent_updated)
 {
   GtkCssNode *child;
   gboolean bloomed = FALSE;
+  gboolean updated;
+  guint n_validated;
+  gint64 before G_GNUC_UNUSED;
 
   if (!cssnode->invalid)
-    return;
+    return 0;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+  updated = cssnode->style_is_invalid;
 
   gtk_css_node_ensure_style (cssnode, filter, timestamp);
 
@@ -1339,6 +1370,8 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
 
   GTK_CSS_NODE_GET_CLASS (cssnode)->validate (cssnode);
 
+  n_validated = updated ? 1 : 0;
+
   for (child = gtk_css_node_get_first_child (cssnode);
        child;
        child = gtk_css_node_get_next_sibling (child))
@@ -1352,11 +1385,33 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
           bloomed = TRUE;
         }
 
-      gtk_css_node_validate_internal (child, filter, timestamp);
+      n_validated += gtk_css_node_validate_internal (child, filter, timestamp, updated);
     }
 
   if (bloomed)
     gtk_css_node_declaration_remove_bloom_hashes (cssnode->decl, filter);
+
+  if (cssnode->n_validated != n_validated)
+    {
+      cssnode->n_validated = n_validated;
+      g_object_notify_by_pspec (G_OBJECT (cssnode), cssnode_properties[PROP_N_VALIDATED]);
+    }
+
+  /* Report the topmost node of every updated subtree, with the
+   * reason it was updated and how many styles it took with it.
+   */
+  if (GDK_PROFILER_IS_RUNNING && updated && !parent_updated)
+    {
+      char *decl = gtk_css_node_declaration_to_string (cssnode->decl);
+      char *reason = gtk_css_change_to_string (cssnode->validated_changes);
+
+      gdk_profiler_end_markf (before, "css node validation", "%s: %s, %u styles", decl, reason, n_validated);
+
+      g_free (reason);
+      g_free (decl);
+    }
+
+  return n_validated;
 }
 
 void
@@ -1372,7 +1427,7 @@ gtk_css_node_validate (GtkCssNode *cssnode)
 
   timestamp = gtk_css_node_get_timestamp (cssnode);
 
-  gtk_css_node_validate_internal (cssnode, &filter, timestamp);
+  gtk_css_node_validate_internal (cssnode, &filter, timestamp, FALSE);
 
   if (GDK_PROFILER_IS_RUNNING)
     {
@@ -1384,6 +1439,38 @@ gtk_css_node_validate (GtkCssNode *cssnode)
     }
 }
 
+/*
+ * gtk_css_node_get_validated_changes:
+ * @cssnode: a `GtkCssNode`
+ *
+ * Returns the changes that caused the last update of the
+ * style of @cssnode. This is meant for debugging and profiling.
+ *
+ * Returns: the changes handled by the last style update
+ */
+GtkCssChange
+gtk_css_node_get_validated_changes (GtkCssNode *cssnode)
+{
+  return cssnode->validated_changes;
+}
+
+/*
+ * gtk_css_node_get_n_validated:
+ * @cssnode: a `GtkCssNode`
+ *
+ * Returns the number of styles in the subtree of @cssnode,
+ * including @cssnode itself, that were updated the last time
+ * the subtree was validated. This is meant for debugging and
+ * profiling.
+ *
+ * Returns: the number of updated styles
+ */
+guint
+gtk_css_node_get_n_validated (GtkCssNode *cssnode)
+{
+  return cssnode->n_validated;
+}
+
 GtkStyleProvider *
 gtk_css_node_get_style_provider (GtkCssNode *cssnode)
 {
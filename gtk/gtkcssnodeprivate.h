@@ -52,6 +52,8 @@ struct _GtkCssNode
   GtkCssNodeStyleCache  *cache;                 /* cache for children to look up styles */
 
   GtkCssChange           pending_changes;       /* changes that accumulated since the style was last computed */
+  GtkCssChange           validated_changes;     /* changes handled by the last style update, for profiling */
+  guint                  n_validated;           /* styles updated in this subtree by the last validation */
 
   guint                  visible :1;            /* node will be skipped when validating or computing styles */
   guint                  invalid :1;            /* node or a child needs to be validated (even if just for animation) */
@@ -149,6 +151,9 @@ void                    gtk_css_node_invalidate_frame_clock
 void                    gtk_css_node_invalidate         (GtkCssNode            *cssnode,
                                                          GtkCssChange           change);
 void                    gtk_css_node_validate           (GtkCssNode            *cssnode);
+GtkCssChange            gtk_css_node_get_validated_changes
+                                                        (GtkCssNode            *cssnode);
+guint                   gtk_css_node_get_n_validated    (GtkCssNode            *cssnode);
 
 GtkStyleProvider *      gtk_css_node_get_style_provider (GtkCssNode            *cssnode) G_GNUC_PURE;
 
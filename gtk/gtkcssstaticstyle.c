@@ -172,6 +172,11 @@ static const int other_props[] = {
 
 #define GET_VALUES(v) (GtkCssValue **)((guint8*)(v) + sizeof (GtkCssValues))
 
+/* The groups store their values in the same order as the
+ * property lists above.
+ */
+static GtkCssPropertySlot property_slots[GTK_CSS_PROPERTY_N_PROPERTIES];
+
 #define DEFINE_VALUES(ENUM, TYPE, NAME) \
 void \
 gtk_css_## NAME ## _values_compute_changes_and_affects (GtkCssStyle *style1, \
@@ -216,6 +221,8 @@ gtk_css_ ## NAME ## _values_new_compute (GtkCssStaticStyle *sstyle, \
                                           lookup->values[id].value, \
                                           lookup->values[id].section); \
     } \
+\
+  style->NAME = (GtkCss ## TYPE ## Values *)gtk_css_values_intern ((GtkCssValues *)style->NAME); \
 } \
 static GtkBitmask * gtk_css_ ## NAME ## _values_mask; \
 static GtkCssValues * gtk_css_ ## NAME ## _initial_values; \
@@ -231,6 +238,8 @@ gtk_css_ ## NAME ## _values_init (void) \
     { \
       guint id = NAME ## _props[i]; \
       gtk_css_ ## NAME ## _values_mask = _gtk_bitmask_set (gtk_css_ ## NAME ## _values_mask, id, TRUE); \
+      property_slots[id].offset = G_STRUCT_OFFSET (GtkCssStyle, NAME); \
+      property_slots[id].index = i; \
     } \
 \
   gtk_css_ ## NAME ## _initial_values = gtk_css_ ## NAME ## _create_initial_values (); \
@@ -379,6 +388,19 @@ gtk_css_take_value (GtkCssValue **variable,
   *variable = value;
 }
 
+static inline GtkCssValue **
+gtk_css_static_style_get_slot (GtkCssStyle *style,
+                               guint        id)
+{
+  GtkCssValues *values;
+  GtkCssValue **v;
+
+  values = G_STRUCT_MEMBER (GtkCssValues *, style, property_slots[id].offset);
+  v = GET_VALUES (values);
+
+  return &v[property_slots[id].index];
+}
+
 static void
 gtk_css_static_style_set_value (GtkCssStaticStyle *sstyle,
                                 guint              id,
@@ -387,289 +409,7 @@ gtk_css_static_style_set_value (GtkCssStaticStyle *sstyle,
 {
   GtkCssStyle *style = (GtkCssStyle *)sstyle;
 
-  switch (id)
-    {
-    case GTK_CSS_PROPERTY_COLOR:
-      gtk_css_take_value (&style->core->color, value);
-      break;
-    case GTK_CSS_PROPERTY_DPI:
-      gtk_css_take_value (&style->core->dpi, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_SIZE:
-      gtk_css_take_value (&style->core->font_size, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_PALETTE:
-      gtk_css_take_value (&style->core->icon_palette, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_COLOR:
-      gtk_css_take_value (&style->background->background_color, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_FAMILY:
-      gtk_css_take_value (&style->font->font_family, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_STYLE:
-      gtk_css_take_value (&style->font->font_style, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_WEIGHT:
-      gtk_css_take_value (&style->font->font_weight, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_STRETCH:
-      gtk_css_take_value (&style->font->font_stretch, value);
-      break;
-    case GTK_CSS_PROPERTY_LETTER_SPACING:
-      gtk_css_take_value (&style->font->letter_spacing, value);
-      break;
-    case GTK_CSS_PROPERTY_LINE_HEIGHT:
-      gtk_css_take_value (&style->font->line_height, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_LINE:
-      gtk_css_take_value (&style->font_variant->text_decoration_line, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_COLOR:
-      gtk_css_take_value (&style->font_variant->text_decoration_color, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_DECORATION_STYLE:
-      gtk_css_take_value (&style->font_variant->text_decoration_style, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_TRANSFORM:
-      gtk_css_take_value (&style->font_variant->text_transform, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_KERNING:
-      gtk_css_take_value (&style->font_variant->font_kerning, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_LIGATURES:
-      gtk_css_take_value (&style->font_variant->font_variant_ligatures, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_POSITION:
-      gtk_css_take_value (&style->font_variant->font_variant_position, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_CAPS:
-      gtk_css_take_value (&style->font_variant->font_variant_caps, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_NUMERIC:
-      gtk_css_take_value (&style->font_variant->font_variant_numeric, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_ALTERNATES:
-      gtk_css_take_value (&style->font_variant->font_variant_alternates, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIANT_EAST_ASIAN:
-      gtk_css_take_value (&style->font_variant->font_variant_east_asian, value);
-      break;
-    case GTK_CSS_PROPERTY_TEXT_SHADOW:
-      gtk_css_take_value (&style->font->text_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_BOX_SHADOW:
-      gtk_css_take_value (&style->background->box_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_TOP:
-      gtk_css_take_value (&style->size->margin_top, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_LEFT:
-      gtk_css_take_value (&style->size->margin_left, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_BOTTOM:
-      gtk_css_take_value (&style->size->margin_bottom, value);
-      break;
-    case GTK_CSS_PROPERTY_MARGIN_RIGHT:
-      gtk_css_take_value (&style->size->margin_right, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_TOP:
-      gtk_css_take_value (&style->size->padding_top, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_LEFT:
-      gtk_css_take_value (&style->size->padding_left, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_BOTTOM:
-      gtk_css_take_value (&style->size->padding_bottom, value);
-      break;
-    case GTK_CSS_PROPERTY_PADDING_RIGHT:
-      gtk_css_take_value (&style->size->padding_right, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_STYLE:
-      gtk_css_take_value (&style->border->border_top_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_WIDTH:
-      gtk_css_take_value (&style->border->border_top_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_STYLE:
-      gtk_css_take_value (&style->border->border_left_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_WIDTH:
-      gtk_css_take_value (&style->border->border_left_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_STYLE:
-      gtk_css_take_value (&style->border->border_bottom_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_WIDTH:
-      gtk_css_take_value (&style->border->border_bottom_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_STYLE:
-      gtk_css_take_value (&style->border->border_right_style, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_WIDTH:
-      gtk_css_take_value (&style->border->border_right_width, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_LEFT_RADIUS:
-      gtk_css_take_value (&style->border->border_top_left_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_RIGHT_RADIUS:
-      gtk_css_take_value (&style->border->border_top_right_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_RIGHT_RADIUS:
-      gtk_css_take_value (&style->border->border_bottom_right_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_LEFT_RADIUS:
-      gtk_css_take_value (&style->border->border_bottom_left_radius, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_STYLE:
-      gtk_css_take_value (&style->outline->outline_style, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_WIDTH:
-      gtk_css_take_value (&style->outline->outline_width, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_OFFSET:
-      gtk_css_take_value (&style->outline->outline_offset, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_CLIP:
-      gtk_css_take_value (&style->background->background_clip, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_ORIGIN:
-      gtk_css_take_value (&style->background->background_origin, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_SIZE:
-      gtk_css_take_value (&style->background->background_size, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_POSITION:
-      gtk_css_take_value (&style->background->background_position, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_TOP_COLOR:
-      gtk_css_take_value (&style->border->border_top_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_RIGHT_COLOR:
-      gtk_css_take_value (&style->border->border_right_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_BOTTOM_COLOR:
-      gtk_css_take_value (&style->border->border_bottom_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_LEFT_COLOR:
-      gtk_css_take_value (&style->border->border_left_color, value);
-      break;
-    case GTK_CSS_PROPERTY_OUTLINE_COLOR:
-      gtk_css_take_value (&style->outline->outline_color, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_REPEAT:
-      gtk_css_take_value (&style->background->background_repeat, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_IMAGE:
-      gtk_css_take_value (&style->background->background_image, value);
-      break;
-    case GTK_CSS_PROPERTY_BACKGROUND_BLEND_MODE:
-      gtk_css_take_value (&style->background->background_blend_mode, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_SOURCE:
-      gtk_css_take_value (&style->border->border_image_source, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_REPEAT:
-      gtk_css_take_value (&style->border->border_image_repeat, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_SLICE:
-      gtk_css_take_value (&style->border->border_image_slice, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_IMAGE_WIDTH:
-      gtk_css_take_value (&style->border->border_image_width, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SOURCE:
-      gtk_css_take_value (&style->other->icon_source, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SIZE:
-      gtk_css_take_value (&style->icon->icon_size, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_SHADOW:
-      gtk_css_take_value (&style->icon->icon_shadow, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_STYLE:
-      gtk_css_take_value (&style->icon->icon_style, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_TRANSFORM:
-      gtk_css_take_value (&style->other->icon_transform, value);
-      break;
-    case GTK_CSS_PROPERTY_ICON_FILTER:
-      gtk_css_take_value (&style->other->icon_filter, value);
-      break;
-    case GTK_CSS_PROPERTY_BORDER_SPACING:
-      gtk_css_take_value (&style->size->border_spacing, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSFORM:
-      gtk_css_take_value (&style->other->transform, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSFORM_ORIGIN:
-      gtk_css_take_value (&style->other->transform_origin, value);
-      break;
-    case GTK_CSS_PROPERTY_MIN_WIDTH:
-      gtk_css_take_value (&style->size->min_width, value);
-      break;
-    case GTK_CSS_PROPERTY_MIN_HEIGHT:
-      gtk_css_take_value (&style->size->min_height, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_PROPERTY:
-      gtk_css_take_value (&style->transition->transition_property, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_DURATION:
-      gtk_css_take_value (&style->transition->transition_duration, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_TIMING_FUNCTION:
-      gtk_css_take_value (&style->transition->transition_timing_function, value);
-      break;
-    case GTK_CSS_PROPERTY_TRANSITION_DELAY:
-      gtk_css_take_value (&style->transition->transition_delay, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_NAME:
-      gtk_css_take_value (&style->animation->animation_name, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DURATION:
-      gtk_css_take_value (&style->animation->animation_duration, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_TIMING_FUNCTION:
-      gtk_css_take_value (&style->animation->animation_timing_function, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_ITERATION_COUNT:
-      gtk_css_take_value (&style->animation->animation_iteration_count, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DIRECTION:
-      gtk_css_take_value (&style->animation->animation_direction, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_PLAY_STATE:
-      gtk_css_take_value (&style->animation->animation_play_state, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_DELAY:
-      gtk_css_take_value (&style->animation->animation_delay, value);
-      break;
-    case GTK_CSS_PROPERTY_ANIMATION_FILL_MODE:
-      gtk_css_take_value (&style->animation->animation_fill_mode, value);
-      break;
-    case GTK_CSS_PROPERTY_OPACITY:
-      gtk_css_take_value (&style->other->opacity, value);
-      break;
-    case GTK_CSS_PROPERTY_FILTER:
-      gtk_css_take_value (&style->other->filter, value);
-      break;
-    case GTK_CSS_PROPERTY_CARET_COLOR:
-      gtk_css_take_value (&style->font->caret_color, value);
-      break;
-    case GTK_CSS_PROPERTY_SECONDARY_CARET_COLOR:
-      gtk_css_take_value (&style->font->secondary_caret_color, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_FEATURE_SETTINGS:
-      gtk_css_take_value (&style->font->font_feature_settings, value);
-      break;
-    case GTK_CSS_PROPERTY_FONT_VARIATION_SETTINGS:
-      gtk_css_take_value (&style->font->font_variation_settings, value);
-      break;
-
-    default:
-      g_assert_not_reached ();
-      break;
-    }
+  gtk_css_take_value (gtk_css_static_style_get_slot (style, id), value);
 
   if (sstyle->sections && sstyle->sections->len > id && g_ptr_array_index (sstyle->sections, id))
     {
@@ -1101,6 +841,23 @@ gtk_css_static_style_compute_value (GtkCssStaticStyle *style,
   gtk_css_static_style_set_value (style, id, value, section);
 }
 
+/*
+ * gtk_css_static_style_get_property_slot:
+ * @id: the id of a style property
+ *
+ * Returns where the computed value for @id is stored in a
+ * GtkCssStyle.
+ *
+ * Returns: the slot for @id
+ */
+const GtkCssPropertySlot *
+gtk_css_static_style_get_property_slot (guint id)
+{
+  gtk_internal_return_val_if_fail (id < GTK_CSS_PROPERTY_N_PROPERTIES, NULL);
+
+  return &property_slots[id];
+}
+
 GtkCssChange
 gtk_css_static_style_get_change (GtkCssStaticStyle *style)
 {
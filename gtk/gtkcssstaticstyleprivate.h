@@ -34,6 +34,7 @@ G_BEGIN_DECLS
 #define GTK_CSS_STATIC_STYLE_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_CSS_STATIC_STYLE, GtkCssStaticStyleClass))
 
 typedef struct _GtkCssStaticStyleClass      GtkCssStaticStyleClass;
+typedef struct _GtkCssPropertySlot          GtkCssPropertySlot;
 
 
 struct _GtkCssStaticStyle
@@ -50,6 +51,12 @@ struct _GtkCssStaticStyleClass
   GtkCssStyleClass parent_class;
 };
 
+struct _GtkCssPropertySlot
+{
+  guint16                offset;               /* offset of the values group in GtkCssStyle */
+  guint16                index;                /* index of the value inside the group */
+};
+
 GType                   gtk_css_static_style_get_type           (void) G_GNUC_CONST;
 
 GtkCssStyle *           gtk_css_static_style_get_default        (void);
@@ -59,6 +66,9 @@ GtkCssStyle *           gtk_css_static_style_new_compute        (GtkStyleProvide
                                                                  GtkCssChange                    change);
 GtkCssChange            gtk_css_static_style_get_change         (GtkCssStaticStyle              *style);
 
+const GtkCssPropertySlot *
+                        gtk_css_static_style_get_property_slot  (guint                           id);
+
 G_END_DECLS
 
 #endif /* __GTK_CSS_STATIC_STYLE_PRIVATE_H__ */
@@ -19,6 +19,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "gtkprivate.h"
 #include "gtkcssstyleprivate.h"
 
@@ -73,6 +75,9 @@ gtk_css_style_finalize (GObject *object)
   gtk_css_values_unref ((GtkCssValues *)style->size);
   gtk_css_values_unref ((GtkCssValues *)style->other);
 
+  g_clear_pointer (&style->pango_attrs, pango_attr_list_unref);
+  g_clear_pointer (&style->pango_font, pango_font_description_free);
+
   G_OBJECT_CLASS (gtk_css_style_parent_class)->finalize (object);
 }
 
@@ -588,8 +593,8 @@ gtk_css_style_compute_font_features (GtkCssStyle *style)
     return NULL;
 }
 
-PangoAttrList *
-gtk_css_style_get_pango_attributes (GtkCssStyle *style)
+static PangoAttrList *
+gtk_css_style_compute_pango_attributes (GtkCssStyle *style)
 {
   PangoAttrList *attrs = NULL;
   GtkTextDecorationLine decoration_line;
@@ -698,8 +703,8 @@ gtk_css_style_get_pango_attributes (GtkCssStyle *style)
   return attrs;
 }
 
-PangoFontDescription *
-gtk_css_style_get_pango_font (GtkCssStyle *style)
+static PangoFontDescription *
+gtk_css_style_compute_pango_font (GtkCssStyle *style)
 {
   PangoFontDescription *description;
   GtkCssValue *v;
@@ -750,6 +755,51 @@ gtk_css_style_get_pango_font (GtkCssStyle *style)
   return description;
 }
 
+/*
+ * gtk_css_style_get_pango_attributes:
+ * @style: a `GtkCssStyle`
+ *
+ * Gets the Pango attributes corresponding to the text properties
+ * of @style.
+ *
+ * The list is computed once and cached on the style, so it must
+ * not be modified. Use pango_attr_list_copy() to get a list that
+ * can be changed.
+ *
+ * Returns: (transfer none) (nullable): the attributes
+ */
+PangoAttrList *
+gtk_css_style_get_pango_attributes (GtkCssStyle *style)
+{
+  if (!style->pango_attrs_valid)
+    {
+      style->pango_attrs = gtk_css_style_compute_pango_attributes (style);
+      style->pango_attrs_valid = TRUE;
+    }
+
+  return style->pango_attrs;
+}
+
+/*
+ * gtk_css_style_get_pango_font:
+ * @style: a `GtkCssStyle`
+ *
+ * Gets the font description corresponding to the font properties
+ * of @style.
+ *
+ * The description is computed once and cached on the style.
+ *
+ * Returns: (transfer none): the font description
+ */
+const PangoFontDescription *
+gtk_css_style_get_pango_font (GtkCssStyle *style)
+{
+  if (style->pango_font == NULL)
+    style->pango_font = gtk_css_style_compute_pango_font (style);
+
+  return style->pango_font;
+}
+
 /* Refcounted value structs */
 
 static const int values_size[] = {
@@ -779,12 +829,49 @@ GtkCssValues *gtk_css_values_ref (GtkCssValues *values)
   return values;
 }
 
+/* Groups of computed values are interned, so that styles with
+ * identical groups share a single copy.
+ */
+static GHashTable *interned_values;
+
+static guint
+gtk_css_values_hash (gconstpointer data)
+{
+  GtkCssValues *values = (GtkCssValues *) data;
+  GtkCssValue **v = GET_VALUES (values);
+  guint hash = values->type;
+  int i;
+
+  for (i = 0; i < N_VALUES (values->type); i++)
+    hash = (hash << 5) - hash + g_direct_hash (v[i]);
+
+  return hash;
+}
+
+static gboolean
+gtk_css_values_equal (gconstpointer data1,
+                      gconstpointer data2)
+{
+  GtkCssValues *values1 = (GtkCssValues *) data1;
+  GtkCssValues *values2 = (GtkCssValues *) data2;
+
+  if (values1->type != values2->type)
+    return FALSE;
+
+  return memcmp (GET_VALUES (values1),
+                 GET_VALUES (values2),
+                 N_VALUES (values1->type) * sizeof (GtkCssValue *)) == 0;
+}
+
 static void
 gtk_css_values_free (GtkCssValues *values)
 {
   int i;
   GtkCssValue **v = GET_VALUES (values);
 
+  if (interned_values && g_hash_table_lookup (interned_values, values) == values)
+    g_hash_table_remove (interned_values, values);
+
   for (i = 0; i < N_VALUES (values->type); i++)
     {
       if (v[i])
@@ -805,6 +892,39 @@ void gtk_css_values_unref (GtkCssValues *values)
     gtk_css_values_free (values);
 }
 
+/*
+ * gtk_css_values_intern:
+ * @values: (transfer full): a fully computed values group
+ *
+ * Looks for an existing group holding the same values as @values
+ * and returns it instead, dropping @values. If there is none,
+ * @values becomes the shared instance.
+ *
+ * Interned groups must not be modified anymore, use
+ * gtk_css_values_copy() to get a private copy.
+ *
+ * Returns: (transfer full): the shared values group
+ */
+GtkCssValues *
+gtk_css_values_intern (GtkCssValues *values)
+{
+  GtkCssValues *interned;
+
+  if (G_UNLIKELY (interned_values == NULL))
+    interned_values = g_hash_table_new (gtk_css_values_hash, gtk_css_values_equal);
+
+  interned = g_hash_table_lookup (interned_values, values);
+  if (interned)
+    {
+      gtk_css_values_unref (values);
+      return gtk_css_values_ref (interned);
+    }
+
+  g_hash_table_add (interned_values, values);
+
+  return values;
+}
+
 GtkCssValues *
 gtk_css_values_copy (GtkCssValues *values)
 {
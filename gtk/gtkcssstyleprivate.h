@@ -233,6 +233,11 @@ struct _GtkCssStyle
   GtkCssTransitionValues  *transition;
   GtkCssSizeValues        *size;
   GtkCssOtherValues       *other;
+
+  /* Derived Pango objects, computed on demand */
+  PangoFontDescription    *pango_font;
+  PangoAttrList           *pango_attrs;
+  guint                    pango_attrs_valid : 1;
 };
 
 struct _GtkCssStyleClass
@@ -267,12 +272,14 @@ gboolean                gtk_css_style_print                     (GtkCssStyle
 PangoTextTransform      gtk_css_style_get_pango_text_transform  (GtkCssStyle            *style);
 char *                  gtk_css_style_compute_font_features     (GtkCssStyle            *style);
 PangoAttrList *         gtk_css_style_get_pango_attributes      (GtkCssStyle            *style);
-PangoFontDescription *  gtk_css_style_get_pango_font            (GtkCssStyle            *style);
-
-GtkCssValues *gtk_css_values_new   (GtkCssValuesType  type);
-GtkCssValues *gtk_css_values_ref   (GtkCssValues     *values);
-void          gtk_css_values_unref (GtkCssValues     *values);
-GtkCssValues *gtk_css_values_copy  (GtkCssValues     *values);
+const PangoFontDescription *
+                        gtk_css_style_get_pango_font            (GtkCssStyle            *style);
+
+GtkCssValues *gtk_css_values_new    (GtkCssValuesType  type);
+GtkCssValues *gtk_css_values_ref    (GtkCssValues     *values);
+void          gtk_css_values_unref  (GtkCssValues     *values);
+GtkCssValues *gtk_css_values_copy   (GtkCssValues     *values);
+GtkCssValues *gtk_css_values_intern (GtkCssValues     *values);
 
 void gtk_css_core_values_compute_changes_and_affects (GtkCssStyle *style1,
                                                       GtkCssStyle *style2,
@@ -17,7 +17,7 @@
 
 #include "config.h"
 
-#include "gtkentrybuffer.h"
+#include "gtkentrybufferprivate.h"
 #include "gtkintl.h"
 #include "gtkmarshalers.h"
 #include "gtkprivate.h"
@@ -45,6 +45,9 @@
 /* Initial size of buffer, in bytes */
 #define MIN_SIZE 16
 
+/* Characters between two entries of the offset index */
+#define INDEX_STRIDE 256
+
 enum {
   PROP_0,
   PROP_TEXT,
@@ -72,6 +75,12 @@ struct _GtkEntryBufferPrivate
   gsize  normal_text_bytes;
   guint  normal_text_chars;
 
+  /* Byte offsets of every INDEX_STRIDE'th character of normal_text.
+   * Only a prefix is valid, it is extended lazily and cut back to
+   * the position of each change.
+   */
+  GArray *offset_index;
+
   int    max_length;
 };
 
@@ -95,6 +104,85 @@ trash_area (char *area,
     *varea++ = 0;
 }
 
+static void
+gtk_entry_buffer_extend_index (GtkEntryBufferPrivate *pv,
+                               guint                  n_entries)
+{
+  GArray *index = pv->offset_index;
+
+  while (index->len < n_entries &&
+         index->len * INDEX_STRIDE <= pv->normal_text_chars)
+    {
+      gsize last = g_array_index (index, gsize, index->len - 1);
+      gsize next;
+
+      next = g_utf8_offset_to_pointer (pv->normal_text + last, INDEX_STRIDE) - pv->normal_text;
+      g_array_append_val (index, next);
+    }
+}
+
+static void
+gtk_entry_buffer_invalidate_index (GtkEntryBufferPrivate *pv,
+                                   guint                  position)
+{
+  /* Entries up to @position are not affected by changes there */
+  if (pv->offset_index->len > position / INDEX_STRIDE + 1)
+    g_array_set_size (pv->offset_index, position / INDEX_STRIDE + 1);
+}
+
+static gsize
+gtk_entry_buffer_normal_get_byte_offset (GtkEntryBufferPrivate *pv,
+                                         guint                  position)
+{
+  guint i;
+  gsize offset;
+
+  if (pv->normal_text == NULL)
+    return 0;
+
+  position = MIN (position, pv->normal_text_chars);
+  i = position / INDEX_STRIDE;
+
+  gtk_entry_buffer_extend_index (pv, i + 1);
+  offset = g_array_index (pv->offset_index, gsize, i);
+
+  return g_utf8_offset_to_pointer (pv->normal_text + offset, position - i * INDEX_STRIDE) - pv->normal_text;
+}
+
+static guint
+gtk_entry_buffer_normal_get_char_offset (GtkEntryBufferPrivate *pv,
+                                         gsize                  byte_offset)
+{
+  GArray *index = pv->offset_index;
+  guint lo, hi;
+
+  if (pv->normal_text == NULL)
+    return 0;
+
+  byte_offset = MIN (byte_offset, pv->normal_text_bytes);
+
+  while (g_array_index (index, gsize, index->len - 1) < byte_offset &&
+         index->len * INDEX_STRIDE <= pv->normal_text_chars)
+    gtk_entry_buffer_extend_index (pv, index->len + 1);
+
+  /* Find the last entry before @byte_offset */
+  lo = 0;
+  hi = index->len;
+  while (hi - lo > 1)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (index, gsize, mid) <= byte_offset)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  return lo * INDEX_STRIDE +
+         g_utf8_pointer_to_offset (pv->normal_text + g_array_index (index, gsize, lo),
+                                   pv->normal_text + byte_offset);
+}
+
 static const char *
 gtk_entry_buffer_normal_get_text (GtkEntryBuffer *buffer,
                                   gsize          *n_bytes)
@@ -170,7 +258,8 @@ gtk_entry_buffer_normal_insert_text (GtkEntryBuffer *buffer,
     }
 
   /* Actual text insertion */
-  at = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
+  at = gtk_entry_buffer_normal_get_byte_offset (pv, position);
+  gtk_entry_buffer_invalidate_index (pv, position);
   memmove (pv->normal_text + at + n_bytes, pv->normal_text + at, pv->normal_text_bytes - at);
   memcpy (pv->normal_text + at, chars, n_bytes);
 
@@ -223,8 +312,9 @@ gtk_entry_buffer_real_deleted_text (GtkEntryBuffer *buffer,
   GtkEntryBufferPrivate *pv = gtk_entry_buffer_get_instance_private (buffer);
   gsize start, end;
 
-  start = g_utf8_offset_to_pointer (pv->normal_text, position) - pv->normal_text;
-  end = g_utf8_offset_to_pointer (pv->normal_text, position + n_chars) - pv->normal_text;
+  start = gtk_entry_buffer_normal_get_byte_offset (pv, position);
+  end = gtk_entry_buffer_normal_get_byte_offset (pv, position + n_chars);
+  gtk_entry_buffer_invalidate_index (pv, position);
 
   memmove (pv->normal_text + start, pv->normal_text + end, pv->normal_text_bytes + 1 - end);
   pv->normal_text_chars -= n_chars;
@@ -254,6 +344,8 @@ gtk_entry_buffer_init (GtkEntryBuffer *buffer)
   pv->normal_text_chars = 0;
   pv->normal_text_bytes = 0;
   pv->normal_text_size = 0;
+  pv->offset_index = g_array_sized_new (FALSE, FALSE, sizeof (gsize), 1);
+  g_array_append_val (pv->offset_index, pv->normal_text_bytes);
 }
 
 static void
@@ -271,6 +363,8 @@ gtk_entry_buffer_finalize (GObject *obj)
       pv->normal_text_chars = 0;
     }
 
+  g_array_unref (pv->offset_index);
+
   G_OBJECT_CLASS (gtk_entry_buffer_parent_class)->finalize (obj);
 }
 
@@ -725,3 +819,63 @@ gtk_entry_buffer_emit_deleted_text (GtkEntryBuffer *buffer,
   g_return_if_fail (GTK_IS_ENTRY_BUFFER (buffer));
   g_signal_emit (buffer, signals[DELETED_TEXT], 0, position, n_chars);
 }
+
+/*
+ * gtk_entry_buffer_get_byte_offset:
+ * @buffer: a `GtkEntryBuffer`
+ * @position: a character offset
+ *
+ * Converts @position into a byte offset into the text returned
+ * by gtk_entry_buffer_get_text(). Unless the buffer is derived
+ * from, this does not need to walk the whole text.
+ *
+ * Returns: the byte offset
+ */
+gsize
+gtk_entry_buffer_get_byte_offset (GtkEntryBuffer *buffer,
+                                  guint           position)
+{
+  GtkEntryBufferClass *klass;
+  const char *text;
+
+  g_return_val_if_fail (GTK_IS_ENTRY_BUFFER (buffer), 0);
+
+  klass = GTK_ENTRY_BUFFER_GET_CLASS (buffer);
+
+  if (klass->get_text == gtk_entry_buffer_normal_get_text)
+    return gtk_entry_buffer_normal_get_byte_offset (gtk_entry_buffer_get_instance_private (buffer), position);
+
+  text = gtk_entry_buffer_get_text (buffer);
+  position = MIN (position, gtk_entry_buffer_get_length (buffer));
+
+  return g_utf8_offset_to_pointer (text, position) - text;
+}
+
+/*
+ * gtk_entry_buffer_get_char_offset:
+ * @buffer: a `GtkEntryBuffer`
+ * @byte_offset: a byte offset into the text of @buffer
+ *
+ * The inverse of gtk_entry_buffer_get_byte_offset().
+ *
+ * Returns: the character offset
+ */
+guint
+gtk_entry_buffer_get_char_offset (GtkEntryBuffer *buffer,
+                                  gsize           byte_offset)
+{
+  GtkEntryBufferClass *klass;
+  const char *text;
+  gsize n_bytes;
+
+  g_return_val_if_fail (GTK_IS_ENTRY_BUFFER (buffer), 0);
+
+  klass = GTK_ENTRY_BUFFER_GET_CLASS (buffer);
+
+  if (klass->get_text == gtk_entry_buffer_normal_get_text)
+    return gtk_entry_buffer_normal_get_char_offset (gtk_entry_buffer_get_instance_private (buffer), byte_offset);
+
+  text = (*klass->get_text) (buffer, &n_bytes);
+
+  return g_utf8_pointer_to_offset (text, text + MIN (byte_offset, n_bytes));
+}
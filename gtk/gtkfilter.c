@@ -19,7 +19,7 @@
 
 #include "config.h"
 
-#include "gtkfilter.h"
+#include "gtkfilterprivate.h"
 
 #include "gtkintl.h"
 #include "gtktypebuiltins.h"
@@ -52,7 +52,17 @@ enum {
   LAST_SIGNAL
 };
 
-G_DEFINE_TYPE (GtkFilter, gtk_filter, G_TYPE_OBJECT)
+typedef struct _GtkFilterPrivate GtkFilterPrivate;
+struct _GtkFilterPrivate
+{
+  GtkFilterPrepareFunc prepare_func;
+  GtkFilterMatchPreparedFunc match_prepared_func;
+  GDestroyNotify free_prepared_func;
+  char *refinement_key;
+  gboolean refinement_key_set; /* set since the last ::changed emission */
+};
+
+G_DEFINE_TYPE_WITH_PRIVATE (GtkFilter, gtk_filter, G_TYPE_OBJECT)
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
@@ -71,11 +81,24 @@ gtk_filter_default_get_strictness (GtkFilter *self)
   return GTK_FILTER_MATCH_SOME;
 }
 
+static void
+gtk_filter_finalize (GObject *object)
+{
+  GtkFilter *self = GTK_FILTER (object);
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  g_free (priv->refinement_key);
+
+  G_OBJECT_CLASS (gtk_filter_parent_class)->finalize (object);
+}
+
 static void
 gtk_filter_class_init (GtkFilterClass *class)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (class);
 
+  gobject_class->finalize = gtk_filter_finalize;
+
   class->match = gtk_filter_default_match;
   class->get_strictness = gtk_filter_default_get_strictness;
 
@@ -134,6 +157,163 @@ gtk_filter_match (GtkFilter *self,
   return GTK_FILTER_GET_CLASS (self)->match (self, item);
 }
 
+/*<private>
+ * gtk_filter_set_prepare_funcs:
+ * @self: a `GtkFilter`
+ * @prepare_func: function to prepare an item for matching
+ * @match_prepared_func: function to match prepared data
+ * @free_func: function to free prepared data
+ *
+ * Filter implementations call this to split matching into two steps,
+ * so that users like `GtkFilterListModel` can keep the prepared data
+ * of their items and match it on multiple threads.
+ *
+ * @prepare_func is called on the thread owning the items and may
+ * run application code, like evaluating expressions. It is passed
+ * the data prepared for the item last time, if any, so it can reuse
+ * it when nothing changed.
+ *
+ * @match_prepared_func must give the same result as
+ * gtk_filter_match() on the item, without touching the item. It
+ * may be called from multiple threads at the same time, as long
+ * as the filter does not change.
+ */
+void
+gtk_filter_set_prepare_funcs (GtkFilter                  *self,
+                              GtkFilterPrepareFunc        prepare_func,
+                              GtkFilterMatchPreparedFunc  match_prepared_func,
+                              GDestroyNotify              free_func)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  priv->prepare_func = prepare_func;
+  priv->match_prepared_func = match_prepared_func;
+  priv->free_prepared_func = free_func;
+}
+
+/*<private>
+ * gtk_filter_can_prepare:
+ * @self: a `GtkFilter`
+ *
+ * Checks if @self supports gtk_filter_prepare() and
+ * gtk_filter_match_prepared().
+ *
+ * Returns: %TRUE if items can be prepared for matching
+ */
+gboolean
+gtk_filter_can_prepare (GtkFilter *self)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  return priv->prepare_func != NULL;
+}
+
+/*<private>
+ * gtk_filter_prepare:
+ * @self: a `GtkFilter`
+ * @item: (type GObject) (transfer none): the item to prepare
+ * @prepared: (transfer full) (nullable): the data previously prepared
+ *   for @item or %NULL
+ *
+ * Prepares @item for gtk_filter_match_prepared().
+ *
+ * Returns: (transfer full): the prepared data
+ */
+gpointer
+gtk_filter_prepare (GtkFilter *self,
+                    gpointer   item,
+                    gpointer   prepared)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  return priv->prepare_func (self, item, prepared);
+}
+
+/*<private>
+ * gtk_filter_match_prepared:
+ * @self: a `GtkFilter`
+ * @prepared: data returned by gtk_filter_prepare()
+ *
+ * Checks if the item @prepared was prepared from matches @self.
+ *
+ * This function may be called from any thread.
+ *
+ * Returns: %TRUE if the item matches
+ */
+gboolean
+gtk_filter_match_prepared (GtkFilter     *self,
+                           gconstpointer  prepared)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  return priv->match_prepared_func (self, prepared);
+}
+
+/*<private>
+ * gtk_filter_free_prepared:
+ * @self: a `GtkFilter`
+ * @prepared: (transfer full): data returned by gtk_filter_prepare()
+ *
+ * Frees data prepared by @self.
+ */
+void
+gtk_filter_free_prepared (GtkFilter *self,
+                          gpointer   prepared)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  priv->free_prepared_func (prepared);
+}
+
+/*<private>
+ * gtk_filter_get_refinement_key:
+ * @self: a `GtkFilter`
+ *
+ * Gets a key describing the current state of the filter.
+ *
+ * Two states with the same key match the same items. If the key of
+ * one state is a prefix of the key of another state, the second state
+ * is at least as strict as the first, so it only matches items that
+ * the first state matched, too.
+ *
+ * This allows users of the filter to reuse the results of previous
+ * states, for example when a search term gets shortened again.
+ *
+ * Returns: (nullable): the key or %NULL if the filter can't describe
+ *   its state
+ */
+const char *
+gtk_filter_get_refinement_key (GtkFilter *self)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  return priv->refinement_key;
+}
+
+/*<private>
+ * gtk_filter_set_refinement_key:
+ * @self: a `GtkFilter`
+ * @key: (nullable): the new key
+ *
+ * Filter implementations call this before emitting
+ * [signal@Gtk.Filter::changed] to describe their new state.
+ * See gtk_filter_get_refinement_key() for the rules the key
+ * must follow.
+ *
+ * If the signal is emitted without setting a key first, for
+ * example because the items changed, the key is unset.
+ */
+void
+gtk_filter_set_refinement_key (GtkFilter  *self,
+                               const char *key)
+{
+  GtkFilterPrivate *priv = gtk_filter_get_instance_private (self);
+
+  g_free (priv->refinement_key);
+  priv->refinement_key = g_strdup (key);
+  priv->refinement_key_set = TRUE;
+}
+
 /**
  * gtk_filter_get_strictness:
  * @self: a `GtkFilter`
@@ -180,8 +360,17 @@ void
 gtk_filter_changed (GtkFilter       *self,
                     GtkFilterChange  change)
 {
+  GtkFilterPrivate *priv;
+
   g_return_if_fail (GTK_IS_FILTER (self));
 
+  priv = gtk_filter_get_instance_private (self);
+
+  /* Changes the filter did not describe invalidate the key */
+  if (!priv->refinement_key_set)
+    g_clear_pointer (&priv->refinement_key, g_free);
+  priv->refinement_key_set = FALSE;
+
   g_signal_emit (self, signals[CHANGED], 0, change);
 }
 
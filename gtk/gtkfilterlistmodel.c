@@ -22,9 +22,25 @@
 #include "gtkfilterlistmodel.h"
 
 #include "gtkbitset.h"
+#include "gtkfilterprivate.h"
 #include "gtkintl.h"
 #include "gtkprivate.h"
 
+/* Minimum number of items before we use multiple threads when
+ * filtering everything in one go
+ *
+ * Below this, starting the threads costs more than it saves.
+ */
+#define GTK_FILTER_PARALLEL_MIN_ITEMS (16 * 1024)
+
+/* Maximum number of threads used for filtering */
+#define GTK_FILTER_MAX_THREADS (8)
+
+/* Maximum number of previous filter states we keep around to
+ * restore when the filter goes back to them
+ */
+#define GTK_FILTER_MAX_REFINEMENTS (8)
+
 /**
  * GtkFilterListModel:
  *
@@ -62,6 +78,20 @@ struct _GtkFilterListModel
   GtkBitset *matches; /* NULL if strictness != GTK_FILTER_MATCH_SOME */
   GtkBitset *pending; /* not yet filtered items or NULL if all filtered */
   guint pending_cb; /* idle callback handle */
+
+  char *refinement_key; /* refinement key of the filter for the current matches */
+  GPtrArray *refinements; /* previous states, oldest first */
+
+  GPtrArray *prepared; /* data prepared by the filter for each item or NULL */
+};
+
+typedef struct _GtkFilterRefinement GtkFilterRefinement;
+
+struct _GtkFilterRefinement
+{
+  char *key;
+  GtkBitset *matches;
+  GtkBitset *unknown; /* items that were not filtered yet */
 };
 
 struct _GtkFilterListModelClass
@@ -139,6 +169,83 @@ gtk_filter_list_model_model_init (GListModelInterface *iface)
 G_DEFINE_TYPE_WITH_CODE (GtkFilterListModel, gtk_filter_list_model, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_filter_list_model_model_init))
 
+static void
+gtk_filter_list_model_clear_prepared (GtkFilterListModel *self)
+{
+  guint i;
+
+  if (self->prepared == NULL)
+    return;
+
+  for (i = 0; i < self->prepared->len; i++)
+    {
+      gpointer prepared = g_ptr_array_index (self->prepared, i);
+
+      if (prepared)
+        gtk_filter_free_prepared (self->filter, prepared);
+    }
+
+  g_clear_pointer (&self->prepared, g_ptr_array_unref);
+}
+
+static void
+gtk_filter_list_model_splice_prepared (GtkFilterListModel *self,
+                                       guint               position,
+                                       guint               removed,
+                                       guint               added)
+{
+  guint i, len;
+
+  if (self->prepared == NULL)
+    return;
+
+  for (i = position; i < position + removed; i++)
+    {
+      gpointer prepared = g_ptr_array_index (self->prepared, i);
+
+      if (prepared)
+        gtk_filter_free_prepared (self->filter, prepared);
+    }
+  g_ptr_array_remove_range (self->prepared, position, removed);
+
+  len = self->prepared->len;
+  g_ptr_array_set_size (self->prepared, len + added);
+  memmove (self->prepared->pdata + position + added,
+           self->prepared->pdata + position,
+           (len - position) * sizeof (gpointer));
+  memset (self->prepared->pdata + position, 0, added * sizeof (gpointer));
+}
+
+/*
+ * gtk_filter_list_model_prepare_item:
+ * @self: a `GtkFilterListModel`
+ * @position: position of the item
+ *
+ * Updates the data the filter prepared for the item at @position.
+ * The filter must support gtk_filter_prepare().
+ *
+ * Returns: (transfer none): the prepared data
+ */
+static gconstpointer
+gtk_filter_list_model_prepare_item (GtkFilterListModel *self,
+                                    guint               position)
+{
+  gpointer item, prepared;
+
+  if (self->prepared == NULL)
+    {
+      self->prepared = g_ptr_array_new ();
+      g_ptr_array_set_size (self->prepared, g_list_model_get_n_items (self->model));
+    }
+
+  item = g_list_model_get_item (self->model, position);
+  prepared = gtk_filter_prepare (self->filter, item, g_ptr_array_index (self->prepared, position));
+  g_ptr_array_index (self->prepared, position) = prepared;
+  g_object_unref (item);
+
+  return prepared;
+}
+
 static gboolean
 gtk_filter_list_model_run_filter_on_item (GtkFilterListModel *self,
                                           guint               position)
@@ -149,6 +256,10 @@ gtk_filter_list_model_run_filter_on_item (GtkFilterListModel *self,
   /* all other cases should have beeen optimized away */
   g_assert (self->strictness == GTK_FILTER_MATCH_SOME);
 
+  if (gtk_filter_can_prepare (self->filter))
+    return gtk_filter_match_prepared (self->filter,
+                                      gtk_filter_list_model_prepare_item (self, position));
+
   item = g_list_model_get_item (self->model, position);
   visible = gtk_filter_match (self->filter, item);
   g_object_unref (item);
@@ -156,12 +267,110 @@ gtk_filter_list_model_run_filter_on_item (GtkFilterListModel *self,
   return visible;
 }
 
+typedef struct _GtkFilterChunk GtkFilterChunk;
+
+struct _GtkFilterChunk
+{
+  GtkFilter *filter;
+  gconstpointer *prepared;
+  gboolean *visible;
+  gsize n_items;
+};
+
+static gpointer
+gtk_filter_list_model_filter_thread (gpointer data)
+{
+  GtkFilterChunk *chunk = data;
+  gsize i;
+
+  for (i = 0; i < chunk->n_items; i++)
+    chunk->visible[i] = gtk_filter_match_prepared (chunk->filter, chunk->prepared[i]);
+
+  return NULL;
+}
+
+/*
+ * gtk_filter_list_model_run_filter_parallel:
+ * @self: a `GtkFilterListModel`
+ * @n_threads: number of threads to use
+ *
+ * Filters all pending items. The items are prepared in the calling
+ * thread, so no application code runs on other threads, and matching
+ * the prepared data is split across @n_threads threads.
+ *
+ * This requires a filter that supports gtk_filter_prepare().
+ */
+static void
+gtk_filter_list_model_run_filter_parallel (GtkFilterListModel *self,
+                                           guint               n_threads)
+{
+  GtkFilterChunk *chunks;
+  GThread **threads;
+  GtkBitsetIter iter;
+  gconstpointer *prepared;
+  gboolean *visible;
+  gsize i, n, chunk_size;
+  guint pos;
+  gboolean more;
+
+  n = gtk_bitset_get_size (self->pending);
+  prepared = g_new (gconstpointer, n);
+  visible = g_new (gboolean, n);
+
+  for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
+       more;
+       i++, more = gtk_bitset_iter_next (&iter, &pos))
+    prepared[i] = gtk_filter_list_model_prepare_item (self, pos);
+
+  chunks = g_newa (GtkFilterChunk, n_threads);
+  threads = g_newa (GThread *, n_threads);
+  chunk_size = n / n_threads;
+
+  for (i = 0; i < n_threads; i++)
+    {
+      chunks[i].filter = self->filter;
+      chunks[i].prepared = prepared + i * chunk_size;
+      chunks[i].visible = visible + i * chunk_size;
+      chunks[i].n_items = i + 1 < n_threads ? chunk_size : n - i * chunk_size;
+    }
+
+  for (i = 1; i < n_threads; i++)
+    threads[i] = g_thread_new ("GTK filter", gtk_filter_list_model_filter_thread, &chunks[i]);
+
+  gtk_filter_list_model_filter_thread (&chunks[0]);
+
+  for (i = 1; i < n_threads; i++)
+    g_thread_join (threads[i]);
+
+  for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
+       more;
+       i++, more = gtk_bitset_iter_next (&iter, &pos))
+    {
+      if (visible[i])
+        gtk_bitset_add (self->matches, pos);
+    }
+
+  g_free (visible);
+  g_free (prepared);
+}
+
+static guint
+gtk_filter_list_model_get_n_threads (GtkFilterListModel *self,
+                                     guint64             n_items)
+{
+  if (n_items < GTK_FILTER_PARALLEL_MIN_ITEMS ||
+      !gtk_filter_can_prepare (self->filter))
+    return 1;
+
+  return CLAMP (g_get_num_processors (), 1, GTK_FILTER_MAX_THREADS);
+}
+
 static void
 gtk_filter_list_model_run_filter (GtkFilterListModel *self,
                                   guint               n_steps)
 {
   GtkBitsetIter iter;
-  guint i, pos;
+  guint i, pos, n_threads;
   gboolean more;
 
   g_return_if_fail (GTK_IS_FILTER_LIST_MODEL (self));
@@ -169,6 +378,18 @@ gtk_filter_list_model_run_filter (GtkFilterListModel *self,
   if (self->pending == NULL)
     return;
 
+  if (n_steps >= gtk_bitset_get_size (self->pending))
+    {
+      n_threads = gtk_filter_list_model_get_n_threads (self, gtk_bitset_get_size (self->pending));
+      if (n_threads > 1)
+        {
+          gtk_filter_list_model_run_filter_parallel (self, n_threads);
+          g_clear_pointer (&self->pending, gtk_bitset_unref);
+          g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
+          return;
+        }
+    }
+
   for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
        i < n_steps && more;
        i++, more = gtk_bitset_iter_next (&iter, &pos))
@@ -276,6 +497,108 @@ gtk_filter_list_model_start_filtering (GtkFilterListModel *self,
   gdk_source_set_static_name_by_id (self->pending_cb, "[gtk] gtk_filter_list_model_run_filter_cb");
 }
 
+static void
+gtk_filter_refinement_free (gpointer data)
+{
+  GtkFilterRefinement *refinement = data;
+
+  g_free (refinement->key);
+  gtk_bitset_unref (refinement->matches);
+  gtk_bitset_unref (refinement->unknown);
+  g_free (refinement);
+}
+
+static void
+gtk_filter_list_model_clear_refinements (GtkFilterListModel *self)
+{
+  g_clear_pointer (&self->refinement_key, g_free);
+  if (self->refinements)
+    g_ptr_array_set_size (self->refinements, 0);
+}
+
+/*
+ * gtk_filter_list_model_save_refinement:
+ * @self: a `GtkFilterListModel`
+ *
+ * Remembers the current matches for the refinement key they
+ * were computed with, so they can be reused when the filter
+ * returns to that state.
+ */
+static void
+gtk_filter_list_model_save_refinement (GtkFilterListModel *self)
+{
+  GtkFilterRefinement *refinement;
+  guint i;
+
+  if (self->refinement_key == NULL ||
+      self->strictness != GTK_FILTER_MATCH_SOME)
+    return;
+
+  if (self->refinements == NULL)
+    self->refinements = g_ptr_array_new_with_free_func (gtk_filter_refinement_free);
+
+  for (i = 0; i < self->refinements->len; i++)
+    {
+      refinement = g_ptr_array_index (self->refinements, i);
+      if (g_str_equal (refinement->key, self->refinement_key))
+        {
+          g_ptr_array_remove_index (self->refinements, i);
+          break;
+        }
+    }
+
+  if (self->refinements->len >= GTK_FILTER_MAX_REFINEMENTS)
+    g_ptr_array_remove_index (self->refinements, 0);
+
+  refinement = g_new (GtkFilterRefinement, 1);
+  refinement->key = g_strdup (self->refinement_key);
+  refinement->matches = gtk_bitset_copy (self->matches);
+  if (self->pending)
+    refinement->unknown = gtk_bitset_copy (self->pending);
+  else
+    refinement->unknown = gtk_bitset_new_empty ();
+
+  g_ptr_array_add (self->refinements, refinement);
+}
+
+/*
+ * gtk_filter_list_model_find_refinement:
+ * @self: a `GtkFilterListModel`
+ * @key: the refinement key of the filter
+ *
+ * Finds the saved state with the longest key that is a prefix
+ * of @key. All items matched by @key are contained in the
+ * matches or unknown items of that state.
+ *
+ * Returns: (nullable): the saved state
+ */
+static GtkFilterRefinement *
+gtk_filter_list_model_find_refinement (GtkFilterListModel *self,
+                                       const char         *key)
+{
+  GtkFilterRefinement *result = NULL;
+  gsize result_len = 0;
+  guint i;
+
+  if (self->refinements == NULL)
+    return NULL;
+
+  for (i = 0; i < self->refinements->len; i++)
+    {
+      GtkFilterRefinement *refinement = g_ptr_array_index (self->refinements, i);
+      gsize len = strlen (refinement->key);
+
+      if ((result == NULL || len > result_len) &&
+          g_str_has_prefix (key, refinement->key))
+        {
+          result = refinement;
+          result_len = len;
+        }
+    }
+
+  return result;
+}
+
 static void
 gtk_filter_list_model_items_changed_cb (GListModel         *model,
                                         guint               position,
@@ -285,6 +608,23 @@ gtk_filter_list_model_items_changed_cb (GListModel         *model,
 {
   guint filter_removed, filter_added;
 
+  gtk_filter_list_model_splice_prepared (self, position, removed, added);
+
+  if (self->refinements)
+    {
+      guint i;
+
+      for (i = 0; i < self->refinements->len; i++)
+        {
+          GtkFilterRefinement *refinement = g_ptr_array_index (self->refinements, i);
+
+          gtk_bitset_splice (refinement->matches, position, removed, added);
+          gtk_bitset_splice (refinement->unknown, position, removed, added);
+          if (added > 0)
+            gtk_bitset_add_range (refinement->unknown, position, added);
+        }
+    }
+
   switch (self->strictness)
     {
     case GTK_FILTER_MATCH_NONE:
@@ -403,6 +743,8 @@ gtk_filter_list_model_clear_model (GtkFilterListModel *self)
     return;
 
   gtk_filter_list_model_stop_filtering (self);
+  gtk_filter_list_model_clear_refinements (self);
+  gtk_filter_list_model_clear_prepared (self);
   g_signal_handlers_disconnect_by_func (self->model, gtk_filter_list_model_items_changed_cb, self);
   g_clear_object (&self->model);
   if (self->matches)
@@ -414,6 +756,7 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
                                 GtkFilterChange     change)
 {
   GtkFilterMatch new_strictness;
+  const char *refinement_key;
 
   if (self->model == NULL)
     new_strictness = GTK_FILTER_MATCH_NONE;
@@ -422,6 +765,21 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
   else
     new_strictness = gtk_filter_get_strictness (self->filter);
 
+  if (self->filter)
+    refinement_key = gtk_filter_get_refinement_key (self->filter);
+  else
+    refinement_key = NULL;
+
+  /* Without a key, nothing guarantees the saved states are still valid */
+  if (refinement_key == NULL)
+    gtk_filter_list_model_clear_refinements (self);
+  else
+    gtk_filter_list_model_save_refinement (self);
+
+  /* Nothing is matched without a search, so don't keep the data around */
+  if (new_strictness != GTK_FILTER_MATCH_SOME)
+    gtk_filter_list_model_clear_prepared (self);
+
   /* don't set self->strictness yet so get_n_items() and friends return old values */
 
   switch (new_strictness)
@@ -503,6 +861,7 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
 
     case GTK_FILTER_MATCH_SOME:
       {
+        GtkFilterRefinement *refinement;
         GtkBitset *old, *pending;
       
         if (self->matches == NULL)
@@ -517,7 +876,20 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
             old = self->matches;
           }
         self->strictness = new_strictness;
-        switch (change)
+
+        if (refinement_key)
+          refinement = gtk_filter_list_model_find_refinement (self, refinement_key);
+        else
+          refinement = NULL;
+
+        if (refinement && g_str_equal (refinement->key, refinement_key))
+          {
+            /* We've been in this state before, just restore it */
+            gtk_filter_list_model_stop_filtering (self);
+            self->matches = gtk_bitset_copy (refinement->matches);
+            pending = gtk_bitset_copy (refinement->unknown);
+          }
+        else switch (change)
           {
           default:
             g_assert_not_reached ();
@@ -536,11 +908,35 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
             pending = gtk_bitset_copy (old);
             break;
           }
+
+        /* A refinement of a saved state only needs to look at the
+         * items that state may have matched
+         */
+        if (refinement && !g_str_equal (refinement->key, refinement_key))
+          {
+            GtkBitset *candidates;
+
+            candidates = gtk_bitset_copy (refinement->matches);
+            gtk_bitset_union (candidates, refinement->unknown);
+            if (gtk_bitset_get_size (candidates) < gtk_bitset_get_size (pending))
+              {
+                gtk_filter_list_model_stop_filtering (self);
+                gtk_bitset_remove_all (self->matches);
+                gtk_bitset_unref (pending);
+                pending = candidates;
+              }
+            else
+              gtk_bitset_unref (candidates);
+          }
+
         gtk_filter_list_model_start_filtering (self, pending);
 
         gtk_filter_list_model_emit_items_changed_for_changes (self, old);
       }
     }
+
+  g_free (self->refinement_key);
+  self->refinement_key = g_strdup (refinement_key);
 }
 
 static void
@@ -557,8 +953,10 @@ gtk_filter_list_model_clear_filter (GtkFilterListModel *self)
   if (self->filter == NULL)
     return;
 
+  gtk_filter_list_model_clear_prepared (self);
   g_signal_handlers_disconnect_by_func (self->filter, gtk_filter_list_model_filter_changed_cb, self);
   g_clear_object (&self->filter);
+  gtk_filter_list_model_clear_refinements (self);
 }
 
 static void
@@ -569,6 +967,7 @@ gtk_filter_list_model_dispose (GObject *object)
   gtk_filter_list_model_clear_model (self);
   gtk_filter_list_model_clear_filter (self);
   g_clear_pointer (&self->matches, gtk_bitset_unref);
+  g_clear_pointer (&self->refinements, g_ptr_array_unref);
 
   G_OBJECT_CLASS (gtk_filter_list_model_parent_class)->dispose (object);
 }
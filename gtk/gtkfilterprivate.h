@@ -0,0 +1,44 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_FILTER_PRIVATE_H__
+#define __GTK_FILTER_PRIVATE_H__
+
+#include <gtk/gtkfilter.h>
+
+typedef gpointer        (* GtkFilterPrepareFunc)                (GtkFilter              *self,
+                                                                 gpointer                item,
+                                                                 gpointer                prepared);
+typedef gboolean        (* GtkFilterMatchPreparedFunc)          (GtkFilter              *self,
+                                                                 gconstpointer           prepared);
+
+void                    gtk_filter_set_prepare_funcs            (GtkFilter              *self,
+                                                                 GtkFilterPrepareFunc    prepare_func,
+                                                                 GtkFilterMatchPreparedFunc match_prepared_func,
+                                                                 GDestroyNotify          free_func);
+gboolean                gtk_filter_can_prepare                  (GtkFilter              *self);
+gpointer                gtk_filter_prepare                      (GtkFilter              *self,
+                                                                 gpointer                item,
+                                                                 gpointer                prepared);
+gboolean                gtk_filter_match_prepared               (GtkFilter              *self,
+                                                                 gconstpointer           prepared);
+void                    gtk_filter_free_prepared                (GtkFilter              *self,
+                                                                 gpointer                prepared);
+const char *            gtk_filter_get_refinement_key           (GtkFilter              *self);
+void                    gtk_filter_set_refinement_key           (GtkFilter              *self,
+                                                                 const char             *key);
+
+
+#endif /* __GTK_FILTER_PRIVATE_H__ */
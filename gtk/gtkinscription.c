@@ -262,7 +262,7 @@ gtk_inscription_update_layout_attributes (GtkInscription *self,
   if (css_attrs == NULL)
     css_attrs = gtk_css_style_get_pango_attributes (gtk_css_node_get_style (gtk_widget_get_css_node (GTK_WIDGET (self))));
 
-  new_attrs = css_attrs;
+  new_attrs = pango_attr_list_copy (css_attrs);
 
   new_attrs = _gtk_pango_attr_list_merge (new_attrs, self->attrs);
 
@@ -793,10 +793,7 @@ gtk_label_update_layout_attributes (GtkLabel      *self,
   PangoAttrList *attrs;
 
   if (self->layout == NULL)
-    {
-      pango_attr_list_unref (style_attrs);
-      return;
-    }
+    return;
 
   if (self->select_info && self->select_info->links)
     {
@@ -835,8 +832,6 @@ gtk_label_update_layout_attributes (GtkLabel      *self,
           attr->start_index = link->start;
           attr->end_index = link->end;
           pango_attr_list_insert (attrs, attr);
-
-          pango_attr_list_unref (link_attrs);
         }
     }
   else
@@ -846,11 +841,11 @@ gtk_label_update_layout_attributes (GtkLabel      *self,
   if (!style_attrs)
     style_attrs = gtk_css_style_get_pango_attributes (style);
 
-  if (style_attrs)
-    {
-      attrs = _gtk_pango_attr_list_merge (attrs, style_attrs);
-      pango_attr_list_unref (style_attrs);
-    }
+  /* The style attributes are shared, don't let the merging below modify them */
+  if (attrs)
+    attrs = _gtk_pango_attr_list_merge (attrs, style_attrs);
+  else
+    attrs = pango_attr_list_copy (style_attrs);
 
   attrs = _gtk_pango_attr_list_merge (attrs, self->markup_attrs);
   attrs = _gtk_pango_attr_list_merge (attrs, self->attrs);
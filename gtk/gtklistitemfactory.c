@@ -22,6 +22,10 @@
 #include "gtklistitemfactoryprivate.h"
 
 #include "gtklistitemprivate.h"
+#include "gdkprofilerprivate.h"
+
+/* Maximum number of unbound list items kept around for reuse */
+#define GTK_LIST_ITEM_FACTORY_MAX_POOL 128
 
 /**
  * GtkListItemFactory:
@@ -78,6 +82,13 @@
 
 G_DEFINE_TYPE (GtkListItemFactory, gtk_list_item_factory, G_TYPE_OBJECT)
 
+static guint setups_counter;
+static guint teardowns_counter;
+static guint reuses_counter;
+static guint n_setups;
+static guint n_teardowns;
+static guint n_reuses;
+
 static void
 gtk_list_item_factory_default_setup (GtkListItemFactory *self,
                                      GObject            *item,
@@ -112,17 +123,55 @@ gtk_list_item_factory_default_update (GtkListItemFactory *self,
     func (item, data);
 }
 
+static void
+gtk_list_item_factory_teardown_pooled_func (gpointer object,
+                                            gpointer data)
+{
+  gtk_list_item_set_child (GTK_LIST_ITEM (object), NULL);
+}
+
+static void
+gtk_list_item_factory_dispose (GObject *object)
+{
+  GtkListItemFactory *self = GTK_LIST_ITEM_FACTORY (object);
+  GtkListItem *list_item;
+
+  while ((list_item = g_queue_pop_head (&self->pool)))
+    {
+      gtk_list_item_factory_teardown (self,
+                                      G_OBJECT (list_item),
+                                      FALSE,
+                                      gtk_list_item_factory_teardown_pooled_func,
+                                      NULL);
+      g_object_unref (list_item);
+    }
+
+  G_OBJECT_CLASS (gtk_list_item_factory_parent_class)->dispose (object);
+}
+
 static void
 gtk_list_item_factory_class_init (GtkListItemFactoryClass *klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = gtk_list_item_factory_dispose;
+
   klass->setup = gtk_list_item_factory_default_setup;
   klass->teardown = gtk_list_item_factory_default_teardown;
   klass->update = gtk_list_item_factory_default_update;
+
+  if (setups_counter == 0)
+    {
+      setups_counter = gdk_profiler_define_int_counter ("list-item-setups", "List items set up by factories");
+      teardowns_counter = gdk_profiler_define_int_counter ("list-item-teardowns", "List items torn down by factories");
+      reuses_counter = gdk_profiler_define_int_counter ("list-item-reuses", "List items reused from factory pools");
+    }
 }
 
 static void
 gtk_list_item_factory_init (GtkListItemFactory *self)
 {
+  g_queue_init (&self->pool);
 }
 
 void
@@ -135,6 +184,10 @@ gtk_list_item_factory_setup (GtkListItemFactory *self,
   g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
 
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->setup (self, item, bind, func, data);
+
+  n_setups++;
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (setups_counter, n_setups);
 }
 
 void
@@ -147,6 +200,10 @@ gtk_list_item_factory_teardown (GtkListItemFactory *self,
   g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
 
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->teardown (self, item, unbind, func, data);
+
+  n_teardowns++;
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (teardowns_counter, n_teardowns);
 }
 
 void
@@ -162,3 +219,72 @@ gtk_list_item_factory_update (GtkListItemFactory *self,
 
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->update (self, item, unbind, bind, func, data);
 }
+
+/*
+ * gtk_list_item_factory_acquire_pooled:
+ * @self: a `GtkListItemFactory`
+ *
+ * Takes a list item that was set up by @self and released again
+ * via gtk_list_item_factory_release_pooled().
+ *
+ * The list item is unbound and has no owner. Use
+ * gtk_list_item_factory_update() to bind it.
+ *
+ * Returns: (nullable) (transfer full): a list item or %NULL if
+ *   none is available
+ */
+GtkListItem *
+gtk_list_item_factory_acquire_pooled (GtkListItemFactory *self)
+{
+  GtkListItem *list_item;
+
+  g_return_val_if_fail (GTK_IS_LIST_ITEM_FACTORY (self), NULL);
+
+  list_item = g_queue_pop_head (&self->pool);
+  if (list_item == NULL)
+    return NULL;
+
+  n_reuses++;
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (reuses_counter, n_reuses);
+
+  return list_item;
+}
+
+/*
+ * gtk_list_item_factory_can_pool:
+ * @self: a `GtkListItemFactory`
+ *
+ * Checks if @self has room for another unbound list item, so
+ * that it is worth unbinding it instead of tearing it down.
+ *
+ * Returns: %TRUE if gtk_list_item_factory_release_pooled() can be used
+ */
+gboolean
+gtk_list_item_factory_can_pool (GtkListItemFactory *self)
+{
+  g_return_val_if_fail (GTK_IS_LIST_ITEM_FACTORY (self), FALSE);
+
+  return self->pool.length < GTK_LIST_ITEM_FACTORY_MAX_POOL;
+}
+
+/*
+ * gtk_list_item_factory_release_pooled:
+ * @self: a `GtkListItemFactory`
+ * @list_item: (transfer full): an unbound list item set up by @self
+ *
+ * Keeps @list_item around so the next widget that needs a list item
+ * from @self can reuse it instead of setting up a new one.
+ *
+ * Only call this when gtk_list_item_factory_can_pool() returns %TRUE.
+ */
+void
+gtk_list_item_factory_release_pooled (GtkListItemFactory *self,
+                                      GtkListItem        *list_item)
+{
+  g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
+  g_return_if_fail (list_item->owner == NULL);
+  g_return_if_fail (gtk_list_item_factory_can_pool (self));
+
+  g_queue_push_head (&self->pool, list_item);
+}
@@ -29,6 +29,8 @@ G_BEGIN_DECLS
 struct _GtkListItemFactory
 {
   GObject parent_instance;
+
+  GQueue pool; /* set up, but unbound GtkListItems */
 };
 
 struct _GtkListItemFactoryClass
@@ -76,6 +78,11 @@ void                    gtk_list_item_factory_update            (GtkListItemFact
                                                                  GFunc                   func,
                                                                  gpointer                data);
 
+GtkListItem *           gtk_list_item_factory_acquire_pooled    (GtkListItemFactory     *self);
+gboolean                gtk_list_item_factory_can_pool          (GtkListItemFactory     *self);
+void                    gtk_list_item_factory_release_pooled    (GtkListItemFactory     *self,
+                                                                 GtkListItem            *list_item);
+
 
 G_END_DECLS
 
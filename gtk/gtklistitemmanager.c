@@ -22,10 +22,14 @@
 #include "gtklistitemmanagerprivate.h"
 
 #include "gtklistitemwidgetprivate.h"
+#include "gtkprefetchmodel.h"
 #include "gtkwidgetprivate.h"
 
 #define GTK_LIST_VIEW_MAX_LIST_ITEMS 200
 
+/* Maximum number of items we ask a GtkPrefetchModel to load ahead */
+#define GTK_LIST_ITEM_MANAGER_MAX_PREFETCH 1000
+
 struct _GtkListItemManager
 {
   GObject parent_instance;
@@ -39,6 +43,11 @@ struct _GtkListItemManager
 
   GtkRbTree *items;
   GSList *trackers;
+
+  /* visible range when we last prefetched and what we asked for */
+  guint prefetch_visible;
+  guint prefetch_start;
+  guint prefetch_n_items;
 };
 
 struct _GtkListItemManagerClass
@@ -475,6 +484,80 @@ gtk_list_item_manager_release_items (GtkListItemManager *self,
     }
 }
 
+/*
+ * gtk_list_item_manager_prefetch:
+ * @self: a `GtkListItemManager`
+ * @n_items: number of items in the model
+ *
+ * If the model can load items in the background, asks it to load the
+ * items that are likely to become visible next.
+ *
+ * We don't know about scrolling here, so the direction is taken from
+ * how the largest tracked range moved since the last call, and the
+ * number of items is larger the more it moved.
+ */
+static void
+gtk_list_item_manager_prefetch (GtkListItemManager *self,
+                                guint               n_items)
+{
+  guint start, n_tracked, tracker_start, tracker_n_items;
+  guint prefetch_start, prefetch_n_items, distance;
+  GSList *l;
+
+  if (!GTK_IS_PREFETCH_MODEL (self->model))
+    return;
+
+  n_tracked = 0;
+  start = 0;
+  for (l = self->trackers; l; l = l->next)
+    {
+      if (!gtk_list_item_tracker_query_range (self, l->data, n_items, &tracker_start, &tracker_n_items))
+        continue;
+
+      if (tracker_n_items > n_tracked)
+        {
+          start = tracker_start;
+          n_tracked = tracker_n_items;
+        }
+    }
+
+  if (n_tracked == 0)
+    return;
+
+  if (start >= self->prefetch_visible)
+    {
+      distance = start - self->prefetch_visible;
+      prefetch_n_items = CLAMP (MAX (n_tracked, 2 * distance), 1, GTK_LIST_ITEM_MANAGER_MAX_PREFETCH);
+      prefetch_start = start + n_tracked;
+      prefetch_n_items = MIN (prefetch_n_items, n_items - prefetch_start);
+    }
+  else
+    {
+      distance = self->prefetch_visible - start;
+      prefetch_n_items = CLAMP (MAX (n_tracked, 2 * distance), 1, GTK_LIST_ITEM_MANAGER_MAX_PREFETCH);
+      prefetch_n_items = MIN (prefetch_n_items, start);
+      prefetch_start = start - prefetch_n_items;
+    }
+
+  /* Keep the direction when the visible range didn't move */
+  if (distance == 0 && self->prefetch_n_items > 0)
+    return;
+
+  self->prefetch_visible = start;
+
+  if (prefetch_n_items == 0)
+    return;
+
+  if (prefetch_start == self->prefetch_start &&
+      prefetch_n_items == self->prefetch_n_items)
+    return;
+
+  self->prefetch_start = prefetch_start;
+  self->prefetch_n_items = prefetch_n_items;
+
+  gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (self->model), prefetch_start, prefetch_n_items);
+}
+
 static void
 gtk_list_item_manager_ensure_items (GtkListItemManager *self,
                                     GHashTable         *change,
@@ -573,6 +656,8 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
 
   while ((widget = g_queue_pop_head (&released)))
     gtk_list_item_manager_release_list_item (self, NULL, widget);
+
+  gtk_list_item_manager_prefetch (self, n_items);
 }
 
 static void
@@ -788,6 +873,10 @@ gtk_list_item_manager_clear_model (GtkListItemManager *self)
                                         gtk_list_item_manager_model_items_changed_cb,
                                         self);
   g_clear_object (&self->model);
+
+  self->prefetch_visible = 0;
+  self->prefetch_start = 0;
+  self->prefetch_n_items = 0;
 }
 
 static void
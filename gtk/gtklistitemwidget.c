@@ -168,20 +168,34 @@ gtk_list_item_widget_setup_factory (GtkListItemWidget *self)
   GtkListItemWidgetPrivate *priv = gtk_list_item_widget_get_instance_private (self);
   GtkListItem *list_item;
 
-  list_item = gtk_list_item_new ();
+  /* Binding a list item that was set up before is a lot cheaper */
+  list_item = gtk_list_item_factory_acquire_pooled (priv->factory);
+  if (list_item)
+    {
+      gtk_list_item_factory_update (priv->factory,
+                                    G_OBJECT (list_item),
+                                    FALSE,
+                                    priv->item != NULL,
+                                    gtk_list_item_widget_setup_func,
+                                    self);
+    }
+  else
+    {
+      list_item = gtk_list_item_new ();
 
-  gtk_list_item_factory_setup (priv->factory,
-                               G_OBJECT (list_item),
-                               priv->item != NULL,
-                               gtk_list_item_widget_setup_func,
-                               self);
+      gtk_list_item_factory_setup (priv->factory,
+                                   G_OBJECT (list_item),
+                                   priv->item != NULL,
+                                   gtk_list_item_widget_setup_func,
+                                   self);
+    }
 
   g_assert (priv->list_item == list_item);
 }
 
 static void
-gtk_list_item_widget_teardown_func (gpointer object,
-                                    gpointer data)
+gtk_list_item_widget_release_func (gpointer object,
+                                   gpointer data)
 {
   GtkListItemWidget *self = data;
   GtkListItemWidgetPrivate *priv = gtk_list_item_widget_get_instance_private (self);
@@ -201,8 +215,15 @@ gtk_list_item_widget_teardown_func (gpointer object,
                            priv->item != NULL,
                            priv->position != GTK_INVALID_LIST_POSITION,
                            priv->selected);
+}
 
-  gtk_list_item_set_child (list_item, NULL);
+static void
+gtk_list_item_widget_teardown_func (gpointer object,
+                                    gpointer data)
+{
+  gtk_list_item_widget_release_func (object, data);
+
+  gtk_list_item_set_child (object, NULL);
 }
 
 static void
@@ -211,6 +232,21 @@ gtk_list_item_widget_teardown_factory (GtkListItemWidget *self)
   GtkListItemWidgetPrivate *priv = gtk_list_item_widget_get_instance_private (self);
   GtkListItem *list_item = priv->list_item;
 
+  /* Keep the list item set up, so the next widget can bind it */
+  if (gtk_list_item_factory_can_pool (priv->factory))
+    {
+      gtk_list_item_factory_update (priv->factory,
+                                    G_OBJECT (list_item),
+                                    priv->item != NULL,
+                                    FALSE,
+                                    gtk_list_item_widget_release_func,
+                                    self);
+
+      g_assert (priv->list_item == NULL);
+      gtk_list_item_factory_release_pooled (priv->factory, list_item);
+      return;
+    }
+
   gtk_list_item_factory_teardown (priv->factory,
                                   G_OBJECT (list_item),
                                   priv->item != NULL,
@@ -23,6 +23,7 @@
 
 #include "gtkbitset.h"
 #include "gtkintl.h"
+#include "gtkprefetchmodel.h"
 #include "gtkselectionmodel.h"
 
 /**
@@ -118,43 +119,71 @@ static void
 gtk_multi_selection_toggle_selection (GtkMultiSelection *self,
                                       GtkBitset         *changes)
 {
-  GListModel *model = G_LIST_MODEL (self);
-  GtkBitsetIter change_iter, selected_iter;
-  GtkBitset *selected;
-  guint change_pos, selected_pos;
-  gboolean more;
+  GtkBitset *selected, *unselected;
 
   gtk_bitset_difference (self->selected, changes);
 
+  unselected = gtk_bitset_copy (changes);
+  gtk_bitset_subtract (unselected, self->selected);
   selected = gtk_bitset_copy (changes);
   gtk_bitset_intersect (selected, self->selected);
 
-  if (!gtk_bitset_iter_init_first (&selected_iter, selected, &selected_pos))
-    selected_pos = G_MAXUINT;
-
-  for (more = gtk_bitset_iter_init_first (&change_iter, changes, &change_pos);
-       more;
-       more = gtk_bitset_iter_next (&change_iter, &change_pos))
+  /* For large changes, prune the table by position instead of
+   * looking up every unselected item.
+   */
+  if (!gtk_bitset_is_empty (unselected))
     {
-      gpointer item = g_list_model_get_item (model, change_pos);
-
-      if (change_pos < selected_pos)
+      if (gtk_bitset_get_size (unselected) < g_hash_table_size (self->items) / 4)
         {
-          g_hash_table_remove (self->items, item);
-          g_object_unref (item);
+          GtkBitsetIter iter;
+          guint pos;
+          gboolean more;
+
+          for (more = gtk_bitset_iter_init_first (&iter, unselected, &pos);
+               more;
+               more = gtk_bitset_iter_next (&iter, &pos))
+            {
+              gpointer item = g_list_model_get_item (G_LIST_MODEL (self), pos);
+              g_hash_table_remove (self->items, item);
+              g_object_unref (item);
+            }
         }
       else
         {
-          g_assert (change_pos == selected_pos);
+          GHashTableIter iter;
+          gpointer pos_pointer;
+
+          g_hash_table_iter_init (&iter, self->items);
+          while (g_hash_table_iter_next (&iter, NULL, &pos_pointer))
+            {
+              if (!gtk_bitset_contains (self->selected, GPOINTER_TO_UINT (pos_pointer)))
+                g_hash_table_iter_remove (&iter);
+            }
+        }
+    }
 
-          g_hash_table_insert (self->items, item, GUINT_TO_POINTER (change_pos));
+  /* Newly selected items must be looked up right away. Once they
+   * are removed from the model, they can't be found anymore, and
+   * they would lose their selection if they get readded.
+   */
+  if (!gtk_bitset_is_empty (selected))
+    {
+      GtkBitsetIter iter;
+      guint pos;
+      gboolean more;
 
-          if (!gtk_bitset_iter_next (&selected_iter, &selected_pos))
-            selected_pos = G_MAXUINT;
+      for (more = gtk_bitset_iter_init_first (&iter, selected, &pos);
+           more;
+           more = gtk_bitset_iter_next (&iter, &pos))
+        {
+          g_hash_table_insert (self->items,
+                               g_list_model_get_item (self->model, pos),
+                               GUINT_TO_POINTER (pos));
         }
     }
 
   gtk_bitset_unref (selected);
+  gtk_bitset_unref (unselected);
 }
 
 static gboolean
@@ -203,11 +232,30 @@ gtk_multi_selection_selection_model_init (GtkSelectionModelInterface *iface)
   iface->set_selection = gtk_multi_selection_set_selection;
 }
 
+static void
+gtk_multi_selection_prefetch (GtkPrefetchModel *model,
+                              guint             position,
+                              guint             n_items)
+{
+  GtkMultiSelection *self = GTK_MULTI_SELECTION (model);
+
+  if (GTK_IS_PREFETCH_MODEL (self->model))
+    gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (self->model), position, n_items);
+}
+
+static void
+gtk_multi_selection_prefetch_model_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = gtk_multi_selection_prefetch;
+}
+
 G_DEFINE_TYPE_EXTENDED (GtkMultiSelection, gtk_multi_selection, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
                                                gtk_multi_selection_list_model_init)
                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SELECTION_MODEL,
-                                               gtk_multi_selection_selection_model_init))
+                                               gtk_multi_selection_selection_model_init)
+                        G_IMPLEMENT_INTERFACE (GTK_TYPE_PREFETCH_MODEL,
+                                               gtk_multi_selection_prefetch_model_init))
 
 static void
 gtk_multi_selection_items_changed_cb (GListModel        *model,
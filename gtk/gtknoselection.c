@@ -23,6 +23,7 @@
 
 #include "gtkbitset.h"
 #include "gtkintl.h"
+#include "gtkprefetchmodel.h"
 #include "gtkselectionmodel.h"
 
 /**
@@ -115,11 +116,30 @@ gtk_no_selection_selection_model_init (GtkSelectionModelInterface *iface)
   iface->get_selection_in_range = gtk_no_selection_get_selection_in_range;
 }
 
+static void
+gtk_no_selection_prefetch (GtkPrefetchModel *model,
+                           guint             position,
+                           guint             n_items)
+{
+  GtkNoSelection *self = GTK_NO_SELECTION (model);
+
+  if (GTK_IS_PREFETCH_MODEL (self->model))
+    gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (self->model), position, n_items);
+}
+
+static void
+gtk_no_selection_prefetch_model_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = gtk_no_selection_prefetch;
+}
+
 G_DEFINE_TYPE_EXTENDED (GtkNoSelection, gtk_no_selection, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
                                                gtk_no_selection_list_model_init)
                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SELECTION_MODEL,
-                                               gtk_no_selection_selection_model_init))
+                                               gtk_no_selection_selection_model_init)
+                        G_IMPLEMENT_INTERFACE (GTK_TYPE_PREFETCH_MODEL,
+                                               gtk_no_selection_prefetch_model_init))
 
 static void
 gtk_no_selection_items_changed_cb (GListModel     *model,
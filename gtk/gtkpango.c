@@ -28,6 +28,10 @@
 #include "gtkintl.h"
 #include "gtkbuilderprivate.h"
 
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+#include <pango/pangofc-fontmap.h>
+#endif
+
 static gboolean
 attr_list_merge_filter (PangoAttribute *attribute,
                         gpointer        list)
@@ -505,3 +509,146 @@ pango_align_to_string (PangoAlignment align)
       g_assert_not_reached ();
     }
 }
+
+/* Font maps are not threadsafe, so every worker thread that measures
+ * text uses a font map of its own. Idle font maps are kept in a pool
+ * and are dropped whenever the serial of the default font map changes,
+ * so that new ones pick up the current fontconfig configuration.
+ */
+G_LOCK_DEFINE_STATIC (worker_font_maps);
+static GSList *worker_font_maps; /* idle font maps */
+static guint worker_font_map_serial;
+static gboolean worker_font_map_initialized;
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+static FcConfig *worker_font_map_config;
+#endif
+
+/*
+ * gtk_pango_worker_font_map_update:
+ *
+ * Makes sure the worker font maps match the default font map.
+ *
+ * This must be called from the main thread, before queueing work
+ * that uses gtk_pango_worker_font_map_acquire().
+ *
+ * Returns: the serial to pass to gtk_pango_worker_font_map_acquire()
+ */
+guint
+gtk_pango_worker_font_map_update (void)
+{
+  PangoFontMap *font_map;
+  guint serial;
+
+  font_map = pango_cairo_font_map_get_default ();
+  serial = pango_font_map_get_serial (font_map);
+
+  G_LOCK (worker_font_maps);
+
+  if (!worker_font_map_initialized || worker_font_map_serial != serial)
+    {
+      /* Workers still using old font maps drop them on release */
+      g_slist_free_full (worker_font_maps, g_object_unref);
+      worker_font_maps = NULL;
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+      g_clear_pointer (&worker_font_map_config, FcConfigDestroy);
+      if (PANGO_IS_FC_FONT_MAP (font_map))
+        {
+          worker_font_map_config = pango_fc_font_map_get_config (PANGO_FC_FONT_MAP (font_map));
+          if (worker_font_map_config)
+            FcConfigReference (worker_font_map_config);
+        }
+#endif
+      worker_font_map_serial = serial;
+      worker_font_map_initialized = TRUE;
+    }
+
+  G_UNLOCK (worker_font_maps);
+
+  return serial;
+}
+
+/*
+ * gtk_pango_worker_font_map_acquire:
+ * @serial: the serial returned by gtk_pango_worker_font_map_update()
+ *
+ * Gets a font map for the calling worker thread. It is not shared
+ * with other workers until it is given back with
+ * gtk_pango_worker_font_map_release().
+ *
+ * Returns: (nullable) (transfer full): the font map, or %NULL if
+ *   the default font map changed after @serial was obtained
+ */
+PangoFontMap *
+gtk_pango_worker_font_map_acquire (guint serial)
+{
+  PangoFontMap *font_map = NULL;
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+  FcConfig *config = NULL;
+#endif
+
+  G_LOCK (worker_font_maps);
+
+  if (worker_font_map_serial != serial)
+    {
+      G_UNLOCK (worker_font_maps);
+      return NULL;
+    }
+
+  if (worker_font_maps)
+    {
+      font_map = worker_font_maps->data;
+      worker_font_maps = g_slist_delete_link (worker_font_maps, worker_font_maps);
+    }
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+  else if (worker_font_map_config)
+    {
+      config = worker_font_map_config;
+      FcConfigReference (config);
+    }
+#endif
+
+  G_UNLOCK (worker_font_maps);
+
+  if (font_map == NULL)
+    {
+      font_map = pango_cairo_font_map_new ();
+#if defined(GDK_WINDOWING_X11) || defined(GDK_WINDOWING_WAYLAND)
+      if (config)
+        {
+          if (PANGO_IS_FC_FONT_MAP (font_map))
+            pango_fc_font_map_set_config (PANGO_FC_FONT_MAP (font_map), config);
+          FcConfigDestroy (config);
+        }
+#endif
+      g_object_set_data (G_OBJECT (font_map), "gtk-worker-serial", GUINT_TO_POINTER (serial));
+    }
+
+  return font_map;
+}
+
+/*
+ * gtk_pango_worker_font_map_release:
+ * @font_map: (transfer full): the font map returned by
+ *   gtk_pango_worker_font_map_acquire()
+ *
+ * Gives back a worker font map, so other workers can reuse it.
+ */
+void
+gtk_pango_worker_font_map_release (PangoFontMap *font_map)
+{
+  guint serial;
+
+  serial = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (font_map), "gtk-worker-serial"));
+
+  G_LOCK (worker_font_maps);
+
+  if (serial == worker_font_map_serial)
+    {
+      worker_font_maps = g_slist_prepend (worker_font_maps, font_map);
+      font_map = NULL;
+    }
+
+  G_UNLOCK (worker_font_maps);
+
+  g_clear_object (&font_map);
+}
@@ -61,6 +61,10 @@ const char *pango_style_to_string (PangoStyle style);
 const char *pango_variant_to_string (PangoVariant variant);
 const char *pango_align_to_string (PangoAlignment align);
 
+guint          gtk_pango_worker_font_map_update  (void);
+PangoFontMap * gtk_pango_worker_font_map_acquire (guint         serial);
+void           gtk_pango_worker_font_map_release (PangoFontMap *font_map);
+
 G_END_DECLS
 
 #endif /* __GTK_PANGO_H__ */
@@ -0,0 +1,84 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkprefetchmodel.h"
+
+/**
+ * GtkPrefetchModel:
+ *
+ * `GtkPrefetchModel` is an interface for list models that can load
+ * items in the background.
+ *
+ * List widgets tell such models which items they are about to show,
+ * based on the items that are currently visible and the direction
+ * and speed of scrolling. Models backed by slow storage, such as a
+ * database or a network service, can use this to start loading the
+ * items before they are needed.
+ *
+ * Models are expected to return placeholder items for items that are
+ * not loaded yet. Once the data for an item is available, the model
+ * should emit [signal@Gio.ListModel::items-changed] to replace the
+ * placeholder and the list widget will bind the row again.
+ *
+ * GTK's selection models implement this interface and forward the
+ * requests to the model they wrap.
+ *
+ * Since: 4.8
+ */
+
+G_DEFINE_INTERFACE (GtkPrefetchModel, gtk_prefetch_model, G_TYPE_LIST_MODEL)
+
+static void
+gtk_prefetch_model_default_prefetch (GtkPrefetchModel *model,
+                                     guint             position,
+                                     guint             n_items)
+{
+}
+
+static void
+gtk_prefetch_model_default_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = gtk_prefetch_model_default_prefetch;
+}
+
+/**
+ * gtk_prefetch_model_prefetch:
+ * @model: a `GtkPrefetchModel`
+ * @position: the first item to load
+ * @n_items: the number of items to load
+ *
+ * Asks @model to start loading the given items.
+ *
+ * This function must not block. It is only a hint, the model may
+ * ignore it. Each call supersedes the previous one, so models can
+ * cancel loading items that were requested earlier but are not
+ * part of the new range.
+ *
+ * Since: 4.8
+ */
+void
+gtk_prefetch_model_prefetch (GtkPrefetchModel *model,
+                             guint             position,
+                             guint             n_items)
+{
+  g_return_if_fail (GTK_IS_PREFETCH_MODEL (model));
+
+  if (n_items == 0)
+    return;
+
+  GTK_PREFETCH_MODEL_GET_IFACE (model)->prefetch (model, position, n_items);
+}
@@ -0,0 +1,59 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_PREFETCH_MODEL_H__
+#define __GTK_PREFETCH_MODEL_H__
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gtk/gtktypes.h>
+
+G_BEGIN_DECLS
+
+#define GTK_TYPE_PREFETCH_MODEL       (gtk_prefetch_model_get_type ())
+
+GDK_AVAILABLE_IN_4_8
+G_DECLARE_INTERFACE (GtkPrefetchModel, gtk_prefetch_model, GTK, PREFETCH_MODEL, GListModel)
+
+/**
+ * GtkPrefetchModelInterface:
+ * @prefetch: Start loading the items in the given range. See
+ *   [method@Gtk.PrefetchModel.prefetch] for details.
+ *
+ * The list of virtual functions for the `GtkPrefetchModel` interface.
+ *
+ * Since: 4.8
+ */
+struct _GtkPrefetchModelInterface
+{
+  /*< private >*/
+  GTypeInterface g_iface;
+
+  /*< public >*/
+  void                  (* prefetch)                            (GtkPrefetchModel       *model,
+                                                                 guint                   position,
+                                                                 guint                   n_items);
+};
+
+GDK_AVAILABLE_IN_4_8
+void                    gtk_prefetch_model_prefetch             (GtkPrefetchModel       *model,
+                                                                 guint                   position,
+                                                                 guint                   n_items);
+
+G_END_DECLS
+
+#endif /* __GTK_PREFETCH_MODEL_H__ */
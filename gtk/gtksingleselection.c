@@ -23,6 +23,7 @@
 
 #include "gtkbitset.h"
 #include "gtkintl.h"
+#include "gtkprefetchmodel.h"
 #include "gtkselectionmodel.h"
 
 /**
@@ -165,11 +166,30 @@ gtk_single_selection_selection_model_init (GtkSelectionModelInterface *iface)
   iface->unselect_item = gtk_single_selection_unselect_item; 
 }
 
+static void
+gtk_single_selection_prefetch (GtkPrefetchModel *model,
+                               guint             position,
+                               guint             n_items)
+{
+  GtkSingleSelection *self = GTK_SINGLE_SELECTION (model);
+
+  if (GTK_IS_PREFETCH_MODEL (self->model))
+    gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (self->model), position, n_items);
+}
+
+static void
+gtk_single_selection_prefetch_model_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = gtk_single_selection_prefetch;
+}
+
 G_DEFINE_TYPE_EXTENDED (GtkSingleSelection, gtk_single_selection, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL,
                                                gtk_single_selection_list_model_init)
                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SELECTION_MODEL,
-                                               gtk_single_selection_selection_model_init))
+                                               gtk_single_selection_selection_model_init)
+                        G_IMPLEMENT_INTERFACE (GTK_TYPE_PREFETCH_MODEL,
+                                               gtk_single_selection_prefetch_model_init))
 
 static void
 gtk_single_selection_items_changed_cb (GListModel         *model,
@@ -2144,6 +2144,30 @@ gtk_snapshot_append_text (GtkSnapshot           *snapshot,
   gtk_snapshot_append_node_internal (snapshot, node);
 }
 
+/*
+ * gtk_snapshot_append_text_node:
+ * @snapshot: a `GtkSnapshot`
+ * @node: a text node, created in an untransformed snapshot
+ *
+ * Appends a copy of @node at the current offset, just like
+ * gtk_snapshot_append_text() would have created it.
+ */
+void
+gtk_snapshot_append_text_node (GtkSnapshot   *snapshot,
+                               GskRenderNode *node)
+{
+  float dx, dy;
+
+  gtk_snapshot_ensure_translate (snapshot, &dx, &dy);
+
+  if (dx == 0 && dy == 0)
+    node = gsk_render_node_ref (node);
+  else
+    node = gsk_text_node_new_translated (node, dx, dy);
+
+  gtk_snapshot_append_node_internal (snapshot, node);
+}
+
 /**
  * gtk_snapshot_append_linear_gradient:
  * @snapshot: a `GtkSnapshot`
@@ -30,6 +30,8 @@ void                    gtk_snapshot_append_text                (GtkSnapshot
                                                                  const GdkRGBA          *color,
                                                                  float                   x,
                                                                  float                   y);
+void                    gtk_snapshot_append_text_node           (GtkSnapshot            *snapshot,
+                                                                 GskRenderNode          *node);
 
 void                    gtk_snapshot_push_collect               (GtkSnapshot            *snapshot);
 GskRenderNode *         gtk_snapshot_pop_collect                (GtkSnapshot            *snapshot);
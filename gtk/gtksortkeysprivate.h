@@ -32,6 +32,8 @@ struct _GtkSortKeys
 
   gsize key_size;
   gsize key_align; /* must be power of 2 */
+
+  guint threadsafe : 1; /* key_compare() and finish_key() may be called from any thread */
 };
 
 struct _GtkSortKeysClass
@@ -48,6 +50,9 @@ struct _GtkSortKeysClass
                                                                  gpointer                key_memory);
   void                  (* clear_key)                           (GtkSortKeys            *self,
                                                                  gpointer                key_memory);
+  /* optional, does the expensive part of init_key() that doesn't need the item */
+  void                  (* finish_key)                          (GtkSortKeys            *self,
+                                                                 gpointer                key_memory);
 };
 
 GtkSortKeys *           gtk_sort_keys_alloc                     (const GtkSortKeysClass *klass,
@@ -67,6 +72,8 @@ GCompareDataFunc        gtk_sort_keys_get_key_compare_func      (GtkSortKeys
 gboolean                gtk_sort_keys_is_compatible             (GtkSortKeys            *self,
                                                                  GtkSortKeys            *other);
 gboolean                gtk_sort_keys_needs_clear_key           (GtkSortKeys            *self);
+gboolean                gtk_sort_keys_needs_finish_key          (GtkSortKeys            *self);
+gboolean                gtk_sort_keys_is_threadsafe             (GtkSortKeys            *self);
 
 #define GTK_SORT_KEYS_ALIGN(_size,_align) (((_size) + (_align) - 1) & ~((_align) - 1))
 static inline int
@@ -77,12 +84,34 @@ gtk_sort_keys_compare (GtkSortKeys *self,
   return self->klass->key_compare (a, b, self);
 }
                        
+/* Initializes the key as far as it needs the item. This must happen
+ * in the thread owning the item. The key must then be completed with
+ * gtk_sort_keys_finish_key(), which may happen in another thread if
+ * the keys are threadsafe.
+ */
+static inline void
+gtk_sort_keys_prepare_key (GtkSortKeys *self,
+                           gpointer     item,
+                           gpointer     key_memory)
+{
+  self->klass->init_key (self, item, key_memory);
+}
+
+static inline void
+gtk_sort_keys_finish_key (GtkSortKeys *self,
+                          gpointer     key_memory)
+{
+  if (self->klass->finish_key)
+    self->klass->finish_key (self, key_memory);
+}
+
 static inline void
 gtk_sort_keys_init_key (GtkSortKeys *self,
                         gpointer       item,
                         gpointer       key_memory)
 {
-  self->klass->init_key (self, item, key_memory);
+  gtk_sort_keys_prepare_key (self, item, key_memory);
+  gtk_sort_keys_finish_key (self, key_memory);
 }
 
 static inline void
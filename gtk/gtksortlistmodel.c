@@ -52,6 +52,25 @@
  */
 #define GTK_SORT_STEP_TIME_US (1000) /* 1 millisecond */
 
+/* The maximum amount of items added in a single ::items-changed() that
+ * get inserted directly into an already sorted model
+ *
+ * Adding more items than this will start a new (potentially incremental)
+ * sort operation instead, because keys for all the new items need to be
+ * created before they can be inserted.
+ */
+#define GTK_SORT_MAX_INSERT_SIZE (1024)
+
+/* Minimum number of items before we use multiple threads when
+ * doing a non-incremental sort
+ *
+ * Below this, starting the threads costs more than it saves.
+ */
+#define GTK_SORT_PARALLEL_MIN_ITEMS (32 * 1024)
+
+/* Maximum number of threads used for sorting */
+#define GTK_SORT_MAX_THREADS (8)
+
 /**
  * GtkSortListModel:
  *
@@ -206,6 +225,102 @@ gtk_sort_list_model_stop_sorting (GtkSortListModel *self,
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
 }
 
+/* Returns the number of threads to use for sorting or creating
+ * keys for @n_items items in one go.
+ */
+static guint
+gtk_sort_list_model_get_n_threads (GtkSortListModel *self,
+                                   guint64           n_items)
+{
+  if (n_items < GTK_SORT_PARALLEL_MIN_ITEMS ||
+      !gtk_sort_keys_is_threadsafe (self->sort_keys))
+    return 1;
+
+  return CLAMP (g_get_num_processors (), 1, GTK_SORT_MAX_THREADS);
+}
+
+typedef struct _GtkSortKeysChunk GtkSortKeysChunk;
+
+struct _GtkSortKeysChunk
+{
+  GtkSortListModel *self;
+  guint *positions;
+  gsize n_positions;
+};
+
+static gpointer
+gtk_sort_list_model_finish_keys_thread (gpointer data)
+{
+  GtkSortKeysChunk *chunk = data;
+  GtkSortListModel *self = chunk->self;
+  gsize i;
+
+  for (i = 0; i < chunk->n_positions; i++)
+    gtk_sort_keys_finish_key (self->sort_keys, key_from_pos (self, chunk->positions[i]));
+
+  return NULL;
+}
+
+/*
+ * gtk_sort_list_model_create_keys_parallel:
+ * @self: a `GtkSortListModel`
+ * @n_threads: number of threads to use
+ *
+ * Creates all missing keys. Items are only ever accessed from the
+ * calling thread, but finishing the keys, which is the expensive
+ * part for things like collation keys, is split across @n_threads
+ * threads.
+ */
+static void
+gtk_sort_list_model_create_keys_parallel (GtkSortListModel *self,
+                                          guint             n_threads)
+{
+  GtkSortKeysChunk *chunks;
+  GThread **threads;
+  GtkBitsetIter iter;
+  guint *positions;
+  gsize i, n, chunk_size;
+  guint pos;
+
+  n = gtk_bitset_get_size (self->missing_keys);
+  positions = g_new (guint, n);
+
+  i = 0;
+  for (gtk_bitset_iter_init_first (&iter, self->missing_keys, &pos);
+       gtk_bitset_iter_is_valid (&iter);
+       gtk_bitset_iter_next (&iter, &pos))
+    {
+      gpointer item = g_list_model_get_item (self->model, pos);
+      gtk_sort_keys_prepare_key (self->sort_keys, item, key_from_pos (self, pos));
+      g_object_unref (item);
+      positions[i++] = pos;
+    }
+
+  if (gtk_sort_keys_needs_finish_key (self->sort_keys))
+    {
+      chunks = g_newa (GtkSortKeysChunk, n_threads);
+      threads = g_newa (GThread *, n_threads);
+      chunk_size = n / n_threads;
+
+      for (i = 0; i < n_threads; i++)
+        {
+          chunks[i].self = self;
+          chunks[i].positions = positions + i * chunk_size;
+          chunks[i].n_positions = i + 1 < n_threads ? chunk_size : n - i * chunk_size;
+        }
+
+      for (i = 1; i < n_threads; i++)
+        threads[i] = g_thread_new ("GTK sort keys", gtk_sort_list_model_finish_keys_thread, &chunks[i]);
+
+      gtk_sort_list_model_finish_keys_thread (&chunks[0]);
+
+      for (i = 1; i < n_threads; i++)
+        g_thread_join (threads[i]);
+    }
+
+  g_free (positions);
+}
+
 static gboolean
 gtk_sort_list_model_sort_step (GtkSortListModel *self,
                                gboolean          finish,
@@ -216,6 +331,7 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
   gboolean result = FALSE;
   GtkTimSortRun change;
   gpointer *start_change, *end_change;
+  guint n_threads;
 
   end_time += GTK_SORT_STEP_TIME_US;
 
@@ -224,20 +340,32 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
       GtkBitsetIter iter;
       guint pos;
 
-      for (gtk_bitset_iter_init_first (&iter, self->missing_keys, &pos);
-           gtk_bitset_iter_is_valid (&iter);
-           gtk_bitset_iter_next (&iter, &pos))
-        {
-          gpointer item = g_list_model_get_item (self->model, pos);
-          gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, pos));
-          g_object_unref (item);
+      if (finish)
+        n_threads = gtk_sort_list_model_get_n_threads (self, gtk_bitset_get_size (self->missing_keys));
+      else
+        n_threads = 1;
 
-          if (g_get_monotonic_time () >= end_time && !finish)
+      if (n_threads > 1)
+        {
+          gtk_sort_list_model_create_keys_parallel (self, n_threads);
+        }
+      else
+        {
+          for (gtk_bitset_iter_init_first (&iter, self->missing_keys, &pos);
+               gtk_bitset_iter_is_valid (&iter);
+               gtk_bitset_iter_next (&iter, &pos))
             {
-              gtk_bitset_remove_range_closed (self->missing_keys, 0, pos);
-              *out_position = 0;
-              *out_n_items = 0;
-              return TRUE;
+              gpointer item = g_list_model_get_item (self->model, pos);
+              gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, pos));
+              g_object_unref (item);
+
+              if (g_get_monotonic_time () >= end_time && !finish)
+                {
+                  gtk_bitset_remove_range_closed (self->missing_keys, 0, pos);
+                  *out_position = 0;
+                  *out_n_items = 0;
+                  return TRUE;
+                }
             }
         }
       result = TRUE;
@@ -247,6 +375,24 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
   end_change = self->positions;
   start_change = self->positions + self->n_items;
 
+  /* When sorting in one go, sort the unsorted part in chunks on
+   * multiple threads, so only the merges remain to be done here.
+   */
+  if (finish)
+    {
+      n_threads = gtk_sort_list_model_get_n_threads (self, self->sort.size);
+      if (n_threads > 1)
+        {
+          gtk_tim_sort_presort_parallel (&self->sort, n_threads, &change);
+          if (change.len)
+            {
+              result = TRUE;
+              start_change = MIN (start_change, (gpointer *) change.base);
+              end_change = MAX (end_change, ((gpointer *) change.base) + change.len);
+            }
+        }
+    }
+
   while (gtk_tim_sort_step (&self->sort, &change))
     {
       result = TRUE;
@@ -564,6 +710,75 @@ gtk_sort_list_model_update_items (GtkSortListModel *self,
   *unmodified_end = end;
 }
 
+/*
+ * gtk_sort_list_model_insert_items:
+ * @self: a `GtkSortListModel`
+ * @position: position of the added items in the model
+ * @added: number of added items
+ * @unmodified_start: (inout): number of unchanged items at the start
+ * @unmodified_end: (inout): number of unchanged items at the end
+ *
+ * Inserts the items that gtk_sort_list_model_update_items() appended to
+ * the positions array into their sorted place. This requires the rest
+ * of the array to be sorted.
+ *
+ * The added items are sorted among themselves and then merged into
+ * the array from the back, so this only needs O(added * log n)
+ * comparisons and moves every item at most once.
+ */
+static void
+gtk_sort_list_model_insert_items (GtkSortListModel *self,
+                                  guint             position,
+                                  guint             added,
+                                  guint            *unmodified_start,
+                                  guint            *unmodified_end)
+{
+  gpointer *added_keys;
+  guint i, hi, write;
+
+  for (i = 0; i < added; i++)
+    {
+      gpointer item = g_list_model_get_item (self->model, position + i);
+      gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, position + i));
+      g_object_unref (item);
+    }
+  gtk_bitset_remove_range (self->missing_keys, position, added);
+
+  hi = self->n_items - added;
+  added_keys = g_memdup2 (self->positions + hi, added * sizeof (gpointer));
+  gtk_tim_sort (added_keys, added, sizeof (gpointer), sort_func, self->sort_keys);
+
+  write = self->n_items;
+  for (i = added; i-- > 0;)
+    {
+      guint lo, mid, pos;
+
+      /* find the first item sorting after the added one */
+      lo = 0;
+      pos = hi;
+      while (lo < pos)
+        {
+          mid = (lo + pos) / 2;
+          if (sort_func (&self->positions[mid], &added_keys[i], self->sort_keys) > 0)
+            pos = mid;
+          else
+            lo = mid + 1;
+        }
+
+      write -= hi - pos;
+      memmove (self->positions + write, self->positions + pos, (hi - pos) * sizeof (gpointer));
+      write--;
+      self->positions[write] = added_keys[i];
+      hi = pos;
+
+      if (i + 1 == added)
+        *unmodified_end = MIN (*unmodified_end, self->n_items - write - 1);
+    }
+  *unmodified_start = MIN (*unmodified_start, write);
+
+  g_free (added_keys);
+}
+
 static void
 gtk_sort_list_model_items_changed_cb (GListModel       *model,
                                       guint             position,
@@ -594,7 +809,11 @@ gtk_sort_list_model_items_changed_cb (GListModel       *model,
 
   if (added > 0)
     {
-      if (gtk_sort_list_model_start_sorting (self, runs))
+      if (!was_sorting && added <= GTK_SORT_MAX_INSERT_SIZE)
+        {
+          gtk_sort_list_model_insert_items (self, position, added, &start, &end);
+        }
+      else if (gtk_sort_list_model_start_sorting (self, runs))
         {
           end = 0;
         }
@@ -21,6 +21,7 @@
 
 #include "gtkstringfilter.h"
 
+#include "gtkfilterprivate.h"
 #include "gtkintl.h"
 #include "gtktypebuiltins.h"
 
@@ -53,6 +54,7 @@ struct _GtkStringFilter
   GtkStringFilterMatchMode match_mode;
 
   GtkExpression *expression;
+  guint expression_serial; /* changes with the expression, for refinement keys */
 };
 
 enum {
@@ -64,6 +66,18 @@ enum {
   NUM_PROPERTIES
 };
 
+/* The prepared string of an item, kept by GtkFilterListModel so
+ * that refiltering after the search changes only needs to evaluate
+ * the expression but not normalize and casefold the result again.
+ */
+typedef struct _GtkStringFilterHaystack GtkStringFilterHaystack;
+struct _GtkStringFilterHaystack
+{
+  char *source;
+  char *prepared;
+  gboolean ignore_case;
+};
+
 G_DEFINE_TYPE (GtkStringFilter, gtk_string_filter, GTK_TYPE_FILTER)
 
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
@@ -89,6 +103,103 @@ gtk_string_filter_prepare (GtkStringFilter *self,
   return result;
 }
 
+static void
+gtk_string_filter_haystack_free (gpointer data)
+{
+  GtkStringFilterHaystack *haystack = data;
+
+  g_free (haystack->source);
+  g_free (haystack->prepared);
+  g_free (haystack);
+}
+
+/* Evaluates the expression, so this must be called on the
+ * thread owning @item.
+ */
+static gpointer
+gtk_string_filter_prepare_item (GtkFilter *filter,
+                                gpointer   item,
+                                gpointer   data)
+{
+  GtkStringFilter *self = GTK_STRING_FILTER (filter);
+  GtkStringFilterHaystack *haystack = data;
+  GValue value = G_VALUE_INIT;
+  const char *s;
+
+  if (self->expression != NULL &&
+      gtk_expression_evaluate (self->expression, item, &value))
+    s = g_value_get_string (&value);
+  else
+    s = NULL;
+
+  if (haystack == NULL)
+    {
+      haystack = g_new0 (GtkStringFilterHaystack, 1);
+    }
+  else if (haystack->ignore_case == self->ignore_case &&
+           g_strcmp0 (haystack->source, s) == 0)
+    {
+      if (G_IS_VALUE (&value))
+        g_value_unset (&value);
+      return haystack;
+    }
+  else
+    {
+      g_free (haystack->source);
+      g_free (haystack->prepared);
+    }
+
+  haystack->source = g_strdup (s);
+  haystack->prepared = gtk_string_filter_prepare (self, s);
+  haystack->ignore_case = self->ignore_case;
+
+  if (G_IS_VALUE (&value))
+    g_value_unset (&value);
+
+  return haystack;
+}
+
+/* The prepared search comes last in the key, so that extending the
+ * search extends the key. In exact mode this does not narrow the
+ * results, so the length of the search is encoded in front of it.
+ */
+static void
+gtk_string_filter_update_refinement_key (GtkStringFilter *self)
+{
+  char *key;
+
+  if (self->expression == NULL || self->search_prepared == NULL)
+    {
+      gtk_filter_set_refinement_key (GTK_FILTER (self), NULL);
+      return;
+    }
+
+  switch (self->match_mode)
+    {
+    case GTK_STRING_FILTER_MATCH_MODE_EXACT:
+      key = g_strdup_printf ("%u e%d %zu:%s",
+                             self->expression_serial, self->ignore_case,
+                             strlen (self->search_prepared), self->search_prepared);
+      break;
+    case GTK_STRING_FILTER_MATCH_MODE_SUBSTRING:
+      key = g_strdup_printf ("%u s%d %s",
+                             self->expression_serial, self->ignore_case,
+                             self->search_prepared);
+      break;
+    case GTK_STRING_FILTER_MATCH_MODE_PREFIX:
+      key = g_strdup_printf ("%u p%d %s",
+                             self->expression_serial, self->ignore_case,
+                             self->search_prepared);
+      break;
+    default:
+      g_assert_not_reached ();
+      return;
+    }
+
+  gtk_filter_set_refinement_key (GTK_FILTER (self), key);
+  g_free (key);
+}
+
 /* This is necessary because code just looks at self->search otherwise
  * and that can be the empty string...
  */
@@ -99,23 +210,11 @@ gtk_string_filter_has_search (GtkStringFilter *self)
 }
 
 static gboolean
-gtk_string_filter_match (GtkFilter *filter,
-                         gpointer   item)
+gtk_string_filter_match_prepared_string (GtkStringFilter *self,
+                                         const char      *prepared)
 {
-  GtkStringFilter *self = GTK_STRING_FILTER (filter);
-  GValue value = G_VALUE_INIT;
-  char *prepared;
-  const char *s;
   gboolean result;
 
-  if (!gtk_string_filter_has_search (self))
-    return TRUE;
-
-  if (self->expression == NULL ||
-      !gtk_expression_evaluate (self->expression, item, &value))
-    return FALSE;
-  s = g_value_get_string (&value);
-  prepared = gtk_string_filter_prepare (self, s);
   if (prepared == NULL)
     return FALSE;
 
@@ -134,8 +233,52 @@ gtk_string_filter_match (GtkFilter *filter,
       g_assert_not_reached ();
     }
 
+  return result;
+}
+
+/* Only reads the filter and the haystack, so this may run on
+ * multiple threads.
+ */
+static gboolean
+gtk_string_filter_match_prepared (GtkFilter     *filter,
+                                  gconstpointer  data)
+{
+  GtkStringFilter *self = GTK_STRING_FILTER (filter);
+  const GtkStringFilterHaystack *haystack = data;
+
+  if (!gtk_string_filter_has_search (self))
+    return TRUE;
+
+  if (self->expression == NULL)
+    return FALSE;
+
+  /* Items are prepared again right before matching */
+  g_assert (haystack->ignore_case == self->ignore_case);
+
+  return gtk_string_filter_match_prepared_string (self, haystack->prepared);
+}
+
+static gboolean
+gtk_string_filter_match (GtkFilter *filter,
+                         gpointer   item)
+{
+  GtkStringFilter *self = GTK_STRING_FILTER (filter);
+  GValue value = G_VALUE_INIT;
+  char *prepared;
+  gboolean result;
+
+  if (!gtk_string_filter_has_search (self))
+    return TRUE;
+
+  if (self->expression == NULL ||
+      !gtk_expression_evaluate (self->expression, item, &value))
+    return FALSE;
+
+  prepared = gtk_string_filter_prepare (self, g_value_get_string (&value));
+  result = gtk_string_filter_match_prepared_string (self, prepared);
+
 #if 0
-  g_print ("%s (%s) %s %s (%s)\n", s, prepared, result ? "==" : "!=", self->search, self->search_prepared);
+  g_print ("%s (%s) %s %s (%s)\n", g_value_get_string (&value), prepared, result ? "==" : "!=", self->search, self->search_prepared);
 #endif
 
   g_free (prepared);
@@ -288,7 +431,6 @@ gtk_string_filter_class_init (GtkStringFilterClass *class)
                            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_EXPLICIT_NOTIFY);
 
   g_object_class_install_properties (object_class, NUM_PROPERTIES, properties);
-
 }
 
 static void
@@ -296,6 +438,11 @@ gtk_string_filter_init (GtkStringFilter *self)
 {
   self->ignore_case = TRUE;
   self->match_mode = GTK_STRING_FILTER_MATCH_MODE_SUBSTRING;
+
+  gtk_filter_set_prepare_funcs (GTK_FILTER (self),
+                                gtk_string_filter_prepare_item,
+                                gtk_string_filter_match_prepared,
+                                gtk_string_filter_haystack_free);
 }
 
 /**
@@ -374,6 +521,7 @@ gtk_string_filter_set_search (GtkStringFilter *self,
 
   self->search = g_strdup (search);
   self->search_prepared = gtk_string_filter_prepare (self, search);
+  gtk_string_filter_update_refinement_key (self);
 
   gtk_filter_changed (GTK_FILTER (self), change);
 
@@ -418,7 +566,11 @@ gtk_string_filter_set_expression (GtkStringFilter *self,
     return;
 
   g_clear_pointer (&self->expression, gtk_expression_unref);
-  self->expression = gtk_expression_ref (expression);
+  if (expression)
+    self->expression = gtk_expression_ref (expression);
+  self->expression_serial++;
+
+  gtk_string_filter_update_refinement_key (self);
 
   if (gtk_string_filter_has_search (self))
     gtk_filter_changed (GTK_FILTER (self), GTK_FILTER_CHANGE_DIFFERENT);
@@ -464,6 +616,7 @@ gtk_string_filter_set_ignore_case (GtkStringFilter *self,
     {
       g_free (self->search_prepared);
       self->search_prepared = gtk_string_filter_prepare (self, self->search);
+      gtk_string_filter_update_refinement_key (self);
       gtk_filter_changed (GTK_FILTER (self), ignore_case ? GTK_FILTER_CHANGE_LESS_STRICT : GTK_FILTER_CHANGE_MORE_STRICT);
     }
 
@@ -506,6 +659,7 @@ gtk_string_filter_set_match_mode (GtkStringFilter *self,
 
   old_mode = self->match_mode;
   self->match_mode = mode;
+  gtk_string_filter_update_refinement_key (self);
 
   if (self->search_prepared && self->expression)
     {
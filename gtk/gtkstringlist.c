@@ -66,16 +66,38 @@
  * a [property@Gtk.StringObject:string] property.
  */
 
-#define GDK_ARRAY_ELEMENT_TYPE GtkStringObject *
-#define GDK_ARRAY_NAME objects
-#define GDK_ARRAY_TYPE_NAME Objects
-#define GDK_ARRAY_FREE_FUNC g_object_unref
+/* Items are either a GtkStringObject or, until somebody asks for the
+ * object, an interned GRefString. Strings are tagged by setting the
+ * lowest bit of the pointer, which is always unset for allocations.
+ * Once created, objects are kept for as long as the item exists.
+ */
+#define IS_STRING(item) (GPOINTER_TO_SIZE (item) & 0x1)
+#define TO_STRING(item) ((const char *) (GPOINTER_TO_SIZE (item) & ~0x1))
+#define FROM_STRING(str) ((gpointer) (GPOINTER_TO_SIZE (str) | 0x1))
+
+static void
+gtk_string_list_item_free (gpointer item)
+{
+  if (IS_STRING (item))
+    {
+      if (TO_STRING (item))
+        g_ref_string_release ((char *) TO_STRING (item));
+    }
+  else
+    g_object_unref (item);
+}
+
+#define GDK_ARRAY_ELEMENT_TYPE gpointer
+#define GDK_ARRAY_NAME items
+#define GDK_ARRAY_TYPE_NAME Items
+#define GDK_ARRAY_FREE_FUNC gtk_string_list_item_free
 #include "gdk/gdkarrayimpl.c"
 
 struct _GtkStringObject
 {
   GObject parent_instance;
   char *string;
+  guint is_ref_string : 1; /* string is a GRefString shared with the list */
 };
 
 enum {
@@ -95,7 +117,10 @@ gtk_string_object_finalize (GObject *object)
 {
   GtkStringObject *self = GTK_STRING_OBJECT (object);
 
-  g_free (self->string);
+  if (self->is_ref_string)
+    g_clear_pointer (&self->string, g_ref_string_release);
+  else
+    g_free (self->string);
 
   G_OBJECT_CLASS (gtk_string_object_parent_class)->finalize (object);
 }
@@ -154,6 +179,18 @@ gtk_string_object_new_take (char *string)
   return obj;
 }
 
+/* NB: string must be a GRefString or NULL */
+static GtkStringObject *
+gtk_string_object_new_take_ref (char *string)
+{
+  GtkStringObject *obj;
+
+  obj = gtk_string_object_new_take (string);
+  obj->is_ref_string = TRUE;
+
+  return obj;
+}
+
 /**
  * gtk_string_object_new:
  * @string: (not nullable): The string to wrap
@@ -188,7 +225,7 @@ struct _GtkStringList
 {
   GObject parent_instance;
 
-  Objects items;
+  Items items;
 };
 
 struct _GtkStringListClass
@@ -207,7 +244,7 @@ gtk_string_list_get_n_items (GListModel *list)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
 
-  return objects_get_size (&self->items);
+  return items_get_size (&self->items);
 }
 
 static gpointer
@@ -215,11 +252,19 @@ gtk_string_list_get_item (GListModel *list,
                           guint       position)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
+  gpointer *item;
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return g_object_ref (objects_get (&self->items, position));
+  item = items_index (&self->items, position);
+  if (IS_STRING (*item))
+    {
+      /* the object takes over our reference to the string */
+      *item = gtk_string_object_new_take_ref ((char *) TO_STRING (*item));
+    }
+
+  return g_object_ref (*item);
 }
 
 static void
@@ -406,7 +451,7 @@ gtk_string_list_dispose (GObject *object)
 {
   GtkStringList *self = GTK_STRING_LIST (object);
 
-  objects_clear (&self->items);
+  items_clear (&self->items);
 
   G_OBJECT_CLASS (gtk_string_list_parent_class)->dispose (object);
 }
@@ -422,7 +467,37 @@ gtk_string_list_class_init (GtkStringListClass *class)
 static void
 gtk_string_list_init (GtkStringList *self)
 {
-  objects_init (&self->items);
+  items_init (&self->items);
+}
+
+/*
+ * gtk_string_list_splice_strings:
+ * @self: a `GtkStringList`
+ * @position: the position at which to make the change
+ * @n_removals: the number of strings to remove
+ * @additions: (array length=n_additions): the strings to add
+ * @n_additions: the number of strings in @additions
+ *
+ * Does the work for the functions copying strings into the
+ * list, but does not emit ::items-changed.
+ */
+static void
+gtk_string_list_splice_strings (GtkStringList      *self,
+                                guint               position,
+                                guint               n_removals,
+                                const char * const *additions,
+                                guint               n_additions)
+{
+  guint i;
+
+  items_splice (&self->items, position, n_removals, FALSE, NULL, n_additions);
+
+  for (i = 0; i < n_additions; i++)
+    {
+      const char *string = additions[i] ? g_ref_string_new_intern (additions[i]) : NULL;
+
+      *items_index (&self->items, position + i) = FROM_STRING (string);
+    }
 }
 
 /**
@@ -471,23 +546,18 @@ gtk_string_list_splice (GtkStringList      *self,
                         guint               n_removals,
                         const char * const *additions)
 {
-  guint i, n_additions;
+  guint n_additions;
 
   g_return_if_fail (GTK_IS_STRING_LIST (self));
   g_return_if_fail (position + n_removals >= position); /* overflow */
-  g_return_if_fail (position + n_removals <= objects_get_size (&self->items));
+  g_return_if_fail (position + n_removals <= items_get_size (&self->items));
 
   if (additions)
     n_additions = g_strv_length ((char **) additions);
   else
     n_additions = 0;
 
-  objects_splice (&self->items, position, n_removals, FALSE, NULL, n_additions);
-
-  for (i = 0; i < n_additions; i++)
-    {
-      *objects_index (&self->items, position + i) = gtk_string_object_new (additions[i]);
-    }
+  gtk_string_list_splice_strings (self, position, n_removals, additions, n_additions);
 
   if (n_removals || n_additions)
     g_list_model_items_changed (G_LIST_MODEL (self), position, n_removals, n_additions);
@@ -509,9 +579,47 @@ gtk_string_list_append (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new (string));
+  gtk_string_list_splice_strings (self, items_get_size (&self->items), 0, &string, 1);
 
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  g_list_model_items_changed (G_LIST_MODEL (self), items_get_size (&self->items) - 1, 0, 1);
+}
+
+/**
+ * gtk_string_list_append_strings:
+ * @self: a `GtkStringList`
+ * @strings: (array length=n_strings): the strings to append
+ * @n_strings: the number of strings in @strings or -1 if
+ *   @strings is %NULL-terminated
+ *
+ * Appends @strings to @self.
+ *
+ * The strings will be copied. Unlike calling
+ * [method@Gtk.StringList.append] repeatedly, this only emits
+ * the ::items-changed signal once, so it is the preferred way
+ * to fill a list with lots of strings.
+ *
+ * Since: 4.8
+ */
+void
+gtk_string_list_append_strings (GtkStringList      *self,
+                                const char * const *strings,
+                                gssize              n_strings)
+{
+  guint position;
+
+  g_return_if_fail (GTK_IS_STRING_LIST (self));
+  g_return_if_fail (strings != NULL || n_strings <= 0);
+
+  if (n_strings < 0)
+    n_strings = strings ? g_strv_length ((char **) strings) : 0;
+
+  if (n_strings == 0)
+    return;
+
+  position = items_get_size (&self->items);
+  gtk_string_list_splice_strings (self, position, 0, strings, n_strings);
+
+  g_list_model_items_changed (G_LIST_MODEL (self), position, 0, n_strings);
 }
 
 /**
@@ -535,9 +643,10 @@ gtk_string_list_take (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new_take (string));
+  /* Keep the string we were given instead of copying it */
+  items_append (&self->items, gtk_string_object_new_take (string));
 
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  g_list_model_items_changed (G_LIST_MODEL (self), items_get_size (&self->items) - 1, 0, 1);
 }
 
 /**
@@ -577,10 +686,16 @@ const char *
 gtk_string_list_get_string (GtkStringList *self,
                             guint          position)
 {
+  gpointer item;
+
   g_return_val_if_fail (GTK_IS_STRING_LIST (self), NULL);
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return objects_get (&self->items, position)->string;
+  item = items_get (&self->items, position);
+  if (IS_STRING (item))
+    return TO_STRING (item);
+  else
+    return GTK_STRING_OBJECT (item)->string;
 }
@@ -53,6 +53,11 @@ GDK_AVAILABLE_IN_ALL
 void            gtk_string_list_append          (GtkStringList         *self,
                                                  const char            *string);
 
+GDK_AVAILABLE_IN_4_8
+void            gtk_string_list_append_strings  (GtkStringList         *self,
+                                                 const char * const    *strings,
+                                                 gssize                 n_strings);
+
 GDK_AVAILABLE_IN_ALL
 void            gtk_string_list_take            (GtkStringList         *self,
                                                  char                  *string);
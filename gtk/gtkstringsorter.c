@@ -59,33 +59,44 @@ G_DEFINE_TYPE (GtkStringSorter, gtk_string_sorter, GTK_TYPE_SORTER)
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
 
 static char *
-gtk_string_sorter_get_key (GtkExpression *expression,
-                           gboolean       ignore_case,
-                           gpointer       item1)
+gtk_string_sorter_collate_key (const char *string,
+                               gboolean    ignore_case)
 {
-  GValue value = G_VALUE_INIT;
   char *s;
 
-  if (expression == NULL)
-    return NULL;
-
-  if (!gtk_expression_evaluate (expression, item1, &value))
-    return NULL;
-
   /* If strings are NULL, order them before "". */
   if (ignore_case)
     {
       char *t;
 
-      t = g_utf8_casefold (g_value_get_string (&value), -1);
+      t = g_utf8_casefold (string, -1);
       s = g_utf8_collate_key (t, -1);
       g_free (t);
     }
   else
     {
-      s = g_utf8_collate_key (g_value_get_string (&value), -1);
+      s = g_utf8_collate_key (string, -1);
     }
 
+  return s;
+}
+
+static char *
+gtk_string_sorter_get_key (GtkExpression *expression,
+                           gboolean       ignore_case,
+                           gpointer       item1)
+{
+  GValue value = G_VALUE_INIT;
+  char *s;
+
+  if (expression == NULL)
+    return NULL;
+
+  if (!gtk_expression_evaluate (expression, item1, &value))
+    return NULL;
+
+  s = gtk_string_sorter_collate_key (g_value_get_string (&value), ignore_case);
+
   g_value_unset (&value);
 
   return s;
@@ -173,8 +184,31 @@ gtk_string_sort_keys_init_key (GtkSortKeys *keys,
 {
   GtkStringSortKeys *self = (GtkStringSortKeys *) keys;
   char **key = (char **) key_memory;
+  GValue value = G_VALUE_INIT;
+
+  /* Only fetch the string here, collating happens in finish_key() */
+  if (gtk_expression_evaluate (self->expression, item, &value))
+    *key = g_value_dup_string (&value);
+  else
+    *key = NULL;
+
+  g_value_unset (&value);
+}
+
+static void
+gtk_string_sort_keys_finish_key (GtkSortKeys *keys,
+                                 gpointer     key_memory)
+{
+  GtkStringSortKeys *self = (GtkStringSortKeys *) keys;
+  char **key = (char **) key_memory;
+  char *s;
+
+  if (*key == NULL)
+    return;
 
-  *key = gtk_string_sorter_get_key (self->expression, self->ignore_case, item);
+  s = *key;
+  *key = gtk_string_sorter_collate_key (s, self->ignore_case);
+  g_free (s);
 }
 
 static void
@@ -193,6 +227,7 @@ static const GtkSortKeysClass GTK_STRING_SORT_KEYS_CLASS =
   gtk_string_sort_keys_is_compatible,
   gtk_string_sort_keys_init_key,
   gtk_string_sort_keys_clear_key,
+  gtk_string_sort_keys_finish_key,
 };
 
 static GtkSortKeys *
@@ -210,6 +245,7 @@ gtk_string_sort_keys_new (GtkStringSorter *self)
 
   result->expression = gtk_expression_ref (self->expression);
   result->ignore_case = self->ignore_case;
+  result->keys.threadsafe = TRUE;
 
   return (GtkSortKeys *) result;
 }
@@ -34,7 +34,7 @@
 #include "gtkeditable.h"
 #include "gtkemojichooser.h"
 #include "gtkemojicompletion.h"
-#include "gtkentrybuffer.h"
+#include "gtkentrybufferprivate.h"
 #include "gtkeventcontrollerfocus.h"
 #include "gtkeventcontrollerkey.h"
 #include "gtkeventcontrollermotion.h"
@@ -2086,6 +2086,36 @@ gtk_text_get_display_mode (GtkText *self)
   return DISPLAY_INVISIBLE;
 }
 
+/* The text of our layouts is the buffer text unless it is
+ * invisible or contains preedit text, and then the buffer can
+ * convert between offsets without walking all of the text.
+ */
+static int
+gtk_text_layout_offset_to_index (GtkText    *self,
+                                 const char *text,
+                                 int         offset)
+{
+  GtkTextPrivate *priv = gtk_text_get_instance_private (self);
+
+  if (priv->visible && priv->preedit_length == 0)
+    return gtk_entry_buffer_get_byte_offset (get_buffer (self), offset);
+
+  return g_utf8_offset_to_pointer (text, offset) - text;
+}
+
+static int
+gtk_text_layout_index_to_offset (GtkText    *self,
+                                 const char *text,
+                                 int         index)
+{
+  GtkTextPrivate *priv = gtk_text_get_instance_private (self);
+
+  if (priv->visible && priv->preedit_length == 0)
+    return gtk_entry_buffer_get_char_offset (get_buffer (self), index);
+
+  return g_utf8_pointer_to_offset (text, text + index);
+}
+
 char *
 gtk_text_get_display_text (GtkText *self,
                            int      start_pos,
@@ -2115,8 +2145,8 @@ gtk_text_get_display_text (GtkText *self,
       return g_strdup ("");
   else if (priv->visible)
     {
-      start = g_utf8_offset_to_pointer (text, start_pos);
-      end = g_utf8_offset_to_pointer (start, end_pos - start_pos);
+      start = text + gtk_entry_buffer_get_byte_offset (get_buffer (self), start_pos);
+      end = text + gtk_entry_buffer_get_byte_offset (get_buffer (self), end_pos);
       return g_strndup (start, end - start);
     }
   else
@@ -2292,7 +2322,7 @@ gtk_text_get_selection_bound_location (GtkText *self)
 
   layout = gtk_text_ensure_layout (self, FALSE);
   text = pango_layout_get_text (layout);
-  index = g_utf8_offset_to_pointer (text, priv->selection_bound) - text;
+  index = gtk_text_layout_offset_to_index (self, text, priv->selection_bound);
   pango_layout_index_to_pos (layout, index, &pos);
 
   if (gtk_widget_get_direction (GTK_WIDGET (self)) == GTK_TEXT_DIR_RTL)
@@ -2586,8 +2616,8 @@ gtk_text_get_pixel_ranges (GtkText  *self,
       PangoLayout *layout = gtk_text_ensure_layout (self, TRUE);
       PangoLayoutLine *line = pango_layout_get_lines_readonly (layout)->data;
       const char *text = pango_layout_get_text (layout);
-      int start_index = g_utf8_offset_to_pointer (text, priv->selection_bound) - text;
-      int end_index = g_utf8_offset_to_pointer (text, priv->current_pos) - text;
+      int start_index = gtk_text_layout_offset_to_index (self, text, priv->selection_bound);
+      int end_index = gtk_text_layout_offset_to_index (self, text, priv->current_pos);
       int real_n_ranges, i;
 
       pango_layout_line_get_x_ranges (line,
@@ -2883,8 +2913,8 @@ _gtk_text_get_selected_text (GtkText *self)
       const int start = MIN (priv->selection_bound, priv->current_pos);
       const int end = MAX (priv->selection_bound, priv->current_pos);
       const char *text = gtk_entry_buffer_get_text (get_buffer (self));
-      const int start_index = g_utf8_offset_to_pointer (text, start) - text;
-      const int end_index = g_utf8_offset_to_pointer (text, end) - text;
+      const int start_index = gtk_entry_buffer_get_byte_offset (get_buffer (self), start);
+      const int end_index = gtk_entry_buffer_get_byte_offset (get_buffer (self), end);
 
       return g_strndup (text + start_index, end_index - start_index);
     }
@@ -3743,7 +3773,7 @@ get_better_cursor_x (GtkText *self,
   gboolean split_cursor;
   PangoLayout *layout = gtk_text_ensure_layout (self, TRUE);
   const char *text = pango_layout_get_text (layout);
-  int index = g_utf8_offset_to_pointer (text, offset) - text;
+  int index = gtk_text_layout_offset_to_index (self, text, offset);
   PangoRectangle strong_pos, weak_pos;
 
   seat = gdk_display_get_default_seat (gtk_widget_get_display (GTK_WIDGET (self)));
@@ -4281,8 +4311,8 @@ gtk_text_retrieve_surrounding_cb (GtkIMContext *context,
   /* XXXX ??? does this even make sense when text is not visible? Should we return FALSE? */
   text = gtk_text_get_display_text (self, 0, -1);
   gtk_im_context_set_surrounding_with_selection (context, text, strlen (text), /* Length in bytes */
-                                                 g_utf8_offset_to_pointer (text, priv->current_pos) - text,
-                                                 g_utf8_offset_to_pointer (text, priv->selection_bound) - text);
+                                                 gtk_text_layout_offset_to_index (self, text, priv->current_pos),
+                                                 gtk_text_layout_offset_to_index (self, text, priv->selection_bound));
   g_free (text);
 
   return TRUE;
@@ -4445,7 +4475,7 @@ gtk_text_create_layout (GtkText  *self,
   layout = gtk_widget_create_pango_layout (widget, NULL);
   pango_layout_set_single_paragraph_mode (layout, TRUE);
 
-  tmp_attrs = gtk_css_style_get_pango_attributes (gtk_css_node_get_style (gtk_widget_get_css_node (widget)));
+  tmp_attrs = pango_attr_list_copy (gtk_css_style_get_pango_attributes (gtk_css_node_get_style (gtk_widget_get_css_node (widget))));
   if (!tmp_attrs)
     tmp_attrs = pango_attr_list_new ();
   tmp_attrs = _gtk_pango_attr_list_merge (tmp_attrs, priv->attrs);
@@ -4620,8 +4650,8 @@ gtk_text_draw_text (GtkText     *self,
   if (priv->selection_bound != priv->current_pos)
     {
       const char *text = pango_layout_get_text (layout);
-      int start_index = g_utf8_offset_to_pointer (text, priv->selection_bound) - text;
-      int end_index = g_utf8_offset_to_pointer (text, priv->current_pos) - text;
+      int start_index = gtk_text_layout_offset_to_index (self, text, priv->selection_bound);
+      int end_index = gtk_text_layout_offset_to_index (self, text, priv->current_pos);
       cairo_region_t *clip;
       cairo_rectangle_int_t clip_extents;
       int range[2];
@@ -4672,9 +4702,9 @@ gtk_text_draw_cursor (GtkText     *self,
   gtk_text_get_layout_offsets (self, &x, &y);
 
   if (type == CURSOR_DND)
-    cursor_index = g_utf8_offset_to_pointer (text, priv->dnd_position) - text;
+    cursor_index = gtk_text_layout_offset_to_index (self, text, priv->dnd_position);
   else
-    cursor_index = g_utf8_offset_to_pointer (text, priv->current_pos + priv->preedit_cursor) - text;
+    cursor_index = gtk_text_layout_offset_to_index (self, text, priv->current_pos + priv->preedit_cursor);
 
   if (!priv->overwrite_mode)
     block = FALSE;
@@ -4845,7 +4875,7 @@ gtk_text_find_position (GtkText *self,
 
   layout = gtk_text_ensure_layout (self, TRUE);
   text = pango_layout_get_text (layout);
-  cursor_index = g_utf8_offset_to_pointer (text, priv->current_pos) - text;
+  cursor_index = gtk_text_layout_offset_to_index (self, text, priv->current_pos);
 
   line = pango_layout_get_lines_readonly (layout)->data;
   pango_layout_line_x_to_index (line, x * PANGO_SCALE, &index, &trailing);
@@ -4861,7 +4891,7 @@ gtk_text_find_position (GtkText *self,
         }
     }
 
-  pos = g_utf8_pointer_to_offset (text, text + index);
+  pos = gtk_text_layout_index_to_offset (self, text, index);
   pos += trailing;
 
   return pos;
@@ -4891,7 +4921,7 @@ gtk_text_get_cursor_locations (GtkText   *self,
       PangoRectangle strong_pos, weak_pos;
       int index;
 
-      index = g_utf8_offset_to_pointer (text, priv->current_pos + priv->preedit_cursor) - text;
+      index = gtk_text_layout_offset_to_index (self, text, priv->current_pos + priv->preedit_cursor);
 
       pango_layout_get_cursor_pos (layout, index, &strong_pos, &weak_pos);
 
@@ -5043,7 +5073,7 @@ gtk_text_move_visually (GtkText *self,
 
   text = pango_layout_get_text (layout);
 
-  index = g_utf8_offset_to_pointer (text, start) - text;
+  index = gtk_text_layout_offset_to_index (self, text, start);
 
 
   g_object_get (gtk_widget_get_settings (GTK_WIDGET (self)),
@@ -5093,7 +5123,7 @@ gtk_text_move_visually (GtkText *self,
         index = g_utf8_next_char (text + index) - text;
     }
 
-  return g_utf8_pointer_to_offset (text, text + index);
+  return gtk_text_layout_index_to_offset (self, text, index);
 }
 
 static int
@@ -7158,7 +7188,7 @@ gtk_text_compute_cursor_extents (GtkText         *self,
   layout = gtk_text_ensure_layout (self, TRUE);
   text = pango_layout_get_text (layout);
   position = CLAMP (position, 0, g_utf8_strlen (text, -1));
-  index = g_utf8_offset_to_pointer (text, position) - text;
+  index = gtk_text_layout_offset_to_index (self, text, position);
 
   pango_layout_get_cursor_pos (layout, index,
                                strong ? &pango_strong_pos : NULL,
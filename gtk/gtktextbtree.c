@@ -209,8 +209,22 @@ struct _GtkTextBTree {
   guint end_iter_segment_stamp;
 
   GHashTable *child_anchor_table;
+
+  /* While tagging in a batch, the ranges to relayout and redraw
+   * at the end, as TagBatchRanges in the order they were tagged.
+   */
+  guint tag_batch_depth;
+  GArray *tag_batch_invalidate;
+  GArray *tag_batch_redisplay;
 };
 
+/* A range of character offsets */
+typedef struct
+{
+  int start;
+  int end;
+} TagBatchRange;
+
 
 /*
  * Upper and lower bounds on how many children a node may have:
@@ -426,6 +440,9 @@ _gtk_text_btree_new (GtkTextTagTable *table,
   tree->mark_table = g_hash_table_new (g_str_hash, g_str_equal);
   tree->child_anchor_table = NULL;
 
+  tree->tag_batch_invalidate = g_array_new (FALSE, FALSE, sizeof (TagBatchRange));
+  tree->tag_batch_redisplay = g_array_new (FALSE, FALSE, sizeof (TagBatchRange));
+
   /* We don't ref the buffer, since the buffer owns us;
    * we'd have some circularity issues. The buffer always
    * lasts longer than the BTree
@@ -513,6 +530,9 @@ _gtk_text_btree_unref (GtkTextBTree *tree)
       g_object_unref (tree->selection_bound_mark);
       tree->selection_bound_mark = NULL;
 
+      g_array_unref (tree->tag_batch_invalidate);
+      g_array_unref (tree->tag_batch_redisplay);
+
       g_slice_free (GtkTextBTree, tree);
     }
 }
@@ -1244,6 +1264,210 @@ _gtk_text_btree_insert (GtkTextIter *iter,
   }
 }
 
+struct _GtkTextLineBuilder
+{
+  GtkTextLine *first;           /* its segments go into the line of the iter */
+  GtkTextLine *last;            /* line that text is appended to */
+  GtkTextLineSegment *last_seg; /* last segment of @last, or %NULL */
+  int line_count;               /* number of paragraph delimiters */
+  int char_count;
+};
+
+/**
+ * _gtk_text_line_builder_new:
+ *
+ * Creates a builder for inserting a large amount of text with
+ * _gtk_text_btree_insert_lines(). Unlike the tree, a builder
+ * doesn't reference anything, so it can be filled in a thread.
+ *
+ * Returns: a new `GtkTextLineBuilder`
+ **/
+GtkTextLineBuilder *
+_gtk_text_line_builder_new (void)
+{
+  GtkTextLineBuilder *builder;
+
+  builder = g_new0 (GtkTextLineBuilder, 1);
+  builder->first = gtk_text_line_new ();
+  builder->last = builder->first;
+
+  return builder;
+}
+
+void
+_gtk_text_line_builder_free (GtkTextLineBuilder *builder)
+{
+  GtkTextLine *line, *next;
+
+  for (line = builder->first; line; line = next)
+    {
+      GtkTextLineSegment *seg, *next_seg;
+
+      next = line->next;
+
+      for (seg = line->segments; seg; seg = next_seg)
+        {
+          next_seg = seg->next;
+          (*seg->type->deleteFunc) (seg, line, TRUE);
+        }
+
+      g_slice_free (GtkTextLine, line);
+    }
+
+  g_free (builder);
+}
+
+/**
+ * _gtk_text_line_builder_append:
+ * @builder: a `GtkTextLineBuilder`
+ * @text: valid UTF-8 text
+ * @len: length of @text in bytes
+ *
+ * Appends @text to the lines in @builder. The text may be split
+ * into several calls at any character boundary, except between
+ * the \r and \n of a paragraph delimiter.
+ **/
+void
+_gtk_text_line_builder_append (GtkTextLineBuilder *builder,
+                               const char         *text,
+                               int                 len)
+{
+  GtkTextLineSegment *seg;
+  GtkTextLine *newline;
+  int sol, eol, delim;
+
+  if (len < 0)
+    len = strlen (text);
+
+  eol = 0;
+  while (eol < len)
+    {
+      sol = eol;
+
+      pango_find_paragraph_boundary (text + sol, len - sol, &delim, &eol);
+
+      /* make these relative to the start of the text */
+      delim += sol;
+      eol += sol;
+
+      g_assert (g_utf8_validate (&text[sol], eol - sol, NULL));
+      seg = _gtk_char_segment_new (&text[sol], eol - sol);
+      builder->char_count += seg->char_count;
+
+      if (builder->last_seg)
+        builder->last_seg->next = seg;
+      else
+        builder->last->segments = seg;
+      builder->last_seg = seg;
+
+      if (delim == eol)
+        {
+          /* chunk didn't end with a paragraph separator */
+          g_assert (eol == len);
+          break;
+        }
+
+      newline = gtk_text_line_new ();
+      builder->last->next = newline;
+      builder->last = newline;
+      builder->last_seg = NULL;
+      builder->line_count++;
+    }
+}
+
+/**
+ * _gtk_text_btree_insert_lines:
+ * @iter: the position to insert at
+ * @builder: a `GtkTextLineBuilder` with the text to insert
+ *
+ * Moves the lines of @builder into the tree at @iter, as if the
+ * text had been passed to _gtk_text_btree_insert(). The tree is
+ * rebalanced and the views are invalidated only once, no matter
+ * how many lines are inserted.
+ *
+ * @builder is empty afterwards and @iter points to the end of the
+ * inserted text.
+ **/
+void
+_gtk_text_btree_insert_lines (GtkTextIter        *iter,
+                              GtkTextLineBuilder *builder)
+{
+  GtkTextLineSegment *prev_seg;
+  GtkTextLineSegment *rest;
+  GtkTextLine *line, *end_line, *l;
+  GtkTextBTree *tree;
+  int start_byte_index;
+  int char_count;
+
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (builder != NULL);
+
+  tree = _gtk_text_iter_get_btree (iter);
+  line = _gtk_text_iter_get_text_line (iter);
+  start_byte_index = gtk_text_iter_get_line_index (iter);
+  char_count = builder->char_count;
+
+  g_assert (!_gtk_text_line_is_last (line, tree));
+  prev_seg = gtk_text_line_segment_split (iter);
+
+  /* Invalidate all iterators */
+  chars_changed (tree);
+  segments_changed (tree);
+
+  /* The rest of the line goes to the end of the new text */
+  rest = prev_seg ? prev_seg->next : line->segments;
+  if (builder->last_seg)
+    builder->last_seg->next = rest;
+  else
+    builder->last->segments = rest;
+
+  if (prev_seg)
+    prev_seg->next = builder->first->segments;
+  else
+    line->segments = builder->first->segments;
+
+  end_line = line;
+  if (builder->first != builder->last)
+    {
+      builder->last->next = line->next;
+      line->next = builder->first->next;
+      end_line = builder->last;
+
+      for (l = line->next; l != end_line->next; l = l->next)
+        gtk_text_line_set_parent (l, line->parent);
+    }
+
+  g_slice_free (GtkTextLine, builder->first);
+
+  cleanup_line (line);
+  if (end_line != line)
+    cleanup_line (end_line);
+
+  post_insert_fixup (tree, end_line, builder->line_count, char_count);
+
+  builder->first = gtk_text_line_new ();
+  builder->last = builder->first;
+  builder->last_seg = NULL;
+  builder->line_count = 0;
+  builder->char_count = 0;
+
+  {
+    GtkTextIter start;
+    GtkTextIter end;
+
+    _gtk_text_btree_get_iter_at_line (tree, &start, line, start_byte_index);
+    end = start;
+    gtk_text_iter_forward_chars (&end, char_count);
+
+    DV (g_print ("invalidating due to inserting lines (%s)\n", G_STRLOC));
+    _gtk_text_btree_invalidate_region (tree, &start, &end, FALSE);
+
+    *iter = end;
+
+    gtk_text_btree_resolve_bidi (&start, &end);
+  }
+}
+
 static void
 insert_paintable_or_widget_segment (GtkTextIter        *iter,
                                     GtkTextLineSegment *seg)
@@ -1567,6 +1791,7 @@ _gtk_text_btree_add_view (GtkTextBTree *tree,
   line_data->width = 0;
   line_data->height = 0;
   line_data->valid = TRUE;
+  line_data->estimated = FALSE;
 
   _gtk_text_line_add_data (last_line, line_data);
 }
@@ -1728,12 +1953,90 @@ iter_stack_invert (IterStack *stack)
     }
 }
 
+/* Adds the range from @start to @end to @ranges. Ranges are usually
+ * tagged in order, so overlapping the last one is merged right away,
+ * everything else is sorted out by tag_batch_merge_ranges().
+ */
+static void
+tag_batch_add_range (GArray            *ranges,
+                     const GtkTextIter *start,
+                     const GtkTextIter *end)
+{
+  TagBatchRange range;
+
+  range.start = gtk_text_iter_get_offset (start);
+  range.end = gtk_text_iter_get_offset (end);
+
+  if (ranges->len > 0)
+    {
+      TagBatchRange *last = &g_array_index (ranges, TagBatchRange, ranges->len - 1);
+
+      if (last->start <= range.start && range.start <= last->end)
+        {
+          last->end = MAX (last->end, range.end);
+          return;
+        }
+    }
+
+  g_array_append_val (ranges, range);
+}
+
+static int
+tag_batch_range_compare (gconstpointer a,
+                         gconstpointer b)
+{
+  const TagBatchRange *ra = a;
+  const TagBatchRange *rb = b;
+
+  if (ra->start != rb->start)
+    return ra->start < rb->start ? -1 : 1;
+
+  return 0;
+}
+
+/* Sorts @ranges and merges the ones that overlap or touch, so
+ * that they are disjoint.
+ */
+static void
+tag_batch_merge_ranges (GArray *ranges)
+{
+  guint i, n;
+
+  if (ranges->len < 2)
+    return;
+
+  g_array_sort (ranges, tag_batch_range_compare);
+
+  n = 0;
+  for (i = 1; i < ranges->len; i++)
+    {
+      TagBatchRange *last = &g_array_index (ranges, TagBatchRange, n);
+      const TagBatchRange *range = &g_array_index (ranges, TagBatchRange, i);
+
+      if (range->start <= last->end)
+        last->end = MAX (last->end, range->end);
+      else
+        g_array_index (ranges, TagBatchRange, ++n) = *range;
+    }
+
+  g_array_set_size (ranges, n + 1);
+}
+
 static void
 queue_tag_redisplay (GtkTextBTree      *tree,
                      GtkTextTag        *tag,
                      const GtkTextIter *start,
                      const GtkTextIter *end)
 {
+  if (tree->tag_batch_depth > 0)
+    {
+      if (_gtk_text_tag_affects_size (tag))
+        tag_batch_add_range (tree->tag_batch_invalidate, start, end);
+      else if (_gtk_text_tag_affects_nonsize_appearance (tag))
+        tag_batch_add_range (tree->tag_batch_redisplay, start, end);
+      return;
+    }
+
   if (_gtk_text_tag_affects_size (tag))
     {
       DV (g_print ("invalidating due to size-affecting tag (%s)\n", G_STRLOC));
@@ -2007,6 +2310,62 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
 #endif
 }
 
+/**
+ * _gtk_text_btree_begin_tag_batch:
+ * @tree: a `GtkTextBTree`
+ *
+ * Starts applying or removing many tags at once. Until the matching
+ * _gtk_text_btree_end_tag_batch(), tagging does not relayout or redraw
+ * anything, which then happens once for all the tagged ranges.
+ *
+ * The text must not be changed while tagging in a batch.
+ **/
+void
+_gtk_text_btree_begin_tag_batch (GtkTextBTree *tree)
+{
+  tree->tag_batch_depth++;
+}
+
+/**
+ * _gtk_text_btree_end_tag_batch:
+ * @tree: a `GtkTextBTree`
+ *
+ * Ends a batch started with _gtk_text_btree_begin_tag_batch().
+ **/
+void
+_gtk_text_btree_end_tag_batch (GtkTextBTree *tree)
+{
+  GtkTextIter start, end;
+  guint i;
+
+  g_return_if_fail (tree->tag_batch_depth > 0);
+
+  if (--tree->tag_batch_depth > 0)
+    return;
+
+  tag_batch_merge_ranges (tree->tag_batch_invalidate);
+  tag_batch_merge_ranges (tree->tag_batch_redisplay);
+
+  for (i = 0; i < tree->tag_batch_invalidate->len; i++)
+    {
+      const TagBatchRange *range = &g_array_index (tree->tag_batch_invalidate, TagBatchRange, i);
+
+      _gtk_text_btree_get_iter_at_char (tree, &start, range->start);
+      _gtk_text_btree_get_iter_at_char (tree, &end, range->end);
+      _gtk_text_btree_invalidate_region (tree, &start, &end, FALSE);
+    }
+  g_array_set_size (tree->tag_batch_invalidate, 0);
+
+  for (i = 0; i < tree->tag_batch_redisplay->len; i++)
+    {
+      const TagBatchRange *range = &g_array_index (tree->tag_batch_redisplay, TagBatchRange, i);
+
+      _gtk_text_btree_get_iter_at_char (tree, &start, range->start);
+      _gtk_text_btree_get_iter_at_char (tree, &end, range->end);
+      redisplay_region (tree, &start, &end, FALSE);
+    }
+  g_array_set_size (tree->tag_batch_redisplay, 0);
+}
 
 /*
  * "Getters"
@@ -3622,6 +3981,7 @@ _gtk_text_line_data_new (GtkTextLayout *layout,
   line_data->top_ink = 0;
   line_data->bottom_ink = 0;
   line_data->valid = FALSE;
+  line_data->estimated = FALSE;
 
   return line_data;
 }
@@ -5441,13 +5801,87 @@ _gtk_text_btree_validate_line (GtkTextBTree     *tree,
   g_return_if_fail (view != NULL);
 
   ld = _gtk_text_line_get_data (line, view_id);
-  if (!ld || !ld->valid)
+  if (!ld || !ld->valid || ld->estimated)
     {
       gtk_text_layout_wrap (view->layout, line, ld);
       gtk_text_btree_node_check_valid_upward (line->parent, view_id);
     }
 }
 
+/**
+ * _gtk_text_btree_get_first_invalid_line:
+ * @tree: a GtkTextBTree
+ * @view_id: view ID of the view
+ *
+ * Finds the first line that has not been validated for the given
+ * view, using the validity stored in the nodes to skip valid parts
+ * of the tree.
+ *
+ * Returns: the first invalid line or %NULL if the tree is valid
+ **/
+GtkTextLine *
+_gtk_text_btree_get_first_invalid_line (GtkTextBTree *tree,
+                                        gpointer      view_id)
+{
+  GtkTextBTreeNode *node;
+  GtkTextLine *line;
+  NodeData *nd;
+
+  g_return_val_if_fail (tree != NULL, NULL);
+
+  node = tree->root_node;
+  nd = node_data_find (node->node_data, view_id);
+  if (nd && nd->valid)
+    return NULL;
+
+  while (node->level > 0)
+    {
+      GtkTextBTreeNode *child;
+
+      for (child = node->children.node; child; child = child->next)
+        {
+          nd = node_data_find (child->node_data, view_id);
+          if (!nd || !nd->valid)
+            break;
+        }
+
+      if (child == NULL)
+        return NULL;
+
+      node = child;
+    }
+
+  for (line = node->children.line; line; line = line->next)
+    {
+      GtkTextLineData *ld = _gtk_text_line_get_data (line, view_id);
+
+      if (!ld || !ld->valid)
+        return line;
+    }
+
+  return NULL;
+}
+
+/**
+ * _gtk_text_btree_line_data_changed:
+ * @tree: a GtkTextBTree
+ * @line: a line whose data for @view_id was changed
+ * @view_id: view ID of the view
+ *
+ * Recomputes the size and validity of the nodes containing @line
+ * after its line data was changed by the view.
+ **/
+void
+_gtk_text_btree_line_data_changed (GtkTextBTree *tree,
+                                   GtkTextLine  *line,
+                                   gpointer      view_id)
+{
+  g_return_if_fail (tree != NULL);
+  g_return_if_fail (line != NULL);
+
+  gtk_text_btree_node_check_valid_upward (line->parent, view_id);
+}
+
 static void
 gtk_text_btree_node_remove_view (BTreeView *view, GtkTextBTreeNode *node, gpointer view_id)
 {
@@ -71,6 +71,17 @@ void _gtk_text_btree_insert           (GtkTextIter  *iter,
 void _gtk_text_btree_insert_paintable (GtkTextIter  *iter,
                                        GdkPaintable *texture);
 
+/* Lines built without a tree, possibly in a thread, for bulk insertion */
+typedef struct _GtkTextLineBuilder GtkTextLineBuilder;
+
+GtkTextLineBuilder *_gtk_text_line_builder_new    (void);
+void                _gtk_text_line_builder_free   (GtkTextLineBuilder *builder);
+void                _gtk_text_line_builder_append (GtkTextLineBuilder *builder,
+                                                   const char         *text,
+                                                   int                 len);
+void                _gtk_text_btree_insert_lines  (GtkTextIter        *iter,
+                                                   GtkTextLineBuilder *builder);
+
 void _gtk_text_btree_insert_child_anchor (GtkTextIter        *iter,
                                           GtkTextChildAnchor *anchor);
 
@@ -107,6 +118,11 @@ gboolean     _gtk_text_btree_validate          (GtkTextBTree      *tree,
 void         _gtk_text_btree_validate_line     (GtkTextBTree      *tree,
                                                 GtkTextLine       *line,
                                                 gpointer           view_id);
+GtkTextLine *_gtk_text_btree_get_first_invalid_line (GtkTextBTree *tree,
+                                                     gpointer      view_id);
+void         _gtk_text_btree_line_data_changed (GtkTextBTree      *tree,
+                                                GtkTextLine       *line,
+                                                gpointer           view_id);
 
 /* Tag */
 
@@ -114,6 +130,8 @@ void _gtk_text_btree_tag (const GtkTextIter *start,
                           const GtkTextIter *end,
                           GtkTextTag        *tag,
                           gboolean           apply);
+void _gtk_text_btree_begin_tag_batch (GtkTextBTree *tree);
+void _gtk_text_btree_end_tag_batch   (GtkTextBTree *tree);
 
 /* "Getters" */
 
@@ -225,7 +243,8 @@ struct _GtkTextLineData {
   int top_ink : 16;
   int bottom_ink : 16;
   signed int width : 24;
-  guint valid : 8;		/* Actually a boolean */
+  guint valid : 1;
+  guint estimated : 1;		/* size was measured without tags */
 };
 
 /*
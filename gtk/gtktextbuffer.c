@@ -24,6 +24,7 @@
  */
 
 #include "config.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 
@@ -71,6 +72,11 @@ struct _GtkTextBufferPrivate
 
   guint user_action_count;
 
+  /* Lines prepared by gtk_text_buffer_load_async() for inserting
+   * @load_text in the default handler of ::insert-text */
+  GtkTextLineBuilder *load_builder;
+  const char *load_text;
+
   /* Whether the buffer has been modified since last save */
   guint modified : 1;
   guint has_selection : 1;
@@ -1178,6 +1184,798 @@ gtk_text_buffer_set_text (GtkTextBuffer *buffer,
   gtk_text_history_end_irreversible_action (buffer->priv->history);
 }
 
+#define LOAD_CHUNK_SIZE (64 * 1024)
+
+typedef struct
+{
+  GInputStream *stream;
+  GtkTextLineBuilder *builder;
+  GString *text;
+  GFileProgressCallback progress_callback;
+  gpointer progress_data;
+  GDestroyNotify progress_data_destroy;
+} LoadData;
+
+typedef struct
+{
+  GTask *task;
+  goffset current;
+  goffset total;
+} LoadProgress;
+
+/* Called on the main thread once the stream is read, so that the
+ * data is released on the thread it was passed in.
+ */
+static void
+load_data_clear_progress (LoadData *load)
+{
+  GDestroyNotify destroy = load->progress_data_destroy;
+
+  load->progress_callback = NULL;
+  load->progress_data_destroy = NULL;
+  if (destroy)
+    destroy (load->progress_data);
+  load->progress_data = NULL;
+}
+
+static void
+load_data_free (gpointer data)
+{
+  LoadData *load = data;
+
+  g_object_unref (load->stream);
+  g_clear_pointer (&load->builder, _gtk_text_line_builder_free);
+  if (load->text)
+    g_string_free (load->text, TRUE);
+  load_data_clear_progress (load);
+
+  g_free (load);
+}
+
+static gboolean
+load_progress_cb (gpointer data)
+{
+  LoadProgress *progress = data;
+  LoadData *load = g_task_get_task_data (progress->task);
+
+  /* Progress may still be queued after loading is done */
+  if (load->progress_callback)
+    load->progress_callback (progress->current, progress->total, load->progress_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+load_progress_free (gpointer data)
+{
+  LoadProgress *progress = data;
+
+  g_object_unref (progress->task);
+  g_free (progress);
+}
+
+static void
+load_report_progress (GTask   *task,
+                      goffset  current,
+                      goffset  total)
+{
+  LoadData *load = g_task_get_task_data (task);
+  LoadProgress *progress;
+
+  if (load->progress_callback == NULL)
+    return;
+
+  progress = g_new (LoadProgress, 1);
+  progress->task = g_object_ref (task);
+  progress->current = current;
+  progress->total = total;
+
+  g_main_context_invoke_full (g_task_get_context (task),
+                              g_task_get_priority (task),
+                              load_progress_cb,
+                              progress,
+                              load_progress_free);
+}
+
+/* Reads the stream and splits it into lines, so that the main
+ * thread only needs to link the lines into the tree.
+ */
+static void
+load_thread (GTask        *task,
+             gpointer      source_object,
+             gpointer      task_data,
+             GCancellable *cancellable)
+{
+  LoadData *load = task_data;
+  GError *error = NULL;
+  goffset total, current;
+  gsize n_carry;
+  char *buffer;
+
+  total = 0;
+  if (G_IS_FILE_INPUT_STREAM (load->stream))
+    {
+      GFileInfo *info;
+
+      info = g_file_input_stream_query_info (G_FILE_INPUT_STREAM (load->stream),
+                                             G_FILE_ATTRIBUTE_STANDARD_SIZE,
+                                             cancellable,
+                                             NULL);
+      if (info)
+        {
+          total = g_file_info_get_size (info);
+          g_object_unref (info);
+        }
+    }
+
+  buffer = g_malloc (LOAD_CHUNK_SIZE);
+  current = 0;
+  n_carry = 0;
+
+  while (TRUE)
+    {
+      const char *valid_end;
+      gssize n_read;
+      gsize len, n_valid;
+
+      n_read = g_input_stream_read (load->stream,
+                                    buffer + n_carry,
+                                    LOAD_CHUNK_SIZE - n_carry,
+                                    cancellable,
+                                    &error);
+      if (n_read < 0)
+        goto out;
+
+      len = n_carry + n_read;
+      g_utf8_validate (buffer, len, &valid_end);
+      n_valid = valid_end - buffer;
+
+      /* A character may be split between two reads */
+      if (n_valid < len && (n_read == 0 || len - n_valid >= 4))
+        {
+          g_set_error (&error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                       _("Invalid UTF-8 data at offset %" G_GOFFSET_FORMAT),
+                       current - n_carry + n_valid);
+          goto out;
+        }
+
+      /* So may be a \r\n paragraph delimiter */
+      if (n_read > 0 && n_valid > 0 && buffer[n_valid - 1] == '\r')
+        n_valid--;
+
+      _gtk_text_line_builder_append (load->builder, buffer, n_valid);
+      g_string_append_len (load->text, buffer, n_valid);
+
+      n_carry = len - n_valid;
+      memmove (buffer, buffer + n_valid, n_carry);
+
+      if (n_read == 0)
+        break;
+
+      current += n_read;
+      load_report_progress (task, current, MAX (total, current));
+    }
+
+out:
+  g_free (buffer);
+
+  if (error)
+    g_task_return_error (task, error);
+  else
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+load_thread_done (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      data)
+{
+  GtkTextBuffer *buffer = GTK_TEXT_BUFFER (source);
+  GtkTextBufferPrivate *priv = buffer->priv;
+  GTask *task = data;
+  LoadData *load;
+  GtkTextIter start, end;
+  GError *error = NULL;
+
+  load = g_task_get_task_data (G_TASK (result));
+  load_data_clear_progress (load);
+
+  if (!g_task_propagate_boolean (G_TASK (result), &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  gtk_text_history_begin_irreversible_action (priv->history);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  gtk_text_buffer_delete (buffer, &start, &end);
+
+  if (load->text->len > 0)
+    {
+      /* The text was validated in the thread already, so emit
+       * the signal directly instead of gtk_text_buffer_insert().
+       */
+      priv->load_builder = load->builder;
+      priv->load_text = load->text->str;
+
+      gtk_text_buffer_get_start_iter (buffer, &start);
+      g_signal_emit (buffer, signals[INSERT_TEXT], 0,
+                     &start, load->text->str, (int) load->text->len);
+
+      /* The default handler takes the lines, unless it didn't run */
+      if (priv->load_builder == NULL)
+        load->builder = NULL;
+      priv->load_builder = NULL;
+      priv->load_text = NULL;
+    }
+
+  gtk_text_history_end_irreversible_action (priv->history);
+
+  g_task_return_boolean (task, TRUE);
+  g_object_unref (task);
+}
+
+/**
+ * gtk_text_buffer_load_async:
+ * @buffer: a `GtkTextBuffer`
+ * @stream: a `GInputStream` to read UTF-8 text from
+ * @io_priority: the I/O priority of the request
+ * @cancellable: (nullable): optional `GCancellable` object
+ * @progress_callback: (nullable) (scope notified): function to call
+ *   with the number of bytes read so far
+ * @progress_data: (closure progress_callback): data to pass to @progress_callback
+ * @progress_data_destroy: (nullable): destroy notify for @progress_data
+ * @callback: (scope async): callback to call when the text is loaded
+ * @user_data: (closure callback): data to pass to @callback
+ *
+ * Replaces the contents of @buffer with the text read from @stream.
+ *
+ * The stream is read in a thread, where the text is also split into
+ * lines, so that the buffer only needs to be updated once at the
+ * end. This is a lot faster than inserting a large document in
+ * chunks. The “insert-text” signal is emitted once for the whole text,
+ * and loading the text can't be undone, just like with
+ * [method@Gtk.TextBuffer.set_text].
+ *
+ * The total number of bytes passed to @progress_callback is only
+ * known if @stream is a `GFileInputStream`.
+ *
+ * The buffer must not be modified from other threads while loading.
+ *
+ * Since: 4.8
+ */
+void
+gtk_text_buffer_load_async (GtkTextBuffer         *buffer,
+                            GInputStream          *stream,
+                            int                    io_priority,
+                            GCancellable          *cancellable,
+                            GFileProgressCallback  progress_callback,
+                            gpointer               progress_data,
+                            GDestroyNotify         progress_data_destroy,
+                            GAsyncReadyCallback    callback,
+                            gpointer               user_data)
+{
+  GTask *task, *thread_task;
+  LoadData *load;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  task = g_task_new (buffer, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_text_buffer_load_async);
+
+  load = g_new0 (LoadData, 1);
+  load->stream = g_object_ref (stream);
+  load->builder = _gtk_text_line_builder_new ();
+  load->text = g_string_new (NULL);
+  load->progress_callback = progress_callback;
+  load->progress_data = progress_data;
+  load->progress_data_destroy = progress_data_destroy;
+
+  thread_task = g_task_new (buffer, cancellable, load_thread_done, task);
+  g_task_set_source_tag (thread_task, gtk_text_buffer_load_async);
+  g_task_set_priority (thread_task, io_priority);
+  g_task_set_task_data (thread_task, load, load_data_free);
+  g_task_run_in_thread (thread_task, load_thread);
+  g_object_unref (thread_task);
+}
+
+/**
+ * gtk_text_buffer_load_finish:
+ * @buffer: a `GtkTextBuffer`
+ * @result: a `GAsyncResult`
+ * @error: return location for an error
+ *
+ * Finishes an operation started with [method@Gtk.TextBuffer.load_async].
+ *
+ * Returns: %TRUE if the text was loaded
+ *
+ * Since: 4.8
+ */
+gboolean
+gtk_text_buffer_load_finish (GtkTextBuffer  *buffer,
+                             GAsyncResult   *result,
+                             GError        **error)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, buffer), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gtk_text_buffer_load_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/* Number of matches that are collected before handing them
+ * to the main thread */
+#define SEARCH_BATCH_SIZE 1024
+
+typedef struct
+{
+  GRegex *regex;
+  /* Set if the pattern is plain text, then memchr() does the work */
+  char *literal;
+  gsize literal_len;
+  GtkTextBufferSearchFunc match_func;
+  gpointer match_data;
+  GDestroyNotify match_data_destroy;
+  guint chars_changed_stamp;
+  /* Cancelled when the user cancels or the search fails */
+  GCancellable *cancellable;
+  GCancellable *user_cancellable;
+  gulong cancelled_id;
+  guint n_running;
+  int n_batches;
+  GError *error;
+  guint done : 1;
+} SearchData;
+
+typedef struct
+{
+  GTask *task;
+  char *text;
+  int offset;
+  GArray *matches;
+} SearchChunk;
+
+typedef struct
+{
+  GTask *task;
+  GArray *matches;
+} SearchBatch;
+
+static void
+search_data_free (gpointer data)
+{
+  SearchData *search = data;
+
+  g_cancellable_disconnect (search->user_cancellable, search->cancelled_id);
+  g_clear_object (&search->user_cancellable);
+  g_object_unref (search->cancellable);
+  g_regex_unref (search->regex);
+  g_free (search->literal);
+  g_clear_error (&search->error);
+  if (search->match_data_destroy)
+    search->match_data_destroy (search->match_data);
+
+  g_free (search);
+}
+
+static void
+search_chunk_free (gpointer data)
+{
+  SearchChunk *chunk = data;
+
+  g_object_unref (chunk->task);
+  g_free (chunk->text);
+  g_array_unref (chunk->matches);
+
+  g_free (chunk);
+}
+
+static void
+search_cancelled_cb (GCancellable *cancellable,
+                     gpointer      data)
+{
+  SearchData *search = data;
+
+  g_cancellable_cancel (search->cancellable);
+}
+
+static void
+search_deliver_matches (GtkTextBuffer *buffer,
+                        SearchData    *search,
+                        GArray        *matches)
+{
+  guint i;
+
+  if (search->done || search->error || g_cancellable_is_cancelled (search->cancellable))
+    return;
+
+  for (i = 0; i < matches->len; i += 2)
+    {
+      GtkTextIter start, end;
+
+      /* The matches are only meaningful for the text we searched */
+      if (search->chars_changed_stamp != _gtk_text_btree_get_chars_changed_stamp (get_btree (buffer)))
+        {
+          g_set_error_literal (&search->error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                               _("The text was changed during the search"));
+          g_cancellable_cancel (search->cancellable);
+          return;
+        }
+
+      gtk_text_buffer_get_iter_at_offset (buffer, &start, g_array_index (matches, int, i));
+      gtk_text_buffer_get_iter_at_offset (buffer, &end, g_array_index (matches, int, i + 1));
+      search->match_func (buffer, &start, &end, search->match_data);
+
+      if (g_cancellable_is_cancelled (search->cancellable))
+        return;
+    }
+}
+
+static void
+search_maybe_finish (GTask *task)
+{
+  SearchData *search = g_task_get_task_data (task);
+
+  if (search->done ||
+      search->n_running > 0 ||
+      g_atomic_int_get (&search->n_batches) > 0)
+    return;
+
+  search->done = TRUE;
+
+  /* No more matches are reported, so release the data here on the
+   * main thread instead of wherever the task is finalized.
+   */
+  if (search->match_data_destroy)
+    {
+      GDestroyNotify destroy = search->match_data_destroy;
+
+      search->match_data_destroy = NULL;
+      destroy (search->match_data);
+    }
+  search->match_data = NULL;
+
+  if (search->error)
+    g_task_return_error (task, g_steal_pointer (&search->error));
+  else if (!g_task_return_error_if_cancelled (task))
+    g_task_return_boolean (task, TRUE);
+}
+
+static gboolean
+search_batch_cb (gpointer data)
+{
+  SearchBatch *batch = data;
+
+  search_deliver_matches (g_task_get_source_object (batch->task),
+                          g_task_get_task_data (batch->task),
+                          batch->matches);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+search_batch_free (gpointer data)
+{
+  SearchBatch *batch = data;
+  SearchData *search = g_task_get_task_data (batch->task);
+
+  g_atomic_int_dec_and_test (&search->n_batches);
+  search_maybe_finish (batch->task);
+
+  g_object_unref (batch->task);
+  g_array_unref (batch->matches);
+  g_free (batch);
+}
+
+/* Hands the matches found so far to the main thread */
+static void
+search_send_batch (SearchChunk *chunk)
+{
+  SearchData *search = g_task_get_task_data (chunk->task);
+  SearchBatch *batch;
+
+  batch = g_new (SearchBatch, 1);
+  batch->task = g_object_ref (chunk->task);
+  batch->matches = chunk->matches;
+  chunk->matches = g_array_sized_new (FALSE, FALSE, sizeof (int), 2 * SEARCH_BATCH_SIZE);
+
+  g_atomic_int_inc (&search->n_batches);
+  g_main_context_invoke_full (g_task_get_context (chunk->task),
+                              g_task_get_priority (chunk->task),
+                              search_batch_cb,
+                              batch,
+                              search_batch_free);
+}
+
+typedef struct
+{
+  gsize byte;
+  int offset;
+} SearchPosition;
+
+/* Matches are found in order, so converting them to character
+ * offsets only needs to walk the text between them.
+ */
+static int
+search_position_advance (SearchPosition *pos,
+                         const char     *text,
+                         gsize           byte)
+{
+  pos->offset += g_utf8_pointer_to_offset (text + pos->byte, text + byte);
+  pos->byte = byte;
+
+  return pos->offset;
+}
+
+static void
+search_add_match (SearchChunk    *chunk,
+                  SearchPosition *pos,
+                  gsize           start,
+                  gsize           end)
+{
+  int offsets[2];
+
+  offsets[0] = chunk->offset + search_position_advance (pos, chunk->text, start);
+  offsets[1] = chunk->offset + search_position_advance (pos, chunk->text, end);
+  g_array_append_vals (chunk->matches, offsets, 2);
+
+  if (chunk->matches->len >= 2 * SEARCH_BATCH_SIZE)
+    search_send_batch (chunk);
+}
+
+static void
+search_thread (GTask        *task,
+               gpointer      source_object,
+               gpointer      task_data,
+               GCancellable *cancellable)
+{
+  SearchChunk *chunk = task_data;
+  SearchData *search = g_task_get_task_data (chunk->task);
+  SearchPosition pos = { 0, 0 };
+  GError *error = NULL;
+  gsize len;
+
+  len = strlen (chunk->text);
+
+  if (search->literal)
+    {
+      const char *p = chunk->text;
+      const char *end = chunk->text + len;
+
+      while (end - p >= search->literal_len)
+        {
+          p = memchr (p, search->literal[0], end - p - search->literal_len + 1);
+          if (p == NULL)
+            break;
+
+          if (memcmp (p + 1, search->literal + 1, search->literal_len - 1) == 0)
+            {
+              search_add_match (chunk, &pos, p - chunk->text, p - chunk->text + search->literal_len);
+              p += search->literal_len;
+
+              if (g_task_return_error_if_cancelled (task))
+                return;
+            }
+          else
+            p++;
+        }
+    }
+  else
+    {
+      GMatchInfo *info;
+
+      g_regex_match_full (search->regex, chunk->text, len, 0,
+                          G_REGEX_MATCH_NOTEMPTY, &info, &error);
+      while (g_match_info_matches (info))
+        {
+          int start, end;
+
+          g_match_info_fetch_pos (info, 0, &start, &end);
+          search_add_match (chunk, &pos, start, end);
+
+          if (g_cancellable_is_cancelled (cancellable))
+            break;
+
+          g_match_info_next (info, &error);
+        }
+      g_match_info_free (info);
+
+      if (error)
+        {
+          g_task_return_error (task, error);
+          return;
+        }
+    }
+
+  if (!g_task_return_error_if_cancelled (task))
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+search_thread_done (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      data)
+{
+  GTask *task = data;
+  SearchData *search = g_task_get_task_data (task);
+  SearchChunk *chunk = g_task_get_task_data (G_TASK (result));
+  GError *error = NULL;
+
+  if (g_task_propagate_boolean (G_TASK (result), &error))
+    search_deliver_matches (GTK_TEXT_BUFFER (source), search, chunk->matches);
+  else if (search->error == NULL && !g_cancellable_is_cancelled (search->cancellable))
+    {
+      search->error = error;
+      g_cancellable_cancel (search->cancellable);
+    }
+  else
+    g_error_free (error);
+
+  search->n_running--;
+  search_maybe_finish (task);
+
+  g_object_unref (task);
+}
+
+/* Whether the regex matches exactly its pattern */
+static gboolean
+regex_is_literal (GRegex *regex)
+{
+  const GRegexCompileFlags allowed = G_REGEX_OPTIMIZE | G_REGEX_MULTILINE |
+                                     G_REGEX_DOTALL | G_REGEX_DOLLAR_ENDONLY |
+                                     G_REGEX_UNGREEDY | G_REGEX_NO_AUTO_CAPTURE;
+  const char *pattern = g_regex_get_pattern (regex);
+  char *escaped;
+  gboolean result;
+
+  if (g_regex_get_compile_flags (regex) & ~allowed ||
+      g_regex_get_match_flags (regex) != 0 ||
+      pattern[0] == '\0')
+    return FALSE;
+
+  escaped = g_regex_escape_string (pattern, -1);
+  result = strcmp (escaped, pattern) == 0;
+  g_free (escaped);
+
+  return result;
+}
+
+/**
+ * gtk_text_buffer_search_async:
+ * @buffer: a `GtkTextBuffer`
+ * @regex: the `GRegex` to search for
+ * @cancellable: (nullable): optional `GCancellable` object
+ * @match_func: (scope notified): function to call for each match
+ * @match_data: (closure match_func): data to pass to @match_func
+ * @match_data_destroy: (nullable): destroy notify for @match_data
+ * @callback: (scope async): callback to call when the search is done
+ * @user_data: (closure callback): data to pass to @callback
+ *
+ * Searches the text of @buffer for matches of @regex.
+ *
+ * The text is split into parts at line ends, which are searched in
+ * parallel in threads. The matches are passed to @match_func as they
+ * are found, so for example highlighting them can start before the
+ * search is done. Matches are reported in order within each part, but
+ * the parts may finish in any order. Matches can't span parts, so
+ * patterns should not match line ends.
+ *
+ * Patterns without special characters are searched for as plain text,
+ * which is a lot faster than using the regex engine.
+ *
+ * Paintables and child anchors are represented by the Unicode
+ * “object replacement character” 0xFFFC, as with
+ * [method@Gtk.TextBuffer.get_slice].
+ *
+ * The search fails with %G_IO_ERROR_FAILED if the text of @buffer is
+ * changed before it is done. Applying tags to the matches is fine.
+ *
+ * Since: 4.8
+ */
+void
+gtk_text_buffer_search_async (GtkTextBuffer           *buffer,
+                              GRegex                  *regex,
+                              GCancellable            *cancellable,
+                              GtkTextBufferSearchFunc  match_func,
+                              gpointer                 match_data,
+                              GDestroyNotify           match_data_destroy,
+                              GAsyncReadyCallback      callback,
+                              gpointer                 user_data)
+{
+  GTask *task;
+  SearchData *search;
+  int n_lines, n_chunks, i;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (regex != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+  g_return_if_fail (match_func != NULL);
+
+  task = g_task_new (buffer, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_text_buffer_search_async);
+
+  search = g_new0 (SearchData, 1);
+  search->regex = g_regex_ref (regex);
+  if (regex_is_literal (regex))
+    {
+      search->literal = g_strdup (g_regex_get_pattern (regex));
+      search->literal_len = strlen (search->literal);
+    }
+  search->match_func = match_func;
+  search->match_data = match_data;
+  search->match_data_destroy = match_data_destroy;
+  search->chars_changed_stamp = _gtk_text_btree_get_chars_changed_stamp (get_btree (buffer));
+  search->cancellable = g_cancellable_new ();
+  if (cancellable)
+    {
+      search->user_cancellable = g_object_ref (cancellable);
+      search->cancelled_id = g_cancellable_connect (cancellable,
+                                                    G_CALLBACK (search_cancelled_cb),
+                                                    search, NULL);
+    }
+  g_task_set_task_data (task, search, search_data_free);
+
+  n_lines = gtk_text_buffer_get_line_count (buffer);
+  n_chunks = MIN (g_get_num_processors (), n_lines);
+
+  for (i = 0; i < n_chunks; i++)
+    {
+      SearchChunk *chunk;
+      GtkTextIter start, end;
+      GTask *thread_task;
+
+      gtk_text_buffer_get_iter_at_line (buffer, &start, (int) ((gint64) i * n_lines / n_chunks));
+      if (i + 1 < n_chunks)
+        gtk_text_buffer_get_iter_at_line (buffer, &end, (int) ((gint64) (i + 1) * n_lines / n_chunks));
+      else
+        gtk_text_buffer_get_end_iter (buffer, &end);
+
+      chunk = g_new0 (SearchChunk, 1);
+      chunk->task = g_object_ref (task);
+      chunk->text = gtk_text_iter_get_slice (&start, &end);
+      chunk->offset = gtk_text_iter_get_offset (&start);
+      chunk->matches = g_array_sized_new (FALSE, FALSE, sizeof (int), 2 * SEARCH_BATCH_SIZE);
+
+      thread_task = g_task_new (buffer, search->cancellable, search_thread_done, g_object_ref (task));
+      g_task_set_source_tag (thread_task, gtk_text_buffer_search_async);
+      g_task_set_task_data (thread_task, chunk, search_chunk_free);
+      g_task_run_in_thread (thread_task, search_thread);
+      g_object_unref (thread_task);
+
+      search->n_running++;
+    }
+
+  g_object_unref (task);
+}
+
+/**
+ * gtk_text_buffer_search_finish:
+ * @buffer: a `GtkTextBuffer`
+ * @result: a `GAsyncResult`
+ * @error: return location for an error
+ *
+ * Finishes an operation started with [method@Gtk.TextBuffer.search_async].
+ *
+ * Returns: %TRUE if the whole text was searched
+ *
+ * Since: 4.8
+ */
+gboolean
+gtk_text_buffer_search_finish (GtkTextBuffer  *buffer,
+                               GAsyncResult   *result,
+                               GError        **error)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, buffer), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gtk_text_buffer_search_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /*
  * Insertion
  */
@@ -1196,7 +1994,14 @@ gtk_text_buffer_real_insert_text (GtkTextBuffer *buffer,
                                   text,
                                   len);
 
-  _gtk_text_btree_insert (iter, text, len);
+  if (buffer->priv->load_builder && text == buffer->priv->load_text)
+    {
+      _gtk_text_btree_insert_lines (iter, buffer->priv->load_builder);
+      buffer->priv->load_builder = NULL;
+      buffer->priv->load_text = NULL;
+    }
+  else
+    _gtk_text_btree_insert (iter, text, len);
 
   g_signal_emit (buffer, signals[CHANGED], 0);
   g_object_notify_by_pspec (G_OBJECT (buffer), text_buffer_props[PROP_CURSOR_POSITION]);
@@ -3030,6 +3835,99 @@ gtk_text_buffer_remove_tag (GtkTextBuffer     *buffer,
   gtk_text_buffer_emit_tag (buffer, tag, FALSE, start, end);
 }
 
+static int
+compare_tag_ranges (gconstpointer a,
+                    gconstpointer b)
+{
+  const GtkTextTagRange *ra = a;
+  const GtkTextTagRange *rb = b;
+
+  if (ra->tag != rb->tag)
+    return ra->tag < rb->tag ? -1 : 1;
+
+  return ra->start - rb->start;
+}
+
+/**
+ * gtk_text_buffer_apply_tag_ranges:
+ * @buffer: a `GtkTextBuffer`
+ * @ranges: (array length=n_ranges): the tags and ranges to apply them to
+ * @n_ranges: the number of ranges
+ *
+ * Applies many tags at once.
+ *
+ * This is like calling [method@Gtk.TextBuffer.apply_tag] for each
+ * of @ranges, but a lot faster for many small ranges, as is common
+ * for syntax highlighting. Overlapping and adjacent ranges of the same
+ * tag are merged, and the text is only relayouted once at the end.
+ *
+ * The “apply-tag” signal is emitted for each of the merged ranges.
+ * Handlers must not change the text.
+ *
+ * Since: 4.8
+ */
+void
+gtk_text_buffer_apply_tag_ranges (GtkTextBuffer         *buffer,
+                                  const GtkTextTagRange *ranges,
+                                  guint                  n_ranges)
+{
+  GtkTextTagRange *sorted;
+  int n_chars;
+  guint i, j;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (ranges != NULL || n_ranges == 0);
+
+  if (n_ranges == 0)
+    return;
+
+  for (i = 0; i < n_ranges; i++)
+    {
+      g_return_if_fail (GTK_IS_TEXT_TAG (ranges[i].tag));
+      g_return_if_fail (ranges[i].tag->priv->table == buffer->priv->tag_table);
+    }
+
+  n_chars = gtk_text_buffer_get_char_count (buffer);
+
+  sorted = g_new (GtkTextTagRange, n_ranges);
+  for (i = 0, j = 0; i < n_ranges; i++)
+    {
+      sorted[j].tag = ranges[i].tag;
+      sorted[j].start = CLAMP (MIN (ranges[i].start, ranges[i].end), 0, n_chars);
+      sorted[j].end = CLAMP (MAX (ranges[i].start, ranges[i].end), 0, n_chars);
+      if (sorted[j].start < sorted[j].end)
+        j++;
+    }
+  n_ranges = j;
+
+  qsort (sorted, n_ranges, sizeof (GtkTextTagRange), compare_tag_ranges);
+
+  _gtk_text_btree_begin_tag_batch (get_btree (buffer));
+
+  for (i = 0; i < n_ranges; i = j)
+    {
+      GtkTextIter start, end;
+      int range_end;
+
+      range_end = sorted[i].end;
+      for (j = i + 1; j < n_ranges; j++)
+        {
+          if (sorted[j].tag != sorted[i].tag || sorted[j].start > range_end)
+            break;
+
+          range_end = MAX (range_end, sorted[j].end);
+        }
+
+      gtk_text_buffer_get_iter_at_offset (buffer, &start, sorted[i].start);
+      gtk_text_buffer_get_iter_at_offset (buffer, &end, range_end);
+      gtk_text_buffer_emit_tag (buffer, sorted[i].tag, TRUE, &start, &end);
+    }
+
+  _gtk_text_btree_end_tag_batch (get_btree (buffer));
+
+  g_free (sorted);
+}
+
 /**
  * gtk_text_buffer_apply_tag_by_name:
  * @buffer: a `GtkTextBuffer`
@@ -5127,6 +6025,49 @@ gtk_text_buffer_set_max_undo_levels (GtkTextBuffer *buffer,
   gtk_text_history_set_max_undo_levels (buffer->priv->history, max_undo_levels);
 }
 
+/**
+ * gtk_text_buffer_get_max_undo_bytes:
+ * @buffer: a `GtkTextBuffer`
+ *
+ * Gets the maximum size of the text kept for undo and redo.
+ *
+ * If 0, the size of the undo history is only limited by
+ * [method@Gtk.TextBuffer.set_max_undo_levels].
+ *
+ * Returns: the maximum size in bytes
+ *
+ * Since: 4.8
+ */
+gsize
+gtk_text_buffer_get_max_undo_bytes (GtkTextBuffer *buffer)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), 0);
+
+  return gtk_text_history_get_max_bytes (buffer->priv->history);
+}
+
+/**
+ * gtk_text_buffer_set_max_undo_bytes:
+ * @buffer: a `GtkTextBuffer`
+ * @max_undo_bytes: the maximum size in bytes, or 0 for no limit
+ *
+ * Sets the maximum size of the text kept for undo and redo.
+ *
+ * When the inserted and removed text stored for undo grows larger
+ * than this, the oldest undo actions are dropped. The most recent
+ * action is always kept. The default is 64 MiB.
+ *
+ * Since: 4.8
+ */
+void
+gtk_text_buffer_set_max_undo_bytes (GtkTextBuffer *buffer,
+                                    gsize          max_undo_bytes)
+{
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+
+  gtk_text_history_set_max_bytes (buffer->priv->history, max_undo_bytes);
+}
+
 const char *
 gtk_justification_to_string (GtkJustification just)
 {
@@ -47,6 +47,42 @@ G_BEGIN_DECLS
 typedef struct _GtkTextBufferPrivate GtkTextBufferPrivate;
 typedef struct _GtkTextBufferClass GtkTextBufferClass;
 
+/**
+ * GtkTextBufferSearchFunc:
+ * @buffer: the `GtkTextBuffer`
+ * @match_start: the start of the match
+ * @match_end: the end of the match
+ * @user_data: (closure): data passed to gtk_text_buffer_search_async()
+ *
+ * A function used with gtk_text_buffer_search_async() to report matches.
+ *
+ * Since: 4.8
+ */
+typedef void (* GtkTextBufferSearchFunc) (GtkTextBuffer     *buffer,
+                                          const GtkTextIter *match_start,
+                                          const GtkTextIter *match_end,
+                                          gpointer           user_data);
+
+typedef struct _GtkTextTagRange GtkTextTagRange;
+
+/**
+ * GtkTextTagRange:
+ * @tag: the `GtkTextTag` to apply
+ * @start: the character offset of the start of the range
+ * @end: the character offset of the end of the range
+ *
+ * A range of text to apply a tag to with
+ * [method@Gtk.TextBuffer.apply_tag_ranges].
+ *
+ * Since: 4.8
+ */
+struct _GtkTextTagRange
+{
+  GtkTextTag *tag;
+  int         start;
+  int         end;
+};
+
 struct _GtkTextBuffer
 {
   GObject parent_instance;
@@ -157,6 +193,34 @@ GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_set_text          (GtkTextBuffer *buffer,
                                         const char    *text,
                                         int            len);
+GDK_AVAILABLE_IN_4_8
+void     gtk_text_buffer_load_async     (GtkTextBuffer         *buffer,
+                                         GInputStream          *stream,
+                                         int                    io_priority,
+                                         GCancellable          *cancellable,
+                                         GFileProgressCallback  progress_callback,
+                                         gpointer               progress_data,
+                                         GDestroyNotify         progress_data_destroy,
+                                         GAsyncReadyCallback    callback,
+                                         gpointer               user_data);
+GDK_AVAILABLE_IN_4_8
+gboolean gtk_text_buffer_load_finish    (GtkTextBuffer         *buffer,
+                                         GAsyncResult          *result,
+                                         GError               **error);
+
+GDK_AVAILABLE_IN_4_8
+void     gtk_text_buffer_search_async   (GtkTextBuffer           *buffer,
+                                         GRegex                  *regex,
+                                         GCancellable            *cancellable,
+                                         GtkTextBufferSearchFunc  match_func,
+                                         gpointer                 match_data,
+                                         GDestroyNotify           match_data_destroy,
+                                         GAsyncReadyCallback      callback,
+                                         gpointer                 user_data);
+GDK_AVAILABLE_IN_4_8
+gboolean gtk_text_buffer_search_finish  (GtkTextBuffer           *buffer,
+                                         GAsyncResult            *result,
+                                         GError                 **error);
 
 /* Insert into the buffer */
 GDK_AVAILABLE_IN_ALL
@@ -331,6 +395,10 @@ GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_remove_all_tags       (GtkTextBuffer     *buffer,
                                             const GtkTextIter *start,
                                             const GtkTextIter *end);
+GDK_AVAILABLE_IN_4_8
+void gtk_text_buffer_apply_tag_ranges      (GtkTextBuffer         *buffer,
+                                            const GtkTextTagRange *ranges,
+                                            guint                  n_ranges);
 
 
 /* You can either ignore the return value, or use it to
@@ -448,6 +516,11 @@ guint           gtk_text_buffer_get_max_undo_levels       (GtkTextBuffer *buffer
 GDK_AVAILABLE_IN_ALL
 void            gtk_text_buffer_set_max_undo_levels       (GtkTextBuffer *buffer,
                                                            guint          max_undo_levels);
+GDK_AVAILABLE_IN_4_8
+gsize           gtk_text_buffer_get_max_undo_bytes        (GtkTextBuffer *buffer);
+GDK_AVAILABLE_IN_4_8
+void            gtk_text_buffer_set_max_undo_bytes        (GtkTextBuffer *buffer,
+                                                           gsize          max_undo_bytes);
 GDK_AVAILABLE_IN_ALL
 void            gtk_text_buffer_undo                      (GtkTextBuffer *buffer);
 GDK_AVAILABLE_IN_ALL
@@ -19,6 +19,8 @@
 #include "gtkistringprivate.h"
 #include "gtktexthistoryprivate.h"
 
+#include <gio/gio.h>
+
 /*
  * The GtkTextHistory works in a way that allows text widgets to deliver
  * information about changes to the underlying text at given offsets within
@@ -36,8 +38,17 @@
  * gtk_text_history_end_irreversible_action() can be used to denote a
  * section of operations that cannot be undone. This will cause all previous
  * changes tracked by the GtkTextHistory to be discarded.
+ *
+ * Besides limiting the number of actions, the memory used by the text of
+ * all actions can be limited with gtk_text_history_set_max_bytes(), which
+ * GtkTextBuffer exposes as gtk_text_buffer_set_max_undo_bytes(). Large
+ * texts are kept compressed unless the action is the most recent one, as
+ * it may still be chained with new actions.
  */
 
+#define DEFAULT_MAX_BYTES  (64 * 1024 * 1024)
+#define COMPRESS_MIN_BYTES (16 * 1024)
+
 typedef struct _Action     Action;
 typedef enum   _ActionKind ActionKind;
 
@@ -58,6 +69,8 @@ struct _Action
   GList link;
   guint is_modified : 1;
   guint is_modified_set : 1;
+  /* The text of an insert or delete, see action_compress() */
+  GBytes *compressed;
   union {
     struct {
       IString istr;
@@ -99,6 +112,10 @@ struct _GtkTextHistory
   guint               in_user;
   guint               max_undo_levels;
 
+  /* Size of the text in all actions, compressed or not */
+  gsize               n_bytes;
+  gsize               max_bytes;
+
   guint               can_undo : 1;
   guint               can_redo : 1;
   guint               is_modified : 1;
@@ -107,7 +124,8 @@ struct _GtkTextHistory
   guint               enabled : 1;
 };
 
-static void action_free (Action *action);
+static void action_free (GtkTextHistory *self,
+                         Action         *action);
 
 G_DEFINE_TYPE (GtkTextHistory, gtk_text_history, G_TYPE_OBJECT)
 
@@ -140,7 +158,8 @@ uint_order (guint *a,
 }
 
 static void
-clear_action_queue (GQueue *queue)
+clear_action_queue (GtkTextHistory *self,
+                    GQueue         *queue)
 {
   g_assert (queue != NULL);
 
@@ -148,7 +167,7 @@ clear_action_queue (GQueue *queue)
     {
       Action *action = g_queue_peek_head (queue);
       g_queue_unlink (queue, &action->link);
-      action_free (action);
+      action_free (self, action);
     }
 }
 
@@ -164,22 +183,141 @@ action_new (ActionKind kind)
   return action;
 }
 
-static void
-action_free (Action *action)
+static IString *
+action_get_istring (Action *action)
 {
   if (action->kind == ACTION_KIND_INSERT)
-    istring_clear (&action->u.insert.istr);
+    return &action->u.insert.istr;
   else if (action->kind == ACTION_KIND_DELETE_BACKSPACE ||
            action->kind == ACTION_KIND_DELETE_KEY ||
            action->kind == ACTION_KIND_DELETE_PROGRAMMATIC ||
            action->kind == ACTION_KIND_DELETE_SELECTION)
-    istring_clear (&action->u.delete.istr);
+    return &action->u.delete.istr;
+  else
+    return NULL;
+}
+
+static void
+action_free (GtkTextHistory *self,
+             Action         *action)
+{
+  IString *istr = action_get_istring (action);
+
+  if (action->compressed)
+    {
+      self->n_bytes -= g_bytes_get_size (action->compressed);
+      g_bytes_unref (action->compressed);
+    }
+  else if (istr)
+    {
+      self->n_bytes -= istr->n_bytes;
+      istring_clear (istr);
+    }
   else if (action->kind == ACTION_KIND_GROUP)
-    clear_action_queue (&action->u.group.actions);
+    clear_action_queue (self, &action->u.group.actions);
 
   g_slice_free (Action, action);
 }
 
+/* Compresses large texts of actions that are not likely
+ * to be needed soon. Does nothing if it doesn't pay off.
+ */
+static void
+action_compress (GtkTextHistory *self,
+                 Action         *action)
+{
+  GConverter *compressor;
+  GOutputStream *memory, *stream;
+  IString *istr;
+  GBytes *bytes;
+  gboolean success;
+
+  if (action->kind == ACTION_KIND_GROUP)
+    {
+      const GList *iter;
+
+      for (iter = action->u.group.actions.head; iter; iter = iter->next)
+        action_compress (self, iter->data);
+
+      return;
+    }
+
+  istr = action_get_istring (action);
+  if (istr == NULL || action->compressed || istr->n_bytes < COMPRESS_MIN_BYTES)
+    return;
+
+  compressor = G_CONVERTER (g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW, 1));
+  memory = g_memory_output_stream_new_resizable ();
+  stream = g_converter_output_stream_new (memory, compressor);
+  success = g_output_stream_write_all (stream, istring_str (istr), istr->n_bytes, NULL, NULL, NULL) &&
+            g_output_stream_close (stream, NULL, NULL);
+  g_object_unref (stream);
+  g_object_unref (compressor);
+
+  if (!success)
+    {
+      g_object_unref (memory);
+      return;
+    }
+
+  bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (memory));
+  g_object_unref (memory);
+
+  if (g_bytes_get_size (bytes) > istr->n_bytes / 4 * 3)
+    {
+      g_bytes_unref (bytes);
+      return;
+    }
+
+  self->n_bytes -= istr->n_bytes - g_bytes_get_size (bytes);
+  action->compressed = bytes;
+  /* Keep the sizes, they are needed without the text */
+  g_clear_pointer (&istr->u.str, g_free);
+}
+
+static void
+action_decompress (GtkTextHistory *self,
+                   Action         *action)
+{
+  GConverter *decompressor;
+  GInputStream *memory, *stream;
+  IString *istr;
+  gboolean success;
+  char *str;
+
+  if (action->kind == ACTION_KIND_GROUP)
+    {
+      const GList *iter;
+
+      for (iter = action->u.group.actions.head; iter; iter = iter->next)
+        action_decompress (self, iter->data);
+
+      return;
+    }
+
+  if (action->compressed == NULL)
+    return;
+
+  istr = action_get_istring (action);
+
+  decompressor = G_CONVERTER (g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW));
+  memory = g_memory_input_stream_new_from_bytes (action->compressed);
+  stream = g_converter_input_stream_new (memory, decompressor);
+  str = g_malloc (istr->n_bytes + 1);
+  success = g_input_stream_read_all (stream, str, istr->n_bytes, NULL, NULL, NULL);
+  g_object_unref (stream);
+  g_object_unref (memory);
+  g_object_unref (decompressor);
+
+  /* We wrote it ourselves, so this can't fail */
+  g_assert (success);
+  str[istr->n_bytes] = 0;
+
+  self->n_bytes += istr->n_bytes - g_bytes_get_size (action->compressed);
+  g_clear_pointer (&action->compressed, g_bytes_unref);
+  istr->u.str = str;
+}
+
 static gboolean
 action_group_is_empty (const Action *action)
 {
@@ -204,9 +342,10 @@ action_group_is_empty (const Action *action)
 }
 
 static gboolean
-action_chain (Action   *action,
-              Action   *other,
-              gboolean  in_user_action)
+action_chain (GtkTextHistory *self,
+              Action         *action,
+              Action         *other,
+              gboolean        in_user_action)
 {
   g_assert (action != NULL);
   g_assert (other != NULL);
@@ -230,7 +369,7 @@ action_chain (Action   *action,
           if (!in_user_action && action->u.group.depth == 0)
             return FALSE;
 
-          action_free (other);
+          action_free (self, other);
           return TRUE;
         }
 
@@ -241,7 +380,7 @@ action_chain (Action   *action,
        */
       if (tail != NULL && tail->kind == other->kind)
         {
-          if (action_chain (tail, other, in_user_action))
+          if (action_chain (self, tail, other, in_user_action))
             return TRUE;
         }
 
@@ -254,6 +393,9 @@ action_chain (Action   *action,
   if (action->kind != other->kind)
     return FALSE;
 
+  /* Undo and redo may have brought back a compressed action */
+  action_decompress (self, action);
+
   switch (action->kind)
     {
     case ACTION_KIND_INSERT: {
@@ -298,8 +440,9 @@ action_chain (Action   *action,
     do_chain:
 
       istring_append (&action->u.insert.istr, &other->u.insert.istr);
+      self->n_bytes += other->u.insert.istr.n_bytes;
       action->u.insert.end += other->u.insert.end - other->u.insert.begin;
-      action_free (other);
+      action_free (self, other);
 
       return TRUE;
     }
@@ -323,8 +466,9 @@ action_chain (Action   *action,
         {
           istring_prepend (&action->u.delete.istr,
                            &other->u.delete.istr);
+          self->n_bytes += other->u.delete.istr.n_bytes;
           action->u.delete.begin = other->u.delete.begin;
-          action_free (other);
+          action_free (self, other);
           return TRUE;
         }
 
@@ -337,8 +481,9 @@ action_chain (Action   *action,
               istring_only_contains_space (&action->u.delete.istr))
             {
               istring_append (&action->u.delete.istr, &other->u.delete.istr);
+              self->n_bytes += other->u.delete.istr.n_bytes;
               action->u.delete.end += other->u.delete.istr.n_chars;
-              action_free (other);
+              action_free (self, other);
               return TRUE;
             }
         }
@@ -347,7 +492,7 @@ action_chain (Action   *action,
 
     case ACTION_KIND_BARRIER:
       /* Only allow a single barrier to be added. */
-      action_free (other);
+      action_free (self, other);
       return TRUE;
 
     case ACTION_KIND_GROUP:
@@ -413,13 +558,13 @@ gtk_text_history_truncate_one (GtkTextHistory *self)
     {
       Action *action = g_queue_peek_head (&self->undo_queue);
       g_queue_unlink (&self->undo_queue, &action->link);
-      action_free (action);
+      action_free (self, action);
     }
   else if (self->redo_queue.length > 0)
     {
       Action *action = g_queue_peek_tail (&self->redo_queue);
       g_queue_unlink (&self->redo_queue, &action->link);
-      action_free (action);
+      action_free (self, action);
     }
   else
     {
@@ -432,11 +577,19 @@ gtk_text_history_truncate (GtkTextHistory *self)
 {
   g_assert (GTK_IS_TEXT_HISTORY (self));
 
-  if (self->max_undo_levels == 0)
-    return;
+  if (self->max_undo_levels != 0)
+    {
+      while (self->undo_queue.length + self->redo_queue.length > self->max_undo_levels)
+        gtk_text_history_truncate_one (self);
+    }
 
-  while (self->undo_queue.length + self->redo_queue.length > self->max_undo_levels)
-    gtk_text_history_truncate_one (self);
+  /* Always keep the last action, even if it is too large by itself */
+  if (self->max_bytes != 0)
+    {
+      while (self->n_bytes > self->max_bytes &&
+             self->undo_queue.length + self->redo_queue.length > 1)
+        gtk_text_history_truncate_one (self);
+    }
 }
 
 static void
@@ -444,8 +597,8 @@ gtk_text_history_finalize (GObject *object)
 {
   GtkTextHistory *self = (GtkTextHistory *)object;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  clear_action_queue (self, &self->undo_queue);
+  clear_action_queue (self, &self->redo_queue);
 
   G_OBJECT_CLASS (gtk_text_history_parent_class)->finalize (object);
 }
@@ -462,6 +615,7 @@ static void
 gtk_text_history_init (GtkTextHistory *self)
 {
   self->enabled = TRUE;
+  self->max_bytes = DEFAULT_MAX_BYTES;
   self->selection.insert = -1;
   self->selection.bound = -1;
 }
@@ -526,14 +680,20 @@ gtk_text_history_push (GtkTextHistory *self,
     {
       peek = g_queue_peek_head (&self->redo_queue);
       g_queue_unlink (&self->redo_queue, &peek->link);
-      action_free (peek);
+      action_free (self, peek);
     }
 
   peek = g_queue_peek_tail (&self->undo_queue);
   in_user_action = self->in_user > 0;
 
-  if (peek == NULL || !action_chain (peek, action, in_user_action))
-    g_queue_push_tail_link (&self->undo_queue, &action->link);
+  if (peek == NULL || !action_chain (self, peek, action, in_user_action))
+    {
+      /* Nothing gets chained to the previous action anymore */
+      if (peek != NULL && peek->kind != ACTION_KIND_GROUP)
+        action_compress (self, peek);
+
+      g_queue_push_tail_link (&self->undo_queue, &action->link);
+    }
 
   gtk_text_history_truncate (self);
   gtk_text_history_update_state (self);
@@ -735,7 +895,9 @@ gtk_text_history_undo (GtkTextHistory *self)
 
       g_queue_unlink (&self->undo_queue, &action->link);
       g_queue_push_head_link (&self->redo_queue, &action->link);
+      action_decompress (self, action);
       gtk_text_history_reverse (self, action);
+      action_compress (self, action);
       gtk_text_history_update_state (self);
 
       self->applying = FALSE;
@@ -771,7 +933,13 @@ gtk_text_history_redo (GtkTextHistory *self)
 
       peek = g_queue_peek_head (&self->redo_queue);
 
+      action_decompress (self, action);
+      if (peek != NULL)
+        action_decompress (self, peek);
       gtk_text_history_apply (self, action, peek);
+      action_compress (self, action);
+      if (peek != NULL)
+        action_compress (self, peek);
       gtk_text_history_update_state (self);
 
       self->applying = FALSE;
@@ -815,7 +983,7 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
   return_if_applying (self);
   return_if_irreversible (self);
 
-  clear_action_queue (&self->redo_queue);
+  clear_action_queue (self, &self->redo_queue);
 
   peek = g_queue_peek_tail (&self->undo_queue);
 
@@ -838,7 +1006,7 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
   if (action_group_is_empty (peek))
     {
       g_queue_unlink (&self->undo_queue, &peek->link);
-      action_free (peek);
+      action_free (self, peek);
       goto update_state;
     }
 
@@ -855,13 +1023,16 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
 
       g_queue_unlink (&peek->u.group.actions, link_);
       g_queue_unlink (&self->undo_queue, &peek->link);
-      action_free (peek);
+      action_free (self, peek);
 
       gtk_text_history_push (self, replaced);
 
       goto update_state;
     }
 
+  /* Nothing gets chained to the group anymore */
+  action_compress (self, peek);
+
   /* Now insert a barrier action so we don't allow
    * joining items to this node in the future.
    */
@@ -887,8 +1058,8 @@ gtk_text_history_begin_irreversible_action (GtkTextHistory *self)
 
   self->irreversible++;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  clear_action_queue (self, &self->undo_queue);
+  clear_action_queue (self, &self->redo_queue);
 
   gtk_text_history_update_state (self);
 }
@@ -909,8 +1080,8 @@ gtk_text_history_end_irreversible_action (GtkTextHistory *self)
 
   self->irreversible--;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  clear_action_queue (self, &self->undo_queue);
+  clear_action_queue (self, &self->redo_queue);
 
   gtk_text_history_update_state (self);
 }
@@ -1008,6 +1179,7 @@ gtk_text_history_text_inserted (GtkTextHistory *self,
   action->u.insert.begin = position;
   action->u.insert.end = position + n_chars;
   istring_set (&action->u.insert.istr, text, len, n_chars);
+  self->n_bytes += len;
 
   gtk_text_history_push (self, action);
 }
@@ -1046,6 +1218,7 @@ gtk_text_history_text_deleted (GtkTextHistory *self,
   action->u.delete.selection.insert = self->selection.insert;
   action->u.delete.selection.bound = self->selection.bound;
   istring_set (&action->u.delete.istr, text, len, ABS (end - begin));
+  self->n_bytes += len;
 
   gtk_text_history_push (self, action);
 }
@@ -1074,8 +1247,8 @@ gtk_text_history_set_enabled (GtkTextHistory *self,
         {
           self->irreversible = 0;
           self->in_user = 0;
-          clear_action_queue (&self->undo_queue);
-          clear_action_queue (&self->redo_queue);
+          clear_action_queue (self, &self->undo_queue);
+          clear_action_queue (self, &self->redo_queue);
         }
 
       gtk_text_history_update_state (self);
@@ -1102,3 +1275,34 @@ gtk_text_history_set_max_undo_levels (GtkTextHistory *self,
       gtk_text_history_truncate (self);
     }
 }
+
+gsize
+gtk_text_history_get_max_bytes (GtkTextHistory *self)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_HISTORY (self), 0);
+
+  return self->max_bytes;
+}
+
+/*
+ * gtk_text_history_set_max_bytes:
+ * @self: a GtkTextHistory
+ * @max_bytes: the maximum size of the text kept for undo and redo,
+ *   or 0 for no limit
+ *
+ * Sets how much memory the history may use for the text of its
+ * actions. The oldest actions are dropped when it grows larger,
+ * but the last action is always kept.
+ */
+void
+gtk_text_history_set_max_bytes (GtkTextHistory *self,
+                                gsize           max_bytes)
+{
+  g_return_if_fail (GTK_IS_TEXT_HISTORY (self));
+
+  if (self->max_bytes != max_bytes)
+    {
+      self->max_bytes = max_bytes;
+      gtk_text_history_truncate (self);
+    }
+}
@@ -89,10 +89,13 @@
 #include "gtktextutil.h"
 #include "gskpango.h"
 #include "gtkintl.h"
+#include "gtkpango.h"
 #include "gtksnapshotprivate.h"
 #include "gtkwidgetprivate.h"
 #include "gtktextviewprivate.h"
 
+#include <pango/pangocairo.h>
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -109,6 +112,10 @@ struct _GtkTextLayoutPrivate
 
   /* Cache for GtkTextLineDisplay to reduce overhead creating layouts */
   GtkTextLineDisplayCache *cache;
+
+  /* Incremented whenever lines are invalidated, so that sizes
+   * estimated in a thread can be discarded if they are outdated */
+  guint estimate_stamp;
 };
 
 static void gtk_text_layout_invalidated     (GtkTextLayout     *layout);
@@ -307,12 +314,21 @@ void
 gtk_text_layout_set_buffer (GtkTextLayout *layout,
                             GtkTextBuffer *buffer)
 {
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+
   g_return_if_fail (GTK_IS_TEXT_LAYOUT (layout));
   g_return_if_fail (buffer == NULL || GTK_IS_TEXT_BUFFER (buffer));
 
   if (layout->buffer == buffer)
     return;
 
+  /* Sizes estimated for the old buffer must not be used, and
+   * neither must displays or prefetches of its lines.
+   */
+  priv->estimate_stamp++;
+  if (priv->cache)
+    gtk_text_line_display_cache_invalidate (priv->cache);
+
   free_style_cache (layout);
 
   if (layout->buffer)
@@ -790,6 +806,8 @@ gtk_text_layout_invalidate (GtkTextLayout     *layout,
   g_return_if_fail (GTK_IS_TEXT_LAYOUT (layout));
   g_return_if_fail (layout->wrap_loop_count == 0);
 
+  GTK_TEXT_LAYOUT_GET_PRIVATE (layout)->estimate_stamp++;
+
   /* Because we may be invalidating a mark, it's entirely possible
    * that gtk_text_iter_equal (start, end) in which case we
    * should still invalidate the line they are both on. i.e.
@@ -926,7 +944,7 @@ gtk_text_layout_validate_yrange (GtkTextLayout *layout,
   while (line && seen < -y0)
     {
       GtkTextLineData *line_data = _gtk_text_line_get_data (line, layout);
-      if (!line_data || !line_data->valid)
+      if (!line_data || !line_data->valid || line_data->estimated)
         {
           int old_height, new_height;
           int top_ink, bottom_ink;
@@ -967,7 +985,7 @@ gtk_text_layout_validate_yrange (GtkTextLayout *layout,
   while (line && seen < y1)
     {
       GtkTextLineData *line_data = _gtk_text_line_get_data (line, layout);
-      if (!line_data || !line_data->valid)
+      if (!line_data || !line_data->valid || line_data->estimated)
         {
           int old_height, new_height;
           int top_ink, bottom_ink;
@@ -1051,6 +1069,361 @@ gtk_text_layout_validate (GtkTextLayout *layout,
     }
 }
 
+/* Number of lines measured by a single estimate thread */
+#define GTK_TEXT_LAYOUT_ESTIMATE_LINES 2000
+
+typedef struct _EstimateData EstimateData;
+
+struct _EstimateData
+{
+  /* only touched in the main thread */
+  GtkTextBuffer *buffer; /* not owned, only compared */
+  GPtrArray *lines;
+  guint segments_stamp;
+  guint estimate_stamp;
+  guint font_map_serial;
+
+  /* snapshot of the line texts and the default style */
+  GPtrArray *texts;
+  PangoFontDescription *font;
+  PangoLanguage *language;
+  PangoTabArray *tabs;
+  cairo_font_options_t *font_options;
+  double resolution;
+  PangoWrapMode wrap_mode;
+  int wrap_width;
+  int indent;
+  int spacing;
+  int letter_spacing;
+  int h_extra;
+  int v_extra;
+
+  /* results, NULL if the font map changed */
+  int *widths;
+  int *heights;
+};
+
+static void
+estimate_data_free (gpointer data)
+{
+  EstimateData *estimate = data;
+
+  g_ptr_array_unref (estimate->lines);
+  g_ptr_array_unref (estimate->texts);
+  pango_font_description_free (estimate->font);
+  g_clear_pointer (&estimate->tabs, pango_tab_array_free);
+  g_clear_pointer (&estimate->font_options, cairo_font_options_destroy);
+  g_free (estimate->widths);
+  g_free (estimate->heights);
+
+  g_free (estimate);
+}
+
+/* Copies the text of @line the way gtk_text_layout_get_line_display()
+ * hands it to Pango, with embedded objects as U+FFFC.
+ */
+static char *
+line_get_estimate_text (GtkTextLine *line)
+{
+  GtkTextLineSegment *seg;
+  GString *text;
+
+  text = g_string_new (NULL);
+
+  for (seg = line->segments; seg; seg = seg->next)
+    {
+      if (seg->type == &gtk_text_char_type)
+        g_string_append_len (text, seg->body.chars, seg->byte_count);
+      else if (seg->type == &gtk_text_paintable_type ||
+               seg->type == &gtk_text_child_type)
+        g_string_append_len (text, _gtk_text_unknown_char_utf8, GTK_TEXT_UNKNOWN_CHAR_UTF8_LEN);
+    }
+
+  /* Pango doesn't want the trailing paragraph delimiters */
+  if (text->len > 0)
+    {
+      const char *prev = g_utf8_prev_char (text->str + text->len);
+      gunichar ch = g_utf8_get_char (prev);
+
+      /* U+2029 PARAGRAPH SEPARATOR */
+      if (ch == 0x2029 || ch == '\r' || ch == '\n')
+        g_string_truncate (text, prev - text->str);
+      if (ch == '\n' && text->len > 0 && text->str[text->len - 1] == '\r')
+        g_string_truncate (text, text->len - 1);
+    }
+
+  return g_string_free (text, FALSE);
+}
+
+static void
+gtk_text_layout_estimate_thread (GTask        *task,
+                                 gpointer      source_object,
+                                 gpointer      task_data,
+                                 GCancellable *cancellable)
+{
+  EstimateData *estimate = task_data;
+  PangoFontMap *font_map;
+  PangoContext *context;
+  PangoLayout *layout;
+  PangoRectangle extents;
+  guint i;
+
+  font_map = gtk_pango_worker_font_map_acquire (estimate->font_map_serial);
+  if (font_map == NULL)
+    {
+      g_task_return_boolean (task, TRUE);
+      return;
+    }
+
+  context = pango_font_map_create_context (font_map);
+  pango_cairo_context_set_resolution (context, estimate->resolution);
+  if (estimate->font_options)
+    pango_cairo_context_set_font_options (context, estimate->font_options);
+  pango_context_set_language (context, estimate->language);
+  pango_context_set_font_description (context, estimate->font);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_spacing (layout, estimate->spacing);
+  pango_layout_set_indent (layout, estimate->indent);
+  if (estimate->tabs)
+    pango_layout_set_tabs (layout, estimate->tabs);
+  if (estimate->wrap_width >= 0)
+    {
+      pango_layout_set_width (layout, estimate->wrap_width);
+      pango_layout_set_wrap (layout, estimate->wrap_mode);
+    }
+  if (estimate->letter_spacing != 0)
+    {
+      PangoAttrList *attrs = pango_attr_list_new ();
+      pango_attr_list_insert (attrs, pango_attr_letter_spacing_new (estimate->letter_spacing));
+      pango_layout_set_attributes (layout, attrs);
+      pango_attr_list_unref (attrs);
+    }
+
+  estimate->widths = g_new (int, estimate->texts->len);
+  estimate->heights = g_new (int, estimate->texts->len);
+
+  for (i = 0; i < estimate->texts->len; i++)
+    {
+      if (g_cancellable_is_cancelled (cancellable))
+        break;
+
+      pango_layout_set_text (layout, g_ptr_array_index (estimate->texts, i), -1);
+      pango_layout_get_extents (layout, NULL, &extents);
+
+      estimate->widths[i] = PIXEL_BOUND (extents.width) + estimate->h_extra;
+      estimate->heights[i] = PANGO_PIXELS (extents.height) + estimate->v_extra;
+    }
+
+  g_object_unref (layout);
+  g_object_unref (context);
+  gtk_pango_worker_font_map_release (font_map);
+
+  if (!g_task_return_error_if_cancelled (task))
+    g_task_return_boolean (task, TRUE);
+}
+
+/*
+ * gtk_text_layout_estimate_async:
+ * @layout: a `GtkTextLayout`
+ * @cancellable: (nullable): a `GCancellable`
+ * @callback: callback to call when the estimate is done
+ * @user_data: data to pass to @callback
+ *
+ * Measures the next batch of invalid lines in a thread. Only the
+ * text and the default style are taken into account, so lines with
+ * tags or embedded objects are only approximated. These lines are
+ * marked as estimated and are validated properly once they are
+ * needed by gtk_text_layout_validate_yrange().
+ *
+ * Workers can't use the font map of the layout, so this only works
+ * for layouts using the default font map.
+ *
+ * Returns: %FALSE if there are no invalid lines or they can't be
+ *   measured in a thread. In that case, @callback will not be called.
+ */
+gboolean
+gtk_text_layout_estimate_async (GtkTextLayout       *layout,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+  GtkTextAttributes *style = layout->default_style;
+  const cairo_font_options_t *font_options;
+  EstimateData *estimate;
+  GtkTextBTree *btree;
+  GtkTextLine *line;
+  GTask *task;
+  guint i;
+
+  g_return_val_if_fail (GTK_IS_TEXT_LAYOUT (layout), FALSE);
+
+  if (layout->buffer == NULL ||
+      pango_context_get_font_map (layout->ltr_context) != pango_cairo_font_map_get_default ())
+    return FALSE;
+
+  btree = _gtk_text_buffer_get_btree (layout->buffer);
+  line = _gtk_text_btree_get_first_invalid_line (btree, layout);
+  if (line == NULL)
+    return FALSE;
+
+  estimate = g_new0 (EstimateData, 1);
+  estimate->buffer = layout->buffer;
+  estimate->font_map_serial = gtk_pango_worker_font_map_update ();
+  estimate->lines = g_ptr_array_new ();
+  estimate->texts = g_ptr_array_new_with_free_func (g_free);
+  estimate->segments_stamp = _gtk_text_btree_get_segments_changed_stamp (btree);
+  estimate->estimate_stamp = priv->estimate_stamp;
+
+  /* Only look at a window of lines after the first invalid one, so
+   * that a mostly valid buffer isn't walked to its end every time.
+   */
+  for (i = 0;
+       line != NULL && i < GTK_TEXT_LAYOUT_ESTIMATE_LINES;
+       line = _gtk_text_line_next_excluding_last (line), i++)
+    {
+      GtkTextLineData *line_data = _gtk_text_line_get_data (line, layout);
+
+      if (line_data && line_data->valid)
+        continue;
+
+      g_ptr_array_add (estimate->lines, line);
+      g_ptr_array_add (estimate->texts, line_get_estimate_text (line));
+    }
+
+  estimate->font = pango_font_description_copy (style->font);
+  if (style->font_scale != 1.0)
+    pango_font_description_set_size (estimate->font,
+                                      pango_font_description_get_size (style->font) * style->font_scale);
+  estimate->language = style->language;
+  if (style->tabs)
+    estimate->tabs = pango_tab_array_copy (style->tabs);
+  font_options = pango_cairo_context_get_font_options (layout->ltr_context);
+  if (font_options)
+    estimate->font_options = cairo_font_options_copy (font_options);
+  estimate->resolution = pango_cairo_context_get_resolution (layout->ltr_context);
+  estimate->indent = style->indent * PANGO_SCALE;
+  estimate->spacing = style->pixels_inside_wrap * PANGO_SCALE;
+  estimate->letter_spacing = style->letter_spacing;
+  estimate->h_extra = style->left_margin + style->right_margin +
+                      layout->left_padding + layout->right_padding;
+  estimate->v_extra = style->pixels_above_lines + style->pixels_below_lines;
+
+  switch (style->wrap_mode)
+    {
+    case GTK_WRAP_CHAR:
+      estimate->wrap_mode = PANGO_WRAP_CHAR;
+      break;
+    case GTK_WRAP_WORD:
+      estimate->wrap_mode = PANGO_WRAP_WORD;
+      break;
+    case GTK_WRAP_WORD_CHAR:
+      estimate->wrap_mode = PANGO_WRAP_WORD_CHAR;
+      break;
+    case GTK_WRAP_NONE:
+    default:
+      break;
+    }
+  if (style->wrap_mode != GTK_WRAP_NONE)
+    estimate->wrap_width = (layout->screen_width - estimate->h_extra) * PANGO_SCALE;
+  else
+    estimate->wrap_width = -1;
+
+  task = g_task_new (layout, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_text_layout_estimate_async);
+  g_task_set_task_data (task, estimate, estimate_data_free);
+  g_task_run_in_thread (task, gtk_text_layout_estimate_thread);
+  g_object_unref (task);
+
+  return TRUE;
+}
+
+/*
+ * gtk_text_layout_estimate_finish:
+ * @layout: a `GtkTextLayout`
+ * @result: the result passed to the callback
+ * @error: return location for an error
+ *
+ * Stores the sizes measured by gtk_text_layout_estimate_async() for
+ * the lines that are still invalid and emits ::changed. If the buffer,
+ * the layout or the font map changed in the meantime, the sizes are
+ * discarded.
+ *
+ * Returns: %FALSE if the estimate was cancelled
+ */
+gboolean
+gtk_text_layout_estimate_finish (GtkTextLayout  *layout,
+                                 GAsyncResult   *result,
+                                 GError        **error)
+{
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+  EstimateData *estimate;
+  GtkTextBTree *btree;
+  GtkTextBTreeNode *parent_node;
+  int y, old_height, new_height;
+  guint i;
+
+  g_return_val_if_fail (g_task_is_valid (result, layout), FALSE);
+
+  if (!g_task_propagate_boolean (G_TASK (result), error))
+    return FALSE;
+
+  estimate = g_task_get_task_data (G_TASK (result));
+
+  if (layout->buffer == NULL ||
+      layout->buffer != estimate->buffer ||
+      estimate->estimate_stamp != priv->estimate_stamp ||
+      estimate->widths == NULL ||
+      estimate->font_map_serial != pango_font_map_get_serial (pango_cairo_font_map_get_default ()) ||
+      estimate->lines->len == 0)
+    return TRUE;
+
+  btree = _gtk_text_buffer_get_btree (layout->buffer);
+  if (estimate->segments_stamp != _gtk_text_btree_get_segments_changed_stamp (btree))
+    return TRUE;
+
+  y = _gtk_text_btree_find_line_top (btree, g_ptr_array_index (estimate->lines, 0), layout);
+  old_height = 0;
+  new_height = 0;
+  parent_node = NULL;
+
+  for (i = 0; i < estimate->lines->len; i++)
+    {
+      GtkTextLine *line = g_ptr_array_index (estimate->lines, i);
+      GtkTextLineData *line_data = _gtk_text_line_get_data (line, layout);
+
+      if (line_data == NULL)
+        {
+          line_data = _gtk_text_line_data_new (layout, line);
+          _gtk_text_line_add_data (line, line_data);
+        }
+      else if (line_data->valid)
+        continue;
+
+      old_height += line_data->height;
+      line_data->width = estimate->widths[i];
+      line_data->height = estimate->heights[i];
+      line_data->valid = TRUE;
+      line_data->estimated = TRUE;
+      new_height += line_data->height;
+
+      /* Lines in the same node are next to each other */
+      if (parent_node != line->parent)
+        {
+          if (parent_node)
+            _gtk_text_btree_line_data_changed (btree, g_ptr_array_index (estimate->lines, i - 1), layout);
+          parent_node = line->parent;
+        }
+    }
+  _gtk_text_btree_line_data_changed (btree, g_ptr_array_index (estimate->lines, i - 1), layout);
+
+  update_layout_size (layout);
+  gtk_text_layout_emit_changed (layout, y, old_height, new_height);
+
+  return TRUE;
+}
+
 GtkTextLineData *
 gtk_text_layout_wrap (GtkTextLayout   *layout,
                       GtkTextLine     *line,
@@ -1073,6 +1446,7 @@ gtk_text_layout_wrap (GtkTextLayout   *layout,
   line_data->width = display->width;
   line_data->height = display->height;
   line_data->valid = TRUE;
+  line_data->estimated = FALSE;
   pango_layout_get_pixel_extents (display->layout, &ink_rect, &logical_rect);
   line_data->top_ink = MAX (0, logical_rect.x - ink_rect.x);
   line_data->bottom_ink = MAX (0, logical_rect.x + logical_rect.width - ink_rect.x - ink_rect.width);
@@ -4329,10 +4703,14 @@ gtk_text_line_display_compare (const GtkTextLineDisplay *display1,
 }
 
 void
-gtk_text_layout_set_mru_size (GtkTextLayout *layout,
-                              guint          mru_size)
+gtk_text_layout_set_viewport (GtkTextLayout *layout,
+                              int            y,
+                              int            height)
 {
   GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
 
-  gtk_text_line_display_cache_set_mru_size (priv->cache, mru_size);
+  if (layout->buffer == NULL)
+    return;
+
+  gtk_text_line_display_cache_set_viewport (priv->cache, layout, y, height);
 }
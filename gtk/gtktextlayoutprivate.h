@@ -299,6 +299,13 @@ void     gtk_text_layout_validate_yrange (GtkTextLayout *layout,
                                           int            y1_);
 void     gtk_text_layout_validate        (GtkTextLayout *layout,
                                           int            max_pixels);
+gboolean gtk_text_layout_estimate_async  (GtkTextLayout       *layout,
+                                          GCancellable        *cancellable,
+                                          GAsyncReadyCallback  callback,
+                                          gpointer             user_data);
+gboolean gtk_text_layout_estimate_finish (GtkTextLayout       *layout,
+                                          GAsyncResult        *result,
+                                          GError             **error);
 
 GtkTextLineData* gtk_text_layout_wrap  (GtkTextLayout   *layout,
                                         GtkTextLine     *line,
@@ -379,8 +386,9 @@ void gtk_text_layout_snapshot (GtkTextLayout        *layout,
                                const GdkRectangle   *clip,
                                float                 cursor_alpha);
 
-void gtk_text_layout_set_mru_size (GtkTextLayout *layout,
-                                   guint          mru_size);
+void gtk_text_layout_set_viewport (GtkTextLayout *layout,
+                                   int            y,
+                                   int            height);
 
 G_END_DECLS
 
@@ -25,10 +25,21 @@
 #include "gtktextlinedisplaycacheprivate.h"
 #include "gtkprivate.h"
 
+#include "gdkprofilerprivate.h"
+
 #define DEFAULT_MRU_SIZE         250
 #define BLOW_CACHE_TIMEOUT_SEC   20
 #define DEBUG_LINE_DISPLAY_CACHE 0
 
+/* Viewport changes further apart than this are not considered
+ * part of the same scroll when computing the velocity.
+ */
+#define SCROLL_TIMEOUT_USEC      (250 * 1000)
+/* How far ahead of a scroll to keep displays, in seconds */
+#define LOOKAHEAD_SEC            0.5
+/* Time to spend prefetching displays per idle */
+#define PREFETCH_BUDGET_USEC     2000
+
 struct _GtkTextLineDisplayCache
 {
   GSequence   *sorted_by_line;
@@ -38,6 +49,18 @@ struct _GtkTextLineDisplayCache
   GSource     *evict_source;
   guint        mru_size;
 
+  /* Set by gtk_text_line_display_cache_set_viewport() */
+  GtkTextLayout *layout;
+  int          viewport_y;
+  int          viewport_height;
+  int          first_line;
+  gint64       viewport_time;
+  double       velocity;         /* in lines per second, negative when scrolling up */
+
+  guint        prefetch_source;
+  int          prefetch_line;
+  int          prefetch_remaining;
+
 #if DEBUG_LINE_DISPLAY_CACHE
   guint       log_source;
   int         hits;
@@ -72,6 +95,22 @@ dump_stats (gpointer data)
 # define STAT_INC(val)
 #endif
 
+/* Totals over all caches, for the profiler */
+static guint hits_counter;
+static guint misses_counter;
+static guint evictions_counter;
+static guint prefetches_counter;
+static gint64 n_hits;
+static gint64 n_misses;
+static gint64 n_evictions;
+static gint64 n_prefetches;
+
+#define COUNTER_INC(name) G_STMT_START { \
+  n_##name++; \
+  if (GDK_PROFILER_IS_RUNNING) \
+    gdk_profiler_set_int_counter (name##_counter, n_##name); \
+} G_STMT_END
+
 GtkTextLineDisplayCache *
 gtk_text_line_display_cache_new (void)
 {
@@ -82,6 +121,14 @@ gtk_text_line_display_cache_new (void)
   ret->line_to_display = g_hash_table_new (NULL, NULL);
   ret->mru_size = DEFAULT_MRU_SIZE;
 
+  if (hits_counter == 0)
+    {
+      hits_counter = gdk_profiler_define_int_counter ("text-display-hits", "Text line displays found in cache");
+      misses_counter = gdk_profiler_define_int_counter ("text-display-misses", "Text line displays not found in cache");
+      evictions_counter = gdk_profiler_define_int_counter ("text-display-evictions", "Text line displays dropped from a full cache");
+      prefetches_counter = gdk_profiler_define_int_counter ("text-display-prefetches", "Text line displays created ahead of scrolling");
+    }
+
 #if DEBUG_LINE_DISPLAY_CACHE
   ret->log_source = g_timeout_add_seconds (1, dump_stats, ret);
 #endif
@@ -98,6 +145,7 @@ gtk_text_line_display_cache_free (GtkTextLineDisplayCache *cache)
 
   gtk_text_line_display_cache_invalidate (cache);
 
+  g_clear_handle_id (&cache->prefetch_source, g_source_remove);
   g_clear_pointer (&cache->evict_source, g_source_destroy);
   g_clear_pointer (&cache->sorted_by_line, g_sequence_free);
   g_clear_pointer (&cache->line_to_display, g_hash_table_unref);
@@ -208,6 +256,7 @@ gtk_text_line_display_cache_take_display (GtkTextLineDisplayCache *cache,
       display = g_queue_peek_tail (&cache->mru);
 
       gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
+      COUNTER_INC (evictions);
     }
 }
 
@@ -291,6 +340,7 @@ gtk_text_line_display_cache_get (GtkTextLineDisplayCache *cache,
       if (size_only || !display->size_only)
         {
           STAT_INC (cache->hits);
+          COUNTER_INC (hits);
 
           if (!size_only && display->line == cache->cursor_line)
             gtk_text_layout_update_display_cursors (layout, display->line, display);
@@ -313,6 +363,7 @@ gtk_text_line_display_cache_get (GtkTextLineDisplayCache *cache,
     }
 
   STAT_INC (cache->misses);
+  COUNTER_INC (misses);
 
   g_assert (!g_hash_table_lookup (cache->line_to_display, line));
 
@@ -348,6 +399,10 @@ gtk_text_line_display_cache_invalidate (GtkTextLineDisplayCache *cache)
 
   cache->cursor_line = NULL;
 
+  /* The lines to prefetch may be gone */
+  g_clear_handle_id (&cache->prefetch_source, g_source_remove);
+  cache->prefetch_remaining = 0;
+
   while (cache->mru.head != NULL)
     {
       GtkTextLineDisplay *display = g_queue_peek_head (&cache->mru);
@@ -762,3 +817,131 @@ gtk_text_line_display_cache_set_mru_size (GtkTextLineDisplayCache *cache,
         }
     }
 }
+
+static gboolean
+gtk_text_line_display_cache_prefetch_cb (gpointer data)
+{
+  GtkTextLineDisplayCache *cache = data;
+  GtkTextBTree *btree;
+  gint64 deadline;
+  int n_lines;
+
+  if (cache->layout == NULL || cache->layout->buffer == NULL)
+    {
+      cache->prefetch_source = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  btree = _gtk_text_buffer_get_btree (cache->layout->buffer);
+  n_lines = _gtk_text_btree_line_count (btree);
+  deadline = g_get_monotonic_time () + PREFETCH_BUDGET_USEC;
+
+  while (cache->prefetch_remaining > 0 &&
+         cache->prefetch_line >= 0 &&
+         cache->prefetch_line < n_lines)
+    {
+      GtkTextLine *line;
+
+      line = _gtk_text_btree_get_line_no_last (btree, cache->prefetch_line, NULL);
+
+      if (g_hash_table_lookup (cache->line_to_display, line) == NULL)
+        {
+          GtkTextLineDisplay *display;
+
+          display = gtk_text_layout_create_display (cache->layout, line, FALSE);
+          if (line == cache->cursor_line)
+            gtk_text_layout_update_display_cursors (cache->layout, line, display);
+          if (display->has_children)
+            gtk_text_layout_update_children (cache->layout, display);
+
+          gtk_text_line_display_cache_take_display (cache, display, cache->layout);
+
+          COUNTER_INC (prefetches);
+        }
+
+      cache->prefetch_line += cache->velocity > 0 ? 1 : -1;
+      cache->prefetch_remaining--;
+
+      if (g_get_monotonic_time () >= deadline)
+        return G_SOURCE_CONTINUE;
+    }
+
+  cache->prefetch_source = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * gtk_text_line_display_cache_set_viewport:
+ * @cache: a GtkTextLineDisplayCache
+ * @layout: the layout owning @cache
+ * @y: the top of the visible area
+ * @height: the height of the visible area
+ *
+ * Sizes the cache to hold the visible lines plus the lines that the
+ * current scroll will reach within the next half second, and creates
+ * displays for those lines when idle.
+ */
+void
+gtk_text_line_display_cache_set_viewport (GtkTextLineDisplayCache *cache,
+                                          GtkTextLayout           *layout,
+                                          int                      y,
+                                          int                      height)
+{
+  GtkTextBTree *btree;
+  GtkTextLine *line;
+  int first_line, last_line, n_visible, lookahead;
+  gint64 now;
+
+  g_assert (cache != NULL);
+  g_assert (layout != NULL);
+
+  if (y == cache->viewport_y && height == cache->viewport_height)
+    return;
+
+  btree = _gtk_text_buffer_get_btree (layout->buffer);
+  now = g_get_monotonic_time ();
+
+  line = _gtk_text_btree_find_line_by_y (btree, layout, MAX (y, 0), NULL);
+  first_line = line ? _gtk_text_line_get_number (line) : 0;
+  line = _gtk_text_btree_find_line_by_y (btree, layout, MAX (y + height, 0), NULL);
+  last_line = line ? _gtk_text_line_get_number (line) : _gtk_text_btree_line_count (btree) - 1;
+  n_visible = MAX (last_line - first_line + 1, 1);
+
+  if (cache->layout != NULL && now - cache->viewport_time < SCROLL_TIMEOUT_USEC)
+    {
+      double velocity;
+
+      velocity = (first_line - cache->first_line) * (double) G_USEC_PER_SEC / MAX (now - cache->viewport_time, 1);
+      cache->velocity = (cache->velocity + velocity) / 2;
+    }
+  else
+    cache->velocity = 0;
+
+  cache->layout = layout;
+  cache->viewport_y = y;
+  cache->viewport_height = height;
+  cache->viewport_time = now;
+  cache->first_line = first_line;
+
+  /* Jumps look like fast scrolls, but we won't keep more than
+   * two screens ahead of the visible area.
+   */
+  lookahead = MIN (ABS (cache->velocity) * LOOKAHEAD_SEC, 2 * n_visible);
+
+  gtk_text_line_display_cache_set_mru_size (cache, 3 * n_visible + lookahead);
+
+  if (lookahead > 0)
+    {
+      cache->prefetch_line = cache->velocity > 0 ? last_line + 1 : first_line - 1;
+      cache->prefetch_remaining = lookahead;
+
+      if (cache->prefetch_source == 0)
+        {
+          cache->prefetch_source = g_idle_add (gtk_text_line_display_cache_prefetch_cb, cache);
+          gdk_source_set_static_name_by_id (cache->prefetch_source, "[gtk] gtk_text_line_display_cache_prefetch_cb");
+        }
+    }
+  else
+    g_clear_handle_id (&cache->prefetch_source, g_source_remove);
+}
@@ -56,6 +56,10 @@ void                     gtk_text_line_display_cache_invalidate_y_range (GtkText
                                                                          gboolean                 cursors_only);
 void                     gtk_text_line_display_cache_set_mru_size       (GtkTextLineDisplayCache *cache,
                                                                          guint                    mru_size);
+void                     gtk_text_line_display_cache_set_viewport       (GtkTextLineDisplayCache *cache,
+                                                                         GtkTextLayout           *layout,
+                                                                         int                      y,
+                                                                         int                      height);
 
 G_END_DECLS
 
@@ -181,7 +181,7 @@ set_attributes_from_style (GtkWidget         *widget,
   if (values->font)
     pango_font_description_free (values->font);
 
-  values->font = gtk_css_style_get_pango_font (style);
+  values->font = pango_font_description_copy (gtk_css_style_get_pango_font (style));
 }
 
 static int
@@ -230,6 +230,7 @@ struct _GtkTextViewPrivate
 
   guint first_validate_idle;        /* Idle to revalidate onscreen portion, runs before resize */
   guint incremental_validate_idle;  /* Idle to revalidate offscreen portions, runs after redraw */
+  GCancellable *estimate_cancellable; /* Estimating offscreen portions in a thread */
 
   /* Mark for drop target */
   GtkTextMark *dnd_mark;
@@ -568,6 +569,7 @@ static gboolean gtk_text_view_flush_scroll         (GtkTextView *text_view);
 static void     gtk_text_view_update_adjustments   (GtkTextView *text_view);
 static void     gtk_text_view_invalidate           (GtkTextView *text_view);
 static void     gtk_text_view_flush_first_validate (GtkTextView *text_view);
+static void     gtk_text_view_remove_validate_idles (GtkTextView *text_view);
 
 static void     gtk_text_view_set_hadjustment        (GtkTextView   *text_view,
                                                       GtkAdjustment *adjustment);
@@ -2145,6 +2147,9 @@ gtk_text_view_set_buffer (GtkTextView   *text_view,
 	  gtk_text_buffer_remove_selection_clipboard (priv->buffer, clipboard);
         }
 
+      /* Don't let a pending estimate look at the old buffer */
+      gtk_text_view_remove_validate_idles (text_view);
+
       if (priv->layout)
         gtk_text_layout_set_buffer (priv->layout, NULL);
 
@@ -3856,6 +3861,12 @@ gtk_text_view_remove_validate_idles (GtkTextView *text_view)
       g_source_remove (priv->incremental_validate_idle);
       priv->incremental_validate_idle = 0;
     }
+
+  if (priv->estimate_cancellable)
+    {
+      g_cancellable_cancel (priv->estimate_cancellable);
+      g_clear_object (&priv->estimate_cancellable);
+    }
 }
 
 static void
@@ -4577,8 +4588,6 @@ gtk_text_view_size_allocate (GtkWidget *widget,
   GdkRectangle top_rect;
   GdkRectangle bottom_rect;
   GtkWidget *chooser;
-  PangoLayout *layout;
-  guint mru_size;
 
   text_view = GTK_TEXT_VIEW (widget);
   priv = text_view->priv;
@@ -4664,14 +4673,7 @@ gtk_text_view_size_allocate (GtkWidget *widget,
     gtk_text_view_set_vadjustment_values (text_view);
 
   /* Optimize display cache size */
-  layout = gtk_widget_create_pango_layout (widget, "X");
-  pango_layout_get_pixel_size (layout, &width, &height);
-  if (height > 0)
-    {
-      mru_size = SCREEN_HEIGHT (widget) / height * 3;
-      gtk_text_layout_set_mru_size (priv->layout, mru_size);
-    }
-  g_object_unref (layout);
+  gtk_text_layout_set_viewport (priv->layout, priv->yoffset, SCREEN_HEIGHT (widget));
 
   /* The GTK resize loop processes all the pending exposes right
    * after doing the resize stuff, so the idle sizer won't have a
@@ -4810,14 +4812,61 @@ first_validate_callback (gpointer data)
   return FALSE;
 }
 
+static void gtk_text_view_queue_incremental_validate (GtkTextView *text_view);
+
+static void
+estimate_done_cb (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      data)
+{
+  GtkTextView *text_view = data;
+  GtkTextViewPrivate *priv;
+  GError *error = NULL;
+
+  if (!gtk_text_layout_estimate_finish (GTK_TEXT_LAYOUT (source), result, &error))
+    {
+      /* The view may be gone already */
+      g_error_free (error);
+      return;
+    }
+
+  priv = text_view->priv;
+  g_clear_object (&priv->estimate_cancellable);
+
+  gtk_text_view_update_adjustments (text_view);
+
+  if (!gtk_text_layout_is_valid (priv->layout))
+    gtk_text_view_queue_incremental_validate (text_view);
+}
+
 static gboolean
 incremental_validate_callback (gpointer data)
 {
   GtkTextView *text_view = data;
+  GtkTextViewPrivate *priv = text_view->priv;
   gboolean result = TRUE;
 
   DV(g_print(G_STRLOC"\n"));
 
+  /* Offscreen lines are measured in a thread, the callback
+   * queues us again when it is done.
+   */
+  if (priv->estimate_cancellable == NULL)
+    {
+      priv->estimate_cancellable = g_cancellable_new ();
+      if (!gtk_text_layout_estimate_async (priv->layout,
+                                           priv->estimate_cancellable,
+                                           estimate_done_cb,
+                                           text_view))
+        g_clear_object (&priv->estimate_cancellable);
+    }
+
+  if (priv->estimate_cancellable)
+    {
+      priv->incremental_validate_idle = 0;
+      return FALSE;
+    }
+
   gtk_text_layout_validate (text_view->priv->layout, 2000);
 
   gtk_text_view_update_adjustments (text_view);
@@ -4853,6 +4902,14 @@ gtk_text_view_invalidate (GtkTextView *text_view)
                    priv->first_validate_idle));
     }
 
+  gtk_text_view_queue_incremental_validate (text_view);
+}
+
+static void
+gtk_text_view_queue_incremental_validate (GtkTextView *text_view)
+{
+  GtkTextViewPrivate *priv = text_view->priv;
+
   if (!priv->incremental_validate_idle)
     {
       priv->incremental_validate_idle = g_idle_add_full (GTK_TEXT_VIEW_PRIORITY_VALIDATE, incremental_validate_callback, text_view, NULL);
@@ -7731,7 +7788,7 @@ gtk_text_view_set_attributes_from_style (GtkTextView        *text_view,
   if (values->font)
     pango_font_description_free (values->font);
 
-  values->font = gtk_css_style_get_pango_font (style);
+  values->font = pango_font_description_copy (gtk_css_style_get_pango_font (style));
 
   /* text-decoration */
 
@@ -8421,6 +8478,8 @@ gtk_text_view_value_changed (GtkAdjustment *adjustment,
           gtk_text_buffer_move_mark (get_buffer (text_view), priv->first_para_mark, &iter);
 
           priv->first_para_pixels = gtk_adjustment_get_value (adjustment) - line_top;
+
+          gtk_text_layout_set_viewport (priv->layout, priv->yoffset, SCREEN_HEIGHT (text_view));
         }
     }
 
@@ -23,8 +23,12 @@
 
 #include "gtkrbtreeprivate.h"
 #include "gtkintl.h"
+#include "gtkprefetchmodel.h"
 #include "gtkprivate.h"
 
+/* Number of nodes to expand per idle when expanding incrementally */
+#define GTK_TREE_LIST_MODEL_EXPAND_STEP 256
+
 /**
  * GtkTreeListModel:
  *
@@ -34,6 +38,7 @@
 enum {
   PROP_0,
   PROP_AUTOEXPAND,
+  PROP_INCREMENTAL,
   PROP_ITEM_TYPE,
   PROP_MODEL,
   PROP_N_ITEMS,
@@ -56,12 +61,14 @@ struct _TreeNode
 
   guint empty : 1;
   guint is_root : 1;
+  guint pending : 1; /* waiting to be autoexpanded */
 };
 
 struct _TreeAugment
 {
   guint n_items;
   guint n_local;
+  guint n_pending; /* pending nodes, including those in child trees */
 };
 
 struct _GtkTreeListModel
@@ -75,7 +82,11 @@ struct _GtkTreeListModel
   GDestroyNotify user_destroy;
 
   guint autoexpand : 1;
+  guint incremental : 1;
   guint passthrough : 1;
+
+  guint pending_cb; /* idle callback handle */
+  guint pending_position; /* where to continue expanding or G_MAXUINT */
 };
 
 struct _GtkTreeListModelClass
@@ -160,6 +171,80 @@ tree_node_get_n_children (TreeNode *node)
   return child_aug->n_items;
 }
 
+static guint
+tree_node_get_n_pending (TreeNode *node)
+{
+  TreeAugment *child_aug;
+  TreeNode *child_node;
+
+  if (node->children == NULL)
+    return 0;
+
+  child_node = gtk_rb_tree_get_root (node->children);
+  if (child_node == NULL)
+    return 0;
+
+  child_aug = gtk_rb_tree_get_augment (node->children, child_node);
+
+  return child_aug->n_pending;
+}
+
+/*
+ * tree_node_find_pending:
+ * @tree: the tree containing @node
+ * @node: (nullable): the root of the subtree to search
+ * @position: position relative to the first item of the subtree
+ *
+ * Finds the first pending node at or after @position, looking into
+ * child trees, too. Subtrees without pending nodes are skipped, so
+ * this takes logarithmic time.
+ *
+ * Returns: (nullable): the pending node
+ */
+static TreeNode *
+tree_node_find_pending (GtkRbTree *tree,
+                        TreeNode  *node,
+                        guint      position)
+{
+  TreeNode *left, *result;
+  TreeAugment *aug;
+  guint n_children;
+
+  if (node == NULL)
+    return NULL;
+
+  aug = gtk_rb_tree_get_augment (tree, node);
+  if (aug->n_pending == 0 || position >= aug->n_items)
+    return NULL;
+
+  left = gtk_rb_tree_node_get_left (node);
+  if (left)
+    {
+      TreeAugment *left_aug = gtk_rb_tree_get_augment (tree, left);
+
+      result = tree_node_find_pending (tree, left, position);
+      if (result)
+        return result;
+
+      position -= MIN (position, left_aug->n_items);
+    }
+
+  if (position == 0 && node->pending)
+    return node;
+  position -= MIN (position, 1);
+
+  if (node->children)
+    {
+      result = tree_node_find_pending (node->children, gtk_rb_tree_get_root (node->children), position);
+      if (result)
+        return result;
+    }
+  n_children = tree_node_get_n_children (node);
+  position -= MIN (position, n_children);
+
+  return tree_node_find_pending (tree, gtk_rb_tree_node_get_right (node), position);
+}
+
 static guint
 tree_node_get_local_position (GtkRbTree *tree,
                               TreeNode  *node)
@@ -270,12 +355,14 @@ gtk_tree_list_model_get_nth (GtkTreeListModel *self,
 {
   GtkRbTree *tree;
   TreeNode *node, *tmp;
-  guint n_children;
+  guint n_children, requested;
 
   n_children = tree_node_get_n_children (&self->root_node);
   if (n_children <= position)
     return NULL;
 
+  requested = position;
+
   tree = self->root_node.children;
   node = gtk_rb_tree_get_root (tree);
 
@@ -294,7 +381,12 @@ gtk_tree_list_model_get_nth (GtkTreeListModel *self,
         }
 
       if (position == 0)
-        return node;
+        {
+          /* Someone is looking at this row, so expand it next */
+          if (node->pending)
+            self->pending_position = MIN (self->pending_position, requested);
+          return node;
+        }
 
       position--;
 
@@ -360,6 +452,9 @@ tree_node_get_row (TreeNode *node)
 static guint
 gtk_tree_list_model_expand_node (GtkTreeListModel *self,
                                  TreeNode         *node);
+static guint
+gtk_tree_list_model_autoexpand_node (GtkTreeListModel *self,
+                                     TreeNode         *node);
 
 static void
 gtk_tree_list_model_items_changed_cb (GListModel *model,
@@ -423,7 +518,7 @@ gtk_tree_list_model_items_changed_cb (GListModel *model,
     {
       for (i = 0; i < added; i++)
         {
-          tree_added += gtk_tree_list_model_expand_node (self, child);
+          tree_added += gtk_tree_list_model_autoexpand_node (self, child);
           child = gtk_rb_tree_node_get_next (child);
         }
     }
@@ -439,6 +534,7 @@ gtk_tree_list_model_items_changed_cb (GListModel *model,
 }
 
 static void gtk_tree_list_row_destroy (GtkTreeListRow *row);
+static void gtk_tree_list_row_expanded_changed (GtkTreeListRow *row);
 
 static void
 gtk_tree_list_model_clear_node_children (TreeNode *node)
@@ -477,18 +573,22 @@ gtk_tree_list_model_augment (GtkRbTree *tree,
   aug->n_items = 1;
   aug->n_items += tree_node_get_n_children (_node);
   aug->n_local = 1;
+  aug->n_pending = ((TreeNode *) _node)->pending;
+  aug->n_pending += tree_node_get_n_pending (_node);
 
   if (left)
     {
       TreeAugment *left_aug = gtk_rb_tree_get_augment (tree, left);
       aug->n_items += left_aug->n_items;
       aug->n_local += left_aug->n_local;
+      aug->n_pending += left_aug->n_pending;
     }
   if (right)
     {
       TreeAugment *right_aug = gtk_rb_tree_get_augment (tree, right);
       aug->n_items += right_aug->n_items;
       aug->n_local += right_aug->n_local;
+      aug->n_pending += right_aug->n_pending;
     }
 }
 
@@ -518,7 +618,7 @@ gtk_tree_list_model_init_node (GtkTreeListModel *list,
       node = gtk_rb_tree_insert_after (self->children, node);
       node->parent = self;
       if (list->autoexpand)
-        gtk_tree_list_model_expand_node (list, node);
+        gtk_tree_list_model_autoexpand_node (list, node);
     }
 }
 
@@ -564,6 +664,133 @@ gtk_tree_list_model_collapse_node (GtkTreeListModel *self,
   return n_items;
 }
 
+/*
+ * gtk_tree_list_model_expand_pending:
+ * @self: a `GtkTreeListModel`
+ * @n_steps: maximum number of nodes to expand
+ *
+ * Expands nodes that are waiting to be autoexpanded, starting with
+ * the ones that were looked at last. Each expansion is emitted
+ * right away.
+ *
+ * Returns: %TRUE if no pending nodes are left
+ */
+static gboolean
+gtk_tree_list_model_expand_pending (GtkTreeListModel *self,
+                                    guint             n_steps)
+{
+  GtkRbTree *tree = self->root_node.children;
+  GtkTreeListRow *row;
+  TreeNode *node;
+  guint i, n_items;
+
+  for (i = 0; i < n_steps; i++)
+    {
+      node = NULL;
+      if (self->pending_position != G_MAXUINT)
+        {
+          node = tree_node_find_pending (tree, gtk_rb_tree_get_root (tree), self->pending_position);
+          if (node == NULL)
+            self->pending_position = G_MAXUINT;
+        }
+      if (node == NULL)
+        node = tree_node_find_pending (tree, gtk_rb_tree_get_root (tree), 0);
+      if (node == NULL)
+        return TRUE;
+
+      node->pending = FALSE;
+      tree_node_mark_dirty (node);
+
+      /* Handlers of items-changed may free the node */
+      row = node->row ? g_object_ref (node->row) : NULL;
+
+      n_items = gtk_tree_list_model_expand_node (self, node);
+      if (n_items > 0)
+        {
+          g_list_model_items_changed (G_LIST_MODEL (self), tree_node_get_position (node) + 1, 0, n_items);
+          g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+        }
+      if (row)
+        {
+          gtk_tree_list_row_expanded_changed (row);
+          g_object_unref (row);
+        }
+    }
+
+  return tree_node_get_n_pending (&self->root_node) == 0;
+}
+
+static void
+gtk_tree_list_model_stop_expanding (GtkTreeListModel *self)
+{
+  g_clear_handle_id (&self->pending_cb, g_source_remove);
+  self->pending_position = G_MAXUINT;
+}
+
+/*
+ * gtk_tree_list_model_clear_pending:
+ * @node: the node whose children to clear
+ *
+ * Unmarks all pending rows below @node, skipping subtrees
+ * without any.
+ */
+static void
+gtk_tree_list_model_clear_pending (TreeNode *node)
+{
+  TreeNode *child;
+
+  if (tree_node_get_n_pending (node) == 0)
+    return;
+
+  for (child = gtk_rb_tree_get_first (node->children);
+       child != NULL;
+       child = gtk_rb_tree_node_get_next (child))
+    {
+      child->pending = FALSE;
+      gtk_tree_list_model_clear_pending (child);
+      gtk_rb_tree_node_mark_dirty (child);
+    }
+}
+
+static gboolean
+gtk_tree_list_model_expand_pending_cb (gpointer data)
+{
+  GtkTreeListModel *self = data;
+
+  if (gtk_tree_list_model_expand_pending (self, GTK_TREE_LIST_MODEL_EXPAND_STEP))
+    {
+      gtk_tree_list_model_stop_expanding (self);
+      return G_SOURCE_REMOVE;
+    }
+
+  /* rows looked at until the next run tell us where to continue */
+  self->pending_position = G_MAXUINT;
+
+  return G_SOURCE_CONTINUE;
+}
+
+static guint
+gtk_tree_list_model_autoexpand_node (GtkTreeListModel *self,
+                                     TreeNode         *node)
+{
+  if (!self->incremental)
+    return gtk_tree_list_model_expand_node (self, node);
+
+  if (node->empty || node->model != NULL)
+    return 0;
+
+  node->pending = TRUE;
+  gtk_rb_tree_node_mark_dirty (node);
+
+  if (self->pending_cb == 0)
+    {
+      self->pending_cb = g_idle_add (gtk_tree_list_model_expand_pending_cb, self);
+      gdk_source_set_static_name_by_id (self->pending_cb, "[gtk] gtk_tree_list_model_expand_pending_cb");
+    }
+
+  return 0;
+}
+
 
 static GType
 gtk_tree_list_model_get_item_type (GListModel *list)
@@ -613,8 +840,55 @@ gtk_tree_list_model_model_init (GListModelInterface *iface)
   iface->get_item = gtk_tree_list_model_get_item;
 }
 
+/*
+ * gtk_tree_list_model_queue_expand:
+ * @self: a `GtkTreeListModel`
+ * @node: the node whose children to queue
+ *
+ * Marks all collapsed rows below @node as pending, so they get
+ * autoexpanded incrementally.
+ */
+static void
+gtk_tree_list_model_queue_expand (GtkTreeListModel *self,
+                                  TreeNode         *node)
+{
+  TreeNode *child;
+
+  for (child = gtk_rb_tree_get_first (node->children);
+       child != NULL;
+       child = gtk_rb_tree_node_get_next (child))
+    {
+      if (child->children)
+        {
+          gtk_tree_list_model_queue_expand (self, child);
+          gtk_rb_tree_node_mark_dirty (child);
+        }
+      else
+        gtk_tree_list_model_autoexpand_node (self, child);
+    }
+}
+
+static void
+gtk_tree_list_model_prefetch (GtkPrefetchModel *model,
+                              guint             position,
+                              guint             n_items)
+{
+  GtkTreeListModel *self = GTK_TREE_LIST_MODEL (model);
+
+  /* Rows that are being looked at right now take precedence */
+  if (self->pending_cb)
+    self->pending_position = MIN (self->pending_position, position);
+}
+
+static void
+gtk_tree_list_model_prefetch_model_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = gtk_tree_list_model_prefetch;
+}
+
 G_DEFINE_TYPE_WITH_CODE (GtkTreeListModel, gtk_tree_list_model, G_TYPE_OBJECT,
-                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_tree_list_model_model_init))
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_tree_list_model_model_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_PREFETCH_MODEL, gtk_tree_list_model_prefetch_model_init))
 
 static void
 gtk_tree_list_model_set_property (GObject      *object,
@@ -630,6 +904,10 @@ gtk_tree_list_model_set_property (GObject      *object,
       gtk_tree_list_model_set_autoexpand (self, g_value_get_boolean (value));
       break;
 
+    case PROP_INCREMENTAL:
+      gtk_tree_list_model_set_incremental (self, g_value_get_boolean (value));
+      break;
+
     case PROP_PASSTHROUGH:
       self->passthrough = g_value_get_boolean (value);
       break;
@@ -654,6 +932,10 @@ gtk_tree_list_model_get_property (GObject     *object,
       g_value_set_boolean (value, self->autoexpand);
       break;
 
+    case PROP_INCREMENTAL:
+      g_value_set_boolean (value, self->incremental);
+      break;
+
     case PROP_ITEM_TYPE:
       g_value_set_gtype (value, gtk_tree_list_model_get_item_type (G_LIST_MODEL (self)));
       break;
@@ -681,6 +963,7 @@ gtk_tree_list_model_finalize (GObject *object)
 {
   GtkTreeListModel *self = GTK_TREE_LIST_MODEL (object);
 
+  gtk_tree_list_model_stop_expanding (self);
   gtk_tree_list_model_clear_node (&self->root_node);
   if (self->user_destroy)
     self->user_destroy (self->user_data);
@@ -707,6 +990,18 @@ gtk_tree_list_model_class_init (GtkTreeListModelClass *class)
                             FALSE,
                             GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkTreeListModel:incremental: (attributes org.gtk.Property.get=gtk_tree_list_model_get_incremental org.gtk.Property.set=gtk_tree_list_model_set_incremental)
+   *
+   * If rows should be autoexpanded incrementally.
+   *
+   * Since: 4.8
+   */
+  properties[PROP_INCREMENTAL] =
+      g_param_spec_boolean ("incremental", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkTreeListModel:item-type:
    *
@@ -763,6 +1058,7 @@ gtk_tree_list_model_init (GtkTreeListModel *self)
 {
   self->root_node.list = self;
   self->root_node.is_root = TRUE;
+  self->pending_position = G_MAXUINT;
 }
 
 /**
@@ -858,6 +1154,9 @@ gtk_tree_list_model_get_passthrough (GtkTreeListModel *self)
  * If set to %TRUE, the model will recursively expand all rows that
  * get added to the model. This can be either rows added by changes
  * to the underlying models or via [method@Gtk.TreeListRow.set_expanded].
+ *
+ * If the model expands rows incrementally, turning on autoexpand
+ * will also expand the rows that are already in the model.
  */
 void
 gtk_tree_list_model_set_autoexpand (GtkTreeListModel *self,
@@ -870,6 +1169,16 @@ gtk_tree_list_model_set_autoexpand (GtkTreeListModel *self,
 
   self->autoexpand = autoexpand;
 
+  if (autoexpand && self->incremental)
+    {
+      gtk_tree_list_model_queue_expand (self, &self->root_node);
+    }
+  else if (!autoexpand)
+    {
+      gtk_tree_list_model_stop_expanding (self);
+      gtk_tree_list_model_clear_pending (&self->root_node);
+    }
+
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_AUTOEXPAND]);
 }
 
@@ -893,6 +1202,68 @@ gtk_tree_list_model_get_autoexpand (GtkTreeListModel *self)
   return self->autoexpand;
 }
 
+/**
+ * gtk_tree_list_model_set_incremental: (attributes org.gtk.Method.set_property=incremental)
+ * @self: a `GtkTreeListModel`
+ * @incremental: %TRUE to autoexpand rows incrementally
+ *
+ * Sets whether rows should be autoexpanded incrementally.
+ *
+ * When incremental expansion is enabled, the `GtkTreeListModel` will not
+ * create the child models for autoexpanded rows immediately, but will
+ * instead queue an idle handler that expands the rows a few at a time.
+ * Rows that are looked at, for example because they are visible in a
+ * list widget, are expanded first.
+ *
+ * This means the number of items is not final when the model is created
+ * and grows while the rows are expanded. When your tree is large, you
+ * might consider turning this on and only setting
+ * [property@Gtk.TreeListModel:autoexpand] afterwards.
+ *
+ * By default, incremental expansion is disabled.
+ *
+ * Since: 4.8
+ */
+void
+gtk_tree_list_model_set_incremental (GtkTreeListModel *self,
+                                     gboolean          incremental)
+{
+  g_return_if_fail (GTK_IS_TREE_LIST_MODEL (self));
+
+  if (self->incremental == incremental)
+    return;
+
+  self->incremental = incremental;
+
+  if (!incremental && self->pending_cb)
+    {
+      gtk_tree_list_model_expand_pending (self, G_MAXUINT);
+      gtk_tree_list_model_stop_expanding (self);
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_INCREMENTAL]);
+}
+
+/**
+ * gtk_tree_list_model_get_incremental: (attributes org.gtk.Method.get_property=incremental)
+ * @self: a `GtkTreeListModel`
+ *
+ * Returns whether rows are autoexpanded incrementally.
+ *
+ * See [method@Gtk.TreeListModel.set_incremental].
+ *
+ * Returns: %TRUE if incremental expansion is enabled
+ *
+ * Since: 4.8
+ */
+gboolean
+gtk_tree_list_model_get_incremental (GtkTreeListModel *self)
+{
+  g_return_val_if_fail (GTK_IS_TREE_LIST_MODEL (self), FALSE);
+
+  return self->incremental;
+}
+
 /**
  * gtk_tree_list_model_get_row:
  * @self: a `GtkTreeListModel`
@@ -1008,6 +1379,13 @@ gtk_tree_list_row_destroy (GtkTreeListRow *self)
   g_object_thaw_notify (G_OBJECT (self));
 }
 
+static void
+gtk_tree_list_row_expanded_changed (GtkTreeListRow *self)
+{
+  g_object_notify_by_pspec (G_OBJECT (self), row_properties[ROW_PROP_EXPANDED]);
+  g_object_notify_by_pspec (G_OBJECT (self), row_properties[ROW_PROP_CHILDREN]);
+}
+
 static void
 gtk_tree_list_row_set_property (GObject      *object,
                                 guint         prop_id,
@@ -1223,6 +1601,13 @@ gtk_tree_list_row_set_expanded (GtkTreeListRow *self,
   if (self->node == NULL)
     return;
 
+  /* An explicit choice overrides a pending autoexpand */
+  if (self->node->pending)
+    {
+      self->node->pending = FALSE;
+      tree_node_mark_dirty (self->node);
+    }
+
   was_expanded = self->node->children != NULL;
   if (was_expanded == expanded)
     return;
@@ -74,6 +74,11 @@ void                    gtk_tree_list_model_set_autoexpand      (GtkTreeListMode
                                                                  gboolean                autoexpand);
 GDK_AVAILABLE_IN_ALL
 gboolean                gtk_tree_list_model_get_autoexpand      (GtkTreeListModel       *self);
+GDK_AVAILABLE_IN_4_8
+void                    gtk_tree_list_model_set_incremental     (GtkTreeListModel       *self,
+                                                                 gboolean                incremental);
+GDK_AVAILABLE_IN_4_8
+gboolean                gtk_tree_list_model_get_incremental     (GtkTreeListModel       *self);
 
 GDK_AVAILABLE_IN_ALL
 GtkTreeListRow *        gtk_tree_list_model_get_child_row       (GtkTreeListModel       *self,
@@ -6401,16 +6401,13 @@ gtk_widget_update_pango_context (GtkWidget        *widget,
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
   GtkCssStyle *style = gtk_css_node_get_style (priv->cssnode);
-  PangoFontDescription *font_desc;
   GtkSettings *settings;
   cairo_font_options_t *font_options;
   guint old_serial;
 
   old_serial = pango_context_get_serial (context);
 
-  font_desc = gtk_css_style_get_pango_font (style);
-  pango_context_set_font_description (context, font_desc);
-  pango_font_description_free (font_desc);
+  pango_context_set_font_description (context, gtk_css_style_get_pango_font (style));
 
   settings = gtk_widget_get_settings (widget);
 
@@ -52,6 +52,8 @@ enum {
   COLUMN_NODE_CLASSES,
   COLUMN_NODE_ID,
   COLUMN_NODE_STATE,
+  COLUMN_NODE_CHANGE,
+  COLUMN_NODE_N_VALIDATED,
   /* add more */
   N_NODE_COLUMNS
 };
@@ -336,6 +338,14 @@ gtk_inspector_css_node_tree_get_node_value (GtkTreeModelCssNode *model,
       g_value_take_string (value, format_state_flags (gtk_css_node_get_state (node)));
       break;
 
+    case COLUMN_NODE_CHANGE:
+      g_value_take_string (value, gtk_css_change_to_string (gtk_css_node_get_validated_changes (node)));
+      break;
+
+    case COLUMN_NODE_N_VALIDATED:
+      g_value_set_uint (value, gtk_css_node_get_n_validated (node));
+      break;
+
     default:
       g_assert_not_reached ();
       break;
@@ -358,7 +368,9 @@ gtk_inspector_css_node_tree_init (GtkInspectorCssNodeTree *cnt)
                                                   G_TYPE_BOOLEAN,
                                                   G_TYPE_STRING,
                                                   G_TYPE_STRING,
-                                                  G_TYPE_STRING);
+                                                  G_TYPE_STRING,
+                                                  G_TYPE_STRING,
+                                                  G_TYPE_UINT);
   gtk_tree_view_set_model (GTK_TREE_VIEW (priv->node_tree), priv->node_model);
   g_object_unref (priv->node_model);
 
@@ -268,6 +268,86 @@ gtk_tim_sort_set_max_merge_size (GtkTimSort *self,
   self->max_merge_size = max_merge_size;
 }
 
+typedef struct _GtkTimSortChunk GtkTimSortChunk;
+
+struct _GtkTimSortChunk
+{
+  GtkTimSort *self;
+  gpointer base;
+  gsize size;
+};
+
+static gpointer
+gtk_tim_sort_chunk_thread (gpointer data)
+{
+  GtkTimSortChunk *chunk = data;
+
+  gtk_tim_sort (chunk->base,
+                chunk->size,
+                chunk->self->element_size,
+                chunk->self->compare_func,
+                chunk->self->data);
+
+  return NULL;
+}
+
+/*<private>
+ * gtk_tim_sort_presort_parallel:
+ * @self: a GtkTimSort
+ * @n_threads: number of threads to use
+ * @out_change: (optional): Return location for changed area
+ *
+ * Splits the part of the array that has not been turned into runs
+ * yet into @n_threads chunks, sorts those chunks in parallel and
+ * pushes them as runs. Subsequent calls to gtk_tim_sort_step() only
+ * need to merge them.
+ *
+ * The compare function must be safe to call from multiple threads
+ * at the same time. One of the chunks is sorted in the calling thread.
+ **/
+void
+gtk_tim_sort_presort_parallel (GtkTimSort    *self,
+                               guint          n_threads,
+                               GtkTimSortRun *out_change)
+{
+  GtkTimSortChunk *chunks;
+  GThread **threads;
+  gsize i, chunk_size;
+
+  g_return_if_fail (self != NULL);
+
+  n_threads = MIN (n_threads, GTK_TIM_SORT_MAX_PENDING - self->pending_runs);
+  if (n_threads <= 1 || self->size < n_threads * MIN_MERGE)
+    {
+      gtk_tim_sort_set_change (out_change, NULL, 0);
+      return;
+    }
+
+  gtk_tim_sort_set_change (out_change, self->base, self->size);
+
+  chunks = g_newa (GtkTimSortChunk, n_threads);
+  threads = g_newa (GThread *, n_threads);
+  chunk_size = self->size / n_threads;
+
+  for (i = 0; i < n_threads; i++)
+    {
+      chunks[i].self = self;
+      chunks[i].base = ((char *) self->base) + i * chunk_size * self->element_size;
+      chunks[i].size = i + 1 < n_threads ? chunk_size : self->size - i * chunk_size;
+    }
+
+  for (i = 1; i < n_threads; i++)
+    threads[i] = g_thread_new ("GTK sort", gtk_tim_sort_chunk_thread, &chunks[i]);
+
+  gtk_tim_sort_chunk_thread (&chunks[0]);
+
+  for (i = 1; i < n_threads; i++)
+    g_thread_join (threads[i]);
+
+  for (i = 0; i < n_threads; i++)
+    gtk_tim_sort_push_run (self, self->base, chunks[i].size);
+}
+
 /**
  * gtk_tim_sort_get_progress:
  * @self: a GtkTimSort
@@ -108,6 +108,10 @@ void            gtk_tim_sort_set_runs                           (GtkTimSort
 void            gtk_tim_sort_set_max_merge_size                 (GtkTimSort             *self,
                                                                  gsize                   max_merge_size);
 
+void            gtk_tim_sort_presort_parallel                   (GtkTimSort             *self,
+                                                                 guint                   n_threads,
+                                                                 GtkTimSortRun          *out_change);
+
 gsize           gtk_tim_sort_get_progress                       (GtkTimSort             *self);
 
 gboolean        gtk_tim_sort_step                               (GtkTimSort             *self,
@@ -0,0 +1,641 @@
+/* -*- mode: C; c-basic-offset: 2; indent-tabs-mode: nil; -*- */
+
+/* Runs a script of scrolling, sorting, filtering and selection
+ * changes against a list widget showing a huge model and prints
+ * timings for every frame.
+ *
+ * The output has one line per frame with tab-separated columns,
+ * lines starting with # are comments:
+ *
+ *   phase frame measure allocate snapshot items_changed added removed n_items
+ *
+ * Times are in microseconds and cover the list widget and everything
+ * inside it. The items-changed columns count the emissions and the
+ * number of added and removed items of the selection model.
+ */
+
+#include <gtk/gtk.h>
+#include <stdlib.h>
+
+/* {{{ TimedBin: a widget that measures the time spent in its child */
+
+#define TIMED_TYPE_BIN (timed_bin_get_type ())
+G_DECLARE_FINAL_TYPE (TimedBin, timed_bin, TIMED, BIN, GtkWidget)
+
+struct _TimedBin
+{
+  GtkWidget parent_instance;
+
+  GtkWidget *child;
+
+  gint64 measure_time;
+  gint64 allocate_time;
+  gint64 snapshot_time;
+};
+
+G_DEFINE_TYPE (TimedBin, timed_bin, GTK_TYPE_WIDGET)
+
+static void
+timed_bin_measure (GtkWidget      *widget,
+                   GtkOrientation  orientation,
+                   int             for_size,
+                   int            *minimum,
+                   int            *natural,
+                   int            *minimum_baseline,
+                   int            *natural_baseline)
+{
+  TimedBin *self = TIMED_BIN (widget);
+  gint64 start = g_get_monotonic_time ();
+
+  gtk_widget_measure (self->child, orientation, for_size,
+                      minimum, natural,
+                      minimum_baseline, natural_baseline);
+
+  self->measure_time += g_get_monotonic_time () - start;
+}
+
+static void
+timed_bin_size_allocate (GtkWidget *widget,
+                         int        width,
+                         int        height,
+                         int        baseline)
+{
+  TimedBin *self = TIMED_BIN (widget);
+  gint64 start = g_get_monotonic_time ();
+
+  gtk_widget_allocate (self->child, width, height, baseline, NULL);
+
+  self->allocate_time += g_get_monotonic_time () - start;
+}
+
+static void
+timed_bin_snapshot (GtkWidget   *widget,
+                    GtkSnapshot *snapshot)
+{
+  TimedBin *self = TIMED_BIN (widget);
+  gint64 start = g_get_monotonic_time ();
+
+  gtk_widget_snapshot_child (widget, self->child, snapshot);
+
+  self->snapshot_time += g_get_monotonic_time () - start;
+}
+
+static void
+timed_bin_dispose (GObject *object)
+{
+  TimedBin *self = TIMED_BIN (object);
+
+  g_clear_pointer (&self->child, gtk_widget_unparent);
+
+  G_OBJECT_CLASS (timed_bin_parent_class)->dispose (object);
+}
+
+static void
+timed_bin_class_init (TimedBinClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (class);
+
+  object_class->dispose = timed_bin_dispose;
+
+  widget_class->measure = timed_bin_measure;
+  widget_class->size_allocate = timed_bin_size_allocate;
+  widget_class->snapshot = timed_bin_snapshot;
+}
+
+static void
+timed_bin_init (TimedBin *self)
+{
+}
+
+static GtkWidget *
+timed_bin_new (GtkWidget *child)
+{
+  TimedBin *self = g_object_new (TIMED_TYPE_BIN, NULL);
+
+  self->child = child;
+  gtk_widget_set_parent (child, GTK_WIDGET (self));
+
+  return GTK_WIDGET (self);
+}
+
+/* }}} */
+/* {{{ Models */
+
+static guint opt_items = 1000000;
+static char *opt_widget = NULL;
+static gboolean opt_tree = FALSE;
+static gboolean opt_incremental = FALSE;
+static int opt_seed = 42;
+
+static GOptionEntry options[] = {
+  { "items", 'n', 0, G_OPTION_ARG_INT, &opt_items, "Number of items in the model", "COUNT" },
+  { "widget", 'w', 0, G_OPTION_ARG_STRING, &opt_widget, "Widget to test: list, grid or column", "WIDGET" },
+  { "tree", 't', 0, G_OPTION_ARG_NONE, &opt_tree, "Put a tree list model on top", NULL },
+  { "incremental", 'i', 0, G_OPTION_ARG_NONE, &opt_incremental, "Sort and filter incrementally", NULL },
+  { "seed", 0, 0, G_OPTION_ARG_INT, &opt_seed, "Seed for the random numbers (default: 42)", "SEED" },
+  { NULL }
+};
+
+static GtkSortListModel *sort_model;
+static GtkFilterListModel *filter_model;
+static GtkTreeListModel *tree_model;
+static GtkMultiSelection *selection;
+static GtkScrolledWindow *scrolled_window;
+static TimedBin *timed_bin;
+
+static guint items_changed;
+static guint items_added;
+static guint items_removed;
+
+static void
+items_changed_cb (GListModel *model,
+                  guint       position,
+                  guint       removed,
+                  guint       added,
+                  gpointer    data)
+{
+  items_changed++;
+  items_added += added;
+  items_removed += removed;
+}
+
+static GListModel *
+create_string_list (guint n_items)
+{
+  GtkStringList *list;
+  char **strings;
+  guint i;
+
+  strings = g_new (char *, n_items + 1);
+  for (i = 0; i < n_items; i++)
+    strings[i] = g_strdup_printf ("%u", g_random_int ());
+  strings[n_items] = NULL;
+
+  list = gtk_string_list_new ((const char * const *) strings);
+  g_strfreev (strings);
+
+  return G_LIST_MODEL (list);
+}
+
+static GListModel *
+create_children (gpointer item,
+                 gpointer data)
+{
+  return create_string_list (10);
+}
+
+static GtkExpression *
+create_string_expression (void)
+{
+  return gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string");
+}
+
+static guint
+get_string_length (GtkStringObject *object)
+{
+  return strlen (gtk_string_object_get_string (object));
+}
+
+static GtkSelectionModel *
+create_model (void)
+{
+  GListModel *model;
+  GtkFilter *filter;
+  gint64 start;
+
+  start = g_get_monotonic_time ();
+  model = create_string_list (opt_items);
+  g_print ("# creating %u items: %uus\n", opt_items, (guint) (g_get_monotonic_time () - start));
+
+  filter = GTK_FILTER (gtk_string_filter_new (create_string_expression ()));
+  filter_model = gtk_filter_list_model_new (model, filter);
+  gtk_filter_list_model_set_incremental (filter_model, opt_incremental);
+
+  sort_model = gtk_sort_list_model_new (G_LIST_MODEL (filter_model), NULL);
+  gtk_sort_list_model_set_incremental (sort_model, opt_incremental);
+  model = G_LIST_MODEL (sort_model);
+
+  if (opt_tree)
+    {
+      tree_model = gtk_tree_list_model_new (model, FALSE, FALSE, create_children, NULL, NULL);
+      model = G_LIST_MODEL (tree_model);
+    }
+
+  selection = gtk_multi_selection_new (model);
+  g_signal_connect (selection, "items-changed", G_CALLBACK (items_changed_cb), NULL);
+
+  return GTK_SELECTION_MODEL (selection);
+}
+
+/* }}} */
+/* {{{ Widgets */
+
+static void
+setup_name (GtkSignalListItemFactory *factory,
+            GtkListItem              *list_item)
+{
+  GtkWidget *label;
+
+  label = gtk_label_new (NULL);
+  gtk_label_set_xalign (GTK_LABEL (label), 0);
+
+  if (opt_tree)
+    {
+      GtkWidget *expander = gtk_tree_expander_new ();
+      gtk_tree_expander_set_child (GTK_TREE_EXPANDER (expander), label);
+      gtk_list_item_set_child (list_item, expander);
+    }
+  else
+    gtk_list_item_set_child (list_item, label);
+}
+
+static GtkStringObject *
+get_string_object (GtkListItem *list_item)
+{
+  gpointer item = gtk_list_item_get_item (list_item);
+
+  if (GTK_IS_TREE_LIST_ROW (item))
+    {
+      GtkStringObject *result = gtk_tree_list_row_get_item (item);
+      g_object_unref (result);
+      return result;
+    }
+
+  return item;
+}
+
+static void
+bind_name (GtkSignalListItemFactory *factory,
+           GtkListItem              *list_item)
+{
+  GtkWidget *child = gtk_list_item_get_child (list_item);
+
+  if (GTK_IS_TREE_EXPANDER (child))
+    {
+      gtk_tree_expander_set_list_row (GTK_TREE_EXPANDER (child), gtk_list_item_get_item (list_item));
+      child = gtk_tree_expander_get_child (GTK_TREE_EXPANDER (child));
+    }
+
+  gtk_label_set_label (GTK_LABEL (child),
+                       gtk_string_object_get_string (get_string_object (list_item)));
+}
+
+static void
+setup_length (GtkSignalListItemFactory *factory,
+              GtkListItem              *list_item)
+{
+  GtkWidget *label;
+
+  label = gtk_label_new (NULL);
+  gtk_label_set_xalign (GTK_LABEL (label), 1);
+  gtk_list_item_set_child (list_item, label);
+}
+
+static void
+bind_length (GtkSignalListItemFactory *factory,
+             GtkListItem              *list_item)
+{
+  char *text;
+
+  text = g_strdup_printf ("%u", get_string_length (get_string_object (list_item)));
+  gtk_label_set_label (GTK_LABEL (gtk_list_item_get_child (list_item)), text);
+  g_free (text);
+}
+
+static GtkListItemFactory *
+create_factory (GCallback setup,
+                GCallback bind)
+{
+  GtkListItemFactory *factory;
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", setup, NULL);
+  g_signal_connect (factory, "bind", bind, NULL);
+
+  return factory;
+}
+
+static GtkWidget *
+create_list_widget (GtkSelectionModel *model)
+{
+  if (opt_widget == NULL || g_str_equal (opt_widget, "list"))
+    {
+      return gtk_list_view_new (model, create_factory (G_CALLBACK (setup_name), G_CALLBACK (bind_name)));
+    }
+  else if (g_str_equal (opt_widget, "grid"))
+    {
+      GtkWidget *grid;
+
+      grid = gtk_grid_view_new (model, create_factory (G_CALLBACK (setup_name), G_CALLBACK (bind_name)));
+      gtk_grid_view_set_max_columns (GTK_GRID_VIEW (grid), 8);
+
+      return grid;
+    }
+  else if (g_str_equal (opt_widget, "column"))
+    {
+      GtkWidget *column_view;
+      GtkColumnViewColumn *column;
+
+      column_view = gtk_column_view_new (model);
+
+      column = gtk_column_view_column_new ("Name", create_factory (G_CALLBACK (setup_name), G_CALLBACK (bind_name)));
+      gtk_column_view_column_set_expand (column, TRUE);
+      gtk_column_view_append_column (GTK_COLUMN_VIEW (column_view), column);
+      g_object_unref (column);
+
+      column = gtk_column_view_column_new ("Length", create_factory (G_CALLBACK (setup_length), G_CALLBACK (bind_length)));
+      gtk_column_view_append_column (GTK_COLUMN_VIEW (column_view), column);
+      g_object_unref (column);
+
+      return column_view;
+    }
+  else
+    {
+      g_printerr ("Unknown widget \"%s\", use list, grid or column\n", opt_widget);
+      exit (1);
+    }
+}
+
+/* }}} */
+/* {{{ Script */
+
+typedef struct {
+  const char *name;
+  guint n_frames;
+  void (* step) (guint frame);
+} Phase;
+
+static void
+set_scroll_fraction (double fraction)
+{
+  GtkAdjustment *adjustment = gtk_scrolled_window_get_vadjustment (scrolled_window);
+
+  gtk_adjustment_set_value (adjustment,
+                            fraction * (gtk_adjustment_get_upper (adjustment)
+                                        - gtk_adjustment_get_page_size (adjustment)));
+}
+
+static void
+scroll_step (guint frame)
+{
+  GtkAdjustment *adjustment = gtk_scrolled_window_get_vadjustment (scrolled_window);
+
+  gtk_adjustment_set_value (adjustment,
+                            gtk_adjustment_get_value (adjustment)
+                            + gtk_adjustment_get_page_size (adjustment) / 2);
+}
+
+static void
+jump_step (guint frame)
+{
+  set_scroll_fraction (g_random_double ());
+}
+
+static void
+sort_step (guint frame)
+{
+  GtkSorter *sorter;
+
+  if (frame % 10 != 0)
+    return;
+
+  switch (frame / 10 % 3)
+    {
+    case 0:
+      sorter = GTK_SORTER (gtk_string_sorter_new (create_string_expression ()));
+      break;
+    case 1:
+      sorter = GTK_SORTER (gtk_numeric_sorter_new (gtk_cclosure_expression_new (G_TYPE_UINT,
+                                                                                NULL,
+                                                                                0, NULL,
+                                                                                G_CALLBACK (get_string_length),
+                                                                                NULL, NULL)));
+      gtk_numeric_sorter_set_sort_order (GTK_NUMERIC_SORTER (sorter), GTK_SORT_DESCENDING);
+      break;
+    default:
+      sorter = NULL;
+      break;
+    }
+
+  gtk_sort_list_model_set_sorter (sort_model, sorter);
+  g_clear_object (&sorter);
+}
+
+static void
+filter_step (guint frame)
+{
+  const char *searches[] = { "1", "12", "123", "1234", "123", "12", "1", "" };
+  GtkStringFilter *filter;
+
+  if (frame % 5 != 0)
+    return;
+
+  filter = GTK_STRING_FILTER (gtk_filter_list_model_get_filter (filter_model));
+  gtk_string_filter_set_search (filter, searches[frame / 5 % G_N_ELEMENTS (searches)]);
+}
+
+static void
+select_step (guint frame)
+{
+  GtkSelectionModel *model = GTK_SELECTION_MODEL (selection);
+  guint n_items = g_list_model_get_n_items (G_LIST_MODEL (model));
+
+  if (n_items == 0)
+    return;
+
+  switch (frame % 4)
+    {
+    case 0:
+      gtk_selection_model_select_all (model);
+      break;
+    case 1:
+      gtk_selection_model_unselect_all (model);
+      break;
+    case 2:
+      gtk_selection_model_select_range (model, g_random_int_range (0, n_items), MIN (n_items, 1000), FALSE);
+      break;
+    default:
+      gtk_selection_model_select_item (model, g_random_int_range (0, n_items), TRUE);
+      break;
+    }
+}
+
+static void
+expand_step (guint frame)
+{
+  GtkTreeListRow *row;
+
+  if (tree_model == NULL)
+    return;
+
+  row = gtk_tree_list_model_get_row (tree_model, frame * 3);
+  if (row)
+    {
+      gtk_tree_list_row_set_expanded (row, !gtk_tree_list_row_get_expanded (row));
+      g_object_unref (row);
+    }
+}
+
+static const Phase phases[] = {
+  { "scroll", 120, scroll_step },
+  { "jump", 60, jump_step },
+  { "sort", 60, sort_step },
+  { "filter", 80, filter_step },
+  { "select", 40, select_step },
+  { "expand", 40, expand_step },
+};
+
+static guint phase;
+static guint phase_frame;
+static guint frame;
+static gint64 phase_max[3];
+static gint64 phase_total[3];
+
+static gboolean
+tick_cb (GtkWidget     *widget,
+         GdkFrameClock *frame_clock,
+         gpointer       data)
+{
+  if (phase >= G_N_ELEMENTS (phases))
+    {
+      gtk_window_destroy (GTK_WINDOW (gtk_widget_get_root (widget)));
+      return G_SOURCE_REMOVE;
+    }
+
+  phases[phase].step (phase_frame);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+print_phase_summary (void)
+{
+  g_print ("# %s: measure %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT
+           " allocate %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT
+           " snapshot %" G_GINT64_FORMAT "/%" G_GINT64_FORMAT " (avg/max)\n",
+           phases[phase].name,
+           phase_total[0] / phases[phase].n_frames, phase_max[0],
+           phase_total[1] / phases[phase].n_frames, phase_max[1],
+           phase_total[2] / phases[phase].n_frames, phase_max[2]);
+
+  memset (phase_max, 0, sizeof (phase_max));
+  memset (phase_total, 0, sizeof (phase_total));
+}
+
+static void
+after_paint_cb (GdkFrameClock *frame_clock,
+                gpointer       data)
+{
+  gint64 times[3];
+  guint i;
+
+  if (phase >= G_N_ELEMENTS (phases))
+    return;
+
+  times[0] = timed_bin->measure_time;
+  times[1] = timed_bin->allocate_time;
+  times[2] = timed_bin->snapshot_time;
+
+  g_print ("%s\t%u\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "\t%u\t%u\t%u\t%u\n",
+           phases[phase].name, frame,
+           times[0], times[1], times[2],
+           items_changed, items_added, items_removed,
+           g_list_model_get_n_items (G_LIST_MODEL (selection)));
+
+  for (i = 0; i < G_N_ELEMENTS (times); i++)
+    {
+      phase_total[i] += times[i];
+      phase_max[i] = MAX (phase_max[i], times[i]);
+    }
+
+  timed_bin->measure_time = 0;
+  timed_bin->allocate_time = 0;
+  timed_bin->snapshot_time = 0;
+  items_changed = items_added = items_removed = 0;
+
+  frame++;
+  phase_frame++;
+  if (phase_frame >= phases[phase].n_frames)
+    {
+      print_phase_summary ();
+      phase++;
+      phase_frame = 0;
+      set_scroll_fraction (0);
+    }
+}
+
+static void
+realize_cb (GtkWidget *window,
+            gpointer   data)
+{
+  g_signal_connect (gtk_widget_get_frame_clock (window), "after-paint",
+                    G_CALLBACK (after_paint_cb), NULL);
+}
+
+/* }}} */
+
+static void
+quit_cb (GtkWidget *widget,
+         gpointer   data)
+{
+  gboolean *done = data;
+
+  *done = TRUE;
+
+  g_main_context_wakeup (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  GtkWidget *window, *sw, *list;
+  GOptionContext *context;
+  GError *error = NULL;
+  gboolean done = FALSE;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+
+  gtk_init ();
+
+  /* Same numbers every run, so runs can be compared */
+  g_random_set_seed (opt_seed);
+
+  g_print ("# widget %s, %u items%s%s, seed %d\n",
+           opt_widget ? opt_widget : "list", opt_items,
+           opt_tree ? ", tree" : "",
+           opt_incremental ? ", incremental" : "",
+           opt_seed);
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 800, 600);
+  g_signal_connect (window, "realize", G_CALLBACK (realize_cb), NULL);
+
+  sw = gtk_scrolled_window_new ();
+  scrolled_window = GTK_SCROLLED_WINDOW (sw);
+  list = create_list_widget (create_model ());
+  gtk_scrolled_window_set_child (scrolled_window, list);
+
+  timed_bin = TIMED_BIN (timed_bin_new (sw));
+  gtk_window_set_child (GTK_WINDOW (window), GTK_WIDGET (timed_bin));
+
+  gtk_widget_add_tick_callback (list, tick_cb, NULL, NULL);
+
+  g_print ("# phase\tframe\tmeasure\tallocate\tsnapshot\titems_changed\tadded\tremoved\tn_items\n");
+
+  gtk_widget_show (window);
+  g_signal_connect (window, "destroy", G_CALLBACK (quit_cb), &done);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  return 0;
+}
+
+/* vim:set foldmethod=marker: */
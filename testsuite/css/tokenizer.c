@@ -0,0 +1,279 @@
+#include "../../gtk/css/gtkcsstokenizerprivate.h"
+
+#include <locale.h>
+
+static GtkCssTokenizer *
+tokenizer_new (const char *css)
+{
+  GtkCssTokenizer *tokenizer;
+  GBytes *bytes;
+
+  bytes = g_bytes_new_static (css, strlen (css));
+  tokenizer = gtk_css_tokenizer_new (bytes);
+  g_bytes_unref (bytes);
+
+  return tokenizer;
+}
+
+static void
+read_token (GtkCssTokenizer *tokenizer,
+            GtkCssToken     *token)
+{
+  GError *error = NULL;
+
+  gtk_css_tokenizer_read_token (tokenizer, token, &error);
+  g_assert_no_error (error);
+}
+
+static void
+assert_location (GtkCssTokenizer *tokenizer,
+                 gsize            bytes,
+                 gsize            chars,
+                 gsize            lines,
+                 gsize            line_chars)
+{
+  const GtkCssLocation *location = gtk_css_tokenizer_get_location (tokenizer);
+
+  g_assert_cmpuint (location->bytes, ==, bytes);
+  g_assert_cmpuint (location->chars, ==, chars);
+  g_assert_cmpuint (location->lines, ==, lines);
+  g_assert_cmpuint (location->line_chars, ==, line_chars);
+}
+
+static void
+test_names (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+
+  tokenizer = tokenizer_new ("button \\62 utton b\\utton brüt -x-y_1");
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "button");
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 6, 6, 0, 6);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "button");
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "button");
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "brüt");
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 30, 29, 0, 29);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "-x-y_1");
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_EOF);
+
+  gtk_css_tokenizer_unref (tokenizer);
+}
+
+static void
+test_whitespace (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+
+  tokenizer = tokenizer_new ("a  \t\n\r\n    \t b");
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_WHITESPACE);
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 13, 13, 2, 6);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  g_assert_cmpstr (token.string.string, ==, "b");
+  gtk_css_token_clear (&token);
+
+  gtk_css_tokenizer_unref (tokenizer);
+}
+
+static void
+test_comments (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+
+  tokenizer = tokenizer_new ("/* * ** ü\n * / */x/**/");
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_COMMENT);
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 18, 17, 1, 7);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_IDENT);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_COMMENT);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_EOF);
+
+  gtk_css_tokenizer_unref (tokenizer);
+}
+
+static void
+test_unterminated_comment (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+  GError *error = NULL;
+
+  tokenizer = tokenizer_new ("/* abc\n*");
+
+  g_assert_false (gtk_css_tokenizer_read_token (tokenizer, &token, &error));
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_COMMENT);
+  g_assert_nonnull (error);
+  g_clear_error (&error);
+  assert_location (tokenizer, 8, 8, 1, 1);
+
+  gtk_css_tokenizer_unref (tokenizer);
+}
+
+static void
+test_strings (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+
+  tokenizer = tokenizer_new ("\"Sans Bold\" 'it\\'s' \"a\\\nb\"");
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_STRING);
+  g_assert_cmpstr (token.string.string, ==, "Sans Bold");
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 11, 11, 0, 11);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_STRING);
+  g_assert_cmpstr (token.string.string, ==, "it's");
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  gtk_css_token_clear (&token);
+
+  read_token (tokenizer, &token);
+  g_assert_cmpint (token.type, ==, GTK_CSS_TOKEN_STRING);
+  g_assert_cmpstr (token.string.string, ==, "ab");
+  gtk_css_token_clear (&token);
+  assert_location (tokenizer, 26, 26, 1, 2);
+
+  gtk_css_tokenizer_unref (tokenizer);
+}
+
+static char *
+create_theme (gsize size)
+{
+  GString *css = g_string_new (NULL);
+  guint i;
+
+  for (i = 0; css->len < size; i++)
+    {
+      g_string_append_printf (css,
+                              "/* rule %u\n"
+                              " * generated for benchmarking */\n"
+                              "window.background > box.vertical:hover button#button-%u:not(:disabled) {\n"
+                              "  font-family: \"Cantarell\", sans-serif;\n"
+                              "  color: rgba(%u, 100, 50, 0.5);\n"
+                              "  margin: %upx 2em -3.5px 0;\n"
+                              "  background-image: linear-gradient(to bottom, @theme_bg_color, shade(@theme_bg_color, 0.9));\n"
+                              "  transition: all 200ms cubic-bezier(0.25, 0.46, 0.45, 0.94);\n"
+                              "}\n\n",
+                              i, i, i % 256, i % 16);
+    }
+
+  return g_string_free (css, FALSE);
+}
+
+static void
+test_performance (void)
+{
+  GtkCssTokenizer *tokenizer;
+  GtkCssToken token;
+  gint64 start, end;
+  gsize n_tokens;
+  char *css;
+  guint run;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Run with -m perf to benchmark");
+      return;
+    }
+
+  css = create_theme (200 * 1024);
+
+  for (run = 0; run < 10; run++)
+    {
+      tokenizer = tokenizer_new (css);
+      n_tokens = 0;
+
+      start = g_get_monotonic_time ();
+      do
+        {
+          read_token (tokenizer, &token);
+          gtk_css_token_clear (&token);
+          n_tokens++;
+        }
+      while (token.type != GTK_CSS_TOKEN_EOF);
+      end = g_get_monotonic_time ();
+
+      g_test_message ("%zu bytes, %zu tokens in %uus",
+                      strlen (css), n_tokens, (guint) (end - start));
+
+      gtk_css_tokenizer_unref (tokenizer);
+    }
+
+  g_free (css);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+  setlocale (LC_ALL, "C");
+
+  g_test_add_func ("/css/tokenizer/names", test_names);
+  g_test_add_func ("/css/tokenizer/whitespace", test_whitespace);
+  g_test_add_func ("/css/tokenizer/comments", test_comments);
+  g_test_add_func ("/css/tokenizer/unterminated-comment", test_unterminated_comment);
+  g_test_add_func ("/css/tokenizer/strings", test_strings);
+  g_test_add_func ("/css/tokenizer/performance", test_performance);
+
+  return g_test_run ();
+}
@@ -306,6 +306,53 @@ test_delete (void)
   g_object_unref (entry);
 }
 
+/* Random edits to long text with multibyte characters, to
+ * check the buffer keeps its character offsets right.
+ */
+static void
+test_buffer_long_text (void)
+{
+  const char *pieces[] = { "a", "bc", "ä", "€uro", "\xf0\x9f\x98\x80", "xyz ü" };
+  GtkEntryBuffer *buffer;
+  GString *expected;
+  guint i;
+
+  buffer = gtk_entry_buffer_new (NULL, 0);
+  expected = g_string_new (NULL);
+
+  for (i = 0; i < 5000; i++)
+    {
+      guint length = gtk_entry_buffer_get_length (buffer);
+      guint position = g_test_rand_int_range (0, length + 1);
+      const char *at = g_utf8_offset_to_pointer (expected->str, position);
+
+      if (length > 0 && g_test_rand_bit () && g_test_rand_bit ())
+        {
+          guint n_chars = g_test_rand_int_range (1, MIN (length - position, 600) + 2);
+          const char *end = g_utf8_offset_to_pointer (at, MIN (n_chars, length - position));
+
+          gtk_entry_buffer_delete_text (buffer, position, n_chars);
+          g_string_erase (expected, at - expected->str, end - at);
+        }
+      else
+        {
+          const char *piece = pieces[g_test_rand_int_range (0, G_N_ELEMENTS (pieces))];
+
+          if (expected->len + strlen (piece) >= GTK_ENTRY_BUFFER_MAX_SIZE)
+            continue;
+
+          gtk_entry_buffer_insert_text (buffer, position, piece, -1);
+          g_string_insert (expected, at - expected->str, piece);
+        }
+
+      g_assert_cmpstr (gtk_entry_buffer_get_text (buffer), ==, expected->str);
+      g_assert_cmpuint (gtk_entry_buffer_get_length (buffer), ==, g_utf8_strlen (expected->str, -1));
+    }
+
+  g_string_free (expected, TRUE);
+  g_object_unref (buffer);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -314,6 +361,7 @@ main (int   argc,
 
   g_test_add_func ("/entry/delete", test_delete);
   g_test_add_func ("/entry/insert", test_insert);
+  g_test_add_func ("/entry/buffer-long-text", test_buffer_long_text);
 
   return g_test_run();
 }
@@ -324,6 +324,96 @@ test_string_properties (void)
   g_object_unref (filter);
 }
 
+static void
+test_string_large (void)
+{
+  GtkFilterListModel *model;
+  GtkStringList *list;
+  GtkFilter *filter;
+  char buffer[16];
+  guint i, n_expected;
+
+  list = gtk_string_list_new (NULL);
+  n_expected = 0;
+  for (i = 0; i < 100000; i++)
+    {
+      g_snprintf (buffer, sizeof (buffer), "Item %u", i);
+      gtk_string_list_append (list, buffer);
+      if (strstr (buffer, "123"))
+        n_expected++;
+    }
+
+  filter = GTK_FILTER (gtk_string_filter_new (gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string")));
+  model = gtk_filter_list_model_new (G_LIST_MODEL (list), g_object_ref (filter));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 100000);
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "123");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, n_expected);
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "ITEM 1234");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 11);
+
+  gtk_string_filter_set_ignore_case (GTK_STRING_FILTER (filter), FALSE);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 0);
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "123");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, n_expected);
+
+  /* Clearing the search drops the prepared strings */
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), NULL);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 100000);
+
+  gtk_string_filter_set_ignore_case (GTK_STRING_FILTER (filter), TRUE);
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "ITEM 1234");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 11);
+
+  g_object_unref (model);
+  g_object_unref (filter);
+}
+
+static void
+test_string_item_changes (void)
+{
+  GtkFilterListModel *model;
+  GListStore *store;
+  GtkFilter *filter;
+  GObject *object;
+
+  object = g_object_new (G_TYPE_OBJECT, NULL);
+  g_object_set_qdata (object, number_quark, GUINT_TO_POINTER (12));
+
+  /* the same item in two positions */
+  store = g_list_store_new (G_TYPE_OBJECT);
+  g_list_store_append (store, object);
+  g_list_store_append (store, object);
+
+  filter = GTK_FILTER (gtk_string_filter_new (
+               gtk_cclosure_expression_new (G_TYPE_STRING,
+                                            NULL,
+                                            0, NULL,
+                                            G_CALLBACK (get_string),
+                                            NULL, NULL)));
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+  model = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (store)), g_object_ref (filter));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 2);
+
+  /* prepared strings must follow changes to the item */
+  g_object_set_qdata (object, number_quark, GUINT_TO_POINTER (34));
+  gtk_filter_changed (filter, GTK_FILTER_CHANGE_DIFFERENT);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 0);
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "4");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 2);
+
+  g_list_store_remove (store, 0);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 1);
+
+  g_object_unref (model);
+  g_object_unref (filter);
+  g_object_unref (store);
+  g_object_unref (object);
+}
+
 static void
 test_bool_simple (void)
 {
@@ -405,6 +495,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/filter/any/simple", test_any_simple);
   g_test_add_func ("/filter/string/simple", test_string_simple);
   g_test_add_func ("/filter/string/properties", test_string_properties);
+  g_test_add_func ("/filter/string/large", test_string_large);
+  g_test_add_func ("/filter/string/item-changes", test_string_item_changes);
   g_test_add_func ("/filter/bool/simple", test_bool_simple);
   g_test_add_func ("/filter/every/dispose", test_every_dispose);
 
@@ -0,0 +1,257 @@
+#include <locale.h>
+
+#include <gtk/gtk.h>
+
+#include "gtk/gtkfilterprivate.h"
+
+#define ensure_updated() G_STMT_START{ \
+  while (g_main_context_pending (NULL)) \
+    g_main_context_iteration (NULL, TRUE); \
+}G_STMT_END
+
+#define assert_model_equal(model1, model2) G_STMT_START{ \
+  guint _i, _n; \
+  g_assert_cmpint (g_list_model_get_n_items (model1), ==, g_list_model_get_n_items (model2)); \
+  _n = g_list_model_get_n_items (model1); \
+  for (_i = 0; _i < _n; _i++) \
+    { \
+      gpointer o1 = g_list_model_get_item (model1, _i); \
+      gpointer o2 = g_list_model_get_item (model2, _i); \
+      if (o1 != o2) \
+        { \
+          char *_s = g_strdup_printf ("Objects differ at index %u out of %u", _i, _n); \
+         g_assertion_message (G_LOG_DOMAIN, __FILE__, __LINE__, G_STRFUNC, _s); \
+          g_free (_s); \
+        } \
+      g_object_unref (o1); \
+      g_object_unref (o2); \
+    } \
+}G_STMT_END
+
+static char *
+create_word (void)
+{
+  char *word;
+  guint i, len;
+
+  len = g_test_rand_int_range (3, 12);
+  word = g_new (char, len + 1);
+  for (i = 0; i < len; i++)
+    word[i] = g_test_rand_int_range ('a', 'h');
+  word[len] = 0;
+
+  return word;
+}
+
+static GtkStringList *
+create_string_list (guint n_items)
+{
+  GtkStringList *list;
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < n_items; i++)
+    {
+      char *word = create_word ();
+      gtk_string_list_take (list, word);
+    }
+
+  return list;
+}
+
+static GtkFilter *
+create_filter (GtkStringFilterMatchMode mode)
+{
+  GtkStringFilter *filter;
+
+  filter = gtk_string_filter_new (gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string"));
+  gtk_string_filter_set_match_mode (filter, mode);
+
+  return GTK_FILTER (filter);
+}
+
+/* Compares @model against a model that filters from scratch */
+static void
+assert_filtered_correctly (GtkFilterListModel *model,
+                           const char         *search)
+{
+  GtkFilterListModel *compare;
+  GtkFilter *filter;
+
+  filter = create_filter (gtk_string_filter_get_match_mode (GTK_STRING_FILTER (gtk_filter_list_model_get_filter (model))));
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), search);
+  compare = gtk_filter_list_model_new (g_object_ref (gtk_filter_list_model_get_model (model)), filter);
+
+  assert_model_equal (G_LIST_MODEL (model), G_LIST_MODEL (compare));
+
+  g_object_unref (compare);
+}
+
+static void
+type_search (GtkFilterListModel *model,
+             const char         *query,
+             gboolean            incremental,
+             GtkStringList      *modify)
+{
+  GtkStringFilter *filter = GTK_STRING_FILTER (gtk_filter_list_model_get_filter (model));
+  gint64 start, end;
+  gsize i, len;
+  char *search;
+
+  len = strlen (query);
+
+  /* type it in, then delete it again */
+  for (i = 1; i < 2 * len; i++)
+    {
+      search = g_strndup (query, i <= len ? i : 2 * len - i);
+
+      start = g_get_monotonic_time ();
+      gtk_string_filter_set_search (filter, search);
+      if (incremental)
+        ensure_updated ();
+      end = g_get_monotonic_time ();
+
+      if (g_test_verbose ())
+        g_test_message ("\"%s\": %u items in %uus",
+                        search, g_list_model_get_n_items (G_LIST_MODEL (model)),
+                        (guint) (end - start));
+
+      assert_filtered_correctly (model, search);
+
+      /* make sure saved results follow changes to the model */
+      if (modify)
+        {
+          guint pos = g_test_rand_int_range (0, g_list_model_get_n_items (G_LIST_MODEL (modify)));
+          char *word = create_word ();
+
+          gtk_string_list_splice (modify, pos, 1, (const char *[2]) { word, NULL });
+          g_free (word);
+          if (incremental)
+            ensure_updated ();
+
+          assert_filtered_correctly (model, search);
+        }
+
+      g_free (search);
+    }
+}
+
+static void
+test_refine (gconstpointer data)
+{
+  GtkStringFilterMatchMode mode = GPOINTER_TO_UINT (data);
+  GtkFilterListModel *model;
+  GtkStringList *list;
+
+  list = create_string_list (g_test_perf () ? 1000000 : 10000);
+  model = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), create_filter (mode));
+
+  type_search (model, "abcdefg", FALSE, NULL);
+  type_search (model, "bad", FALSE, NULL);
+
+  g_object_unref (model);
+  g_object_unref (list);
+}
+
+static void
+test_refine_incremental (gconstpointer data)
+{
+  GtkStringFilterMatchMode mode = GPOINTER_TO_UINT (data);
+  GtkFilterListModel *model;
+  GtkStringList *list;
+
+  list = create_string_list (g_test_perf () ? 1000000 : 10000);
+  model = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), create_filter (mode));
+  gtk_filter_list_model_set_incremental (model, TRUE);
+
+  type_search (model, "abcdefg", TRUE, NULL);
+  type_search (model, "bad", TRUE, NULL);
+
+  g_object_unref (model);
+  g_object_unref (list);
+}
+
+static void
+test_refine_model_changes (gconstpointer data)
+{
+  GtkStringFilterMatchMode mode = GPOINTER_TO_UINT (data);
+  GtkFilterListModel *model;
+  GtkStringList *list;
+
+  list = create_string_list (1000);
+  model = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), create_filter (mode));
+
+  type_search (model, "abcdefg", FALSE, list);
+
+  g_object_unref (model);
+  g_object_unref (list);
+}
+
+static void
+test_refine_items_changed (void)
+{
+  GtkFilterListModel *model;
+  GtkStringList *list;
+  GtkFilter *filter;
+
+  list = gtk_string_list_new ((const char *[]) { "ab", "ac", "bc", NULL });
+  filter = create_filter (GTK_STRING_FILTER_MATCH_MODE_SUBSTRING);
+  model = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), g_object_ref (filter));
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "a");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 2);
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "ab");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 1);
+
+  /* Saved results for "a" must pick up the new item */
+  gtk_string_list_splice (list, 2, 1, (const char *[]) { "abc", NULL });
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 2);
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "a");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+
+  /* Emitting ::changed without a new key drops all saved results */
+  g_assert_nonnull (gtk_filter_get_refinement_key (filter));
+  gtk_filter_changed (filter, GTK_FILTER_CHANGE_DIFFERENT);
+  g_assert_null (gtk_filter_get_refinement_key (filter));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, 3);
+
+  g_object_unref (model);
+  g_object_unref (filter);
+  g_object_unref (list);
+}
+
+static void
+add_test_for_all_modes (const char    *name,
+                        GTestDataFunc  test_func)
+{
+  struct {
+    const char *name;
+    GtkStringFilterMatchMode mode;
+  } modes[] = {
+    { "exact", GTK_STRING_FILTER_MATCH_MODE_EXACT },
+    { "substring", GTK_STRING_FILTER_MATCH_MODE_SUBSTRING },
+    { "prefix", GTK_STRING_FILTER_MATCH_MODE_PREFIX },
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (modes); i++)
+    {
+      char *path = g_strdup_printf ("/filterlistmodel-refine/%s/%s", name, modes[i].name);
+      g_test_add_data_func (path, GUINT_TO_POINTER (modes[i].mode), test_func);
+      g_free (path);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+  setlocale (LC_ALL, "C");
+
+  add_test_for_all_modes ("typing", test_refine);
+  add_test_for_all_modes ("typing-incremental", test_refine_incremental);
+  add_test_for_all_modes ("model-changes", test_refine_model_changes);
+  g_test_add_func ("/filterlistmodel-refine/items-changed", test_refine_items_changed);
+
+  return g_test_run ();
+}
@@ -0,0 +1,290 @@
+#include <gtk/gtk.h>
+
+static const GdkRGBA black = { 0, 0, 0, 1 };
+static const GdkRGBA red = { 1, 0, 0, 1 };
+
+static PangoContext *
+create_context (void)
+{
+  return pango_font_map_create_context (pango_cairo_font_map_get_default ());
+}
+
+static PangoLayout *
+create_layout (PangoContext *context,
+               const char   *text)
+{
+  PangoLayout *layout;
+
+  layout = pango_layout_new (context);
+  pango_layout_set_text (layout, text, -1);
+
+  return layout;
+}
+
+static GskRenderNode *
+render_layout (PangoLayout   *layout,
+               const GdkRGBA *color,
+               float          x,
+               float          y)
+{
+  GtkSnapshot *snapshot;
+
+  snapshot = gtk_snapshot_new ();
+  gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
+  gtk_snapshot_append_layout (snapshot, layout, color);
+
+  return gtk_snapshot_free_to_node (snapshot);
+}
+
+static GskRenderNode *
+get_text_node (GskRenderNode *node)
+{
+  g_assert_nonnull (node);
+
+  if (gsk_render_node_get_node_type (node) == GSK_CONTAINER_NODE)
+    node = gsk_container_node_get_child (node, 0);
+
+  g_assert_cmpint (gsk_render_node_get_node_type (node), ==, GSK_TEXT_NODE);
+
+  return node;
+}
+
+/* Cached layouts reuse the text nodes they recorded */
+static gboolean
+renders_same (GskRenderNode *node1,
+              GskRenderNode *node2)
+{
+  return get_text_node (node1) == get_text_node (node2);
+}
+
+static void
+test_hit (void)
+{
+  PangoContext *context;
+  PangoLayout *layout1, *layout2;
+  GskRenderNode *node1, *node2;
+
+  context = create_context ();
+  layout1 = create_layout (context, "The layout cache hit test");
+  layout2 = create_layout (context, "The layout cache hit test");
+
+  node1 = render_layout (layout1, &black, 0, 0);
+  node2 = render_layout (layout1, &black, 0, 0);
+  g_assert_true (renders_same (node1, node2));
+  gsk_render_node_unref (node2);
+
+  /* other layouts with the same contents hit, too */
+  node2 = render_layout (layout2, &black, 0, 0);
+  g_assert_true (renders_same (node1, node2));
+  gsk_render_node_unref (node2);
+
+  gsk_render_node_unref (node1);
+  g_object_unref (layout1);
+  g_object_unref (layout2);
+  g_object_unref (context);
+}
+
+static void
+test_miss (void)
+{
+  PangoContext *context;
+  PangoLayout *layout;
+  PangoAttrList *attrs;
+  GskRenderNode *node1, *node2;
+
+  context = create_context ();
+  layout = create_layout (context, "The layout cache miss test");
+
+  node1 = render_layout (layout, &black, 0, 0);
+
+  node2 = render_layout (layout, &red, 0, 0);
+  g_assert_false (renders_same (node1, node2));
+  g_assert_true (gdk_rgba_equal (gsk_text_node_get_color (get_text_node (node2)), &red));
+  gsk_render_node_unref (node2);
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_weight_new (PANGO_WEIGHT_BOLD));
+  pango_layout_set_attributes (layout, attrs);
+  pango_attr_list_unref (attrs);
+  node2 = render_layout (layout, &black, 0, 0);
+  g_assert_false (renders_same (node1, node2));
+  gsk_render_node_unref (node2);
+
+  pango_layout_set_attributes (layout, NULL);
+  pango_layout_set_width (layout, 50 * PANGO_SCALE);
+  node2 = render_layout (layout, &black, 0, 0);
+  g_assert_false (renders_same (node1, node2));
+  gsk_render_node_unref (node2);
+
+  gsk_render_node_unref (node1);
+  g_object_unref (layout);
+  g_object_unref (context);
+}
+
+static void
+test_offset (void)
+{
+  PangoContext *context;
+  PangoLayout *layout;
+  GskRenderNode *node1, *node2, *text1, *text2;
+  const graphene_point_t *offset1, *offset2;
+  graphene_rect_t bounds1, bounds2;
+
+  context = create_context ();
+  layout = create_layout (context, "The layout cache offset test");
+
+  node1 = render_layout (layout, &black, 0, 0);
+  node2 = render_layout (layout, &black, 10, 20);
+
+  /* Hits are appended at the current offset, not in a transform node */
+  text1 = get_text_node (node1);
+  text2 = get_text_node (node2);
+  offset1 = gsk_text_node_get_offset (text1);
+  offset2 = gsk_text_node_get_offset (text2);
+  g_assert_cmpfloat (offset2->x, ==, offset1->x + 10);
+  g_assert_cmpfloat (offset2->y, ==, offset1->y + 20);
+
+  gsk_render_node_get_bounds (text1, &bounds1);
+  gsk_render_node_get_bounds (text2, &bounds2);
+  g_assert_cmpfloat (bounds2.origin.x, ==, bounds1.origin.x + 10);
+  g_assert_cmpfloat (bounds2.origin.y, ==, bounds1.origin.y + 20);
+  g_assert_cmpfloat (bounds2.size.width, ==, bounds1.size.width);
+  g_assert_cmpfloat (bounds2.size.height, ==, bounds1.size.height);
+
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  g_object_unref (layout);
+  g_object_unref (context);
+}
+
+static void
+test_eviction (void)
+{
+  PangoContext *context;
+  PangoLayout *layout, *other;
+  GskRenderNode *node1, *node2, *last1, *last2;
+  GString *text;
+  guint i;
+
+  context = create_context ();
+  layout = create_layout (context, "The layout cache eviction test");
+  node1 = render_layout (layout, &black, 0, 0);
+
+  /* Long texts fill the cache quickly */
+  text = g_string_new (NULL);
+  other = pango_layout_new (context);
+  last1 = NULL;
+  for (i = 0; i < 1000; i++)
+    {
+      g_string_printf (text, "%u", i);
+      while (text->len < 1000)
+        g_string_append (text, " lorem ipsum");
+      pango_layout_set_text (other, text->str, -1);
+
+      g_clear_pointer (&last1, gsk_render_node_unref);
+      last1 = render_layout (other, &black, 0, 0);
+    }
+
+  /* The recently used layout is still there, the first one is gone */
+  last2 = render_layout (other, &black, 0, 0);
+  g_assert_true (renders_same (last1, last2));
+  node2 = render_layout (layout, &black, 0, 0);
+  g_assert_false (renders_same (node1, node2));
+
+  gsk_render_node_unref (last1);
+  gsk_render_node_unref (last2);
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  g_string_free (text, TRUE);
+  g_object_unref (other);
+  g_object_unref (layout);
+  g_object_unref (context);
+}
+
+static gint64
+render_many (PangoLayout **layouts,
+             guint         n_layouts,
+             guint         n_frames)
+{
+  gint64 start;
+  guint i, j;
+
+  start = g_get_monotonic_time ();
+
+  for (i = 0; i < n_frames; i++)
+    {
+      GtkSnapshot *snapshot = gtk_snapshot_new ();
+
+      for (j = 0; j < n_layouts; j++)
+        {
+          gtk_snapshot_save (snapshot);
+          gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (0, j * 20));
+          gtk_snapshot_append_layout (snapshot, layouts[j], &black);
+          gtk_snapshot_restore (snapshot);
+        }
+
+      g_clear_pointer (&snapshot, gtk_snapshot_free_to_node);
+    }
+
+  return g_get_monotonic_time () - start;
+}
+
+/* Renders a list of labels with repeated texts, like a list
+ * widget would, with and without the cache.
+ */
+static void
+test_performance (void)
+{
+  PangoContext *context;
+  PangoLayout *layouts[200];
+  PangoTabArray *tabs;
+  gint64 cached, uncached;
+  guint i;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Run with -m perf to benchmark");
+      return;
+    }
+
+  context = create_context ();
+  for (i = 0; i < G_N_ELEMENTS (layouts); i++)
+    {
+      char *text = g_strdup_printf ("Item number %u of the list", i % 20);
+      layouts[i] = create_layout (context, text);
+      g_free (text);
+    }
+
+  cached = render_many (layouts, G_N_ELEMENTS (layouts), 100);
+
+  /* Layouts with tabs are never cached */
+  tabs = pango_tab_array_new (0, FALSE);
+  for (i = 0; i < G_N_ELEMENTS (layouts); i++)
+    pango_layout_set_tabs (layouts[i], tabs);
+  pango_tab_array_free (tabs);
+
+  uncached = render_many (layouts, G_N_ELEMENTS (layouts), 100);
+
+  g_test_minimized_result ((double) cached / G_USEC_PER_SEC,
+                           "cached: %.2fms per frame",
+                           (double) cached / 100 / 1000);
+  g_test_message ("uncached: %.2fms per frame", (double) uncached / 100 / 1000);
+
+  for (i = 0; i < G_N_ELEMENTS (layouts); i++)
+    g_object_unref (layouts[i]);
+  g_object_unref (context);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/layoutcache/hit", test_hit);
+  g_test_add_func ("/layoutcache/miss", test_miss);
+  g_test_add_func ("/layoutcache/offset", test_offset);
+  g_test_add_func ("/layoutcache/eviction", test_eviction);
+  g_test_add_func ("/layoutcache/performance", test_performance);
+
+  return g_test_run ();
+}
@@ -0,0 +1,120 @@
+#include <gtk/gtk.h>
+
+typedef struct {
+  guint setup;
+  guint bind;
+  guint unbind;
+  guint teardown;
+} Counts;
+
+static void
+setup_cb (GtkSignalListItemFactory *factory,
+          GtkListItem              *list_item,
+          Counts                   *counts)
+{
+  counts->setup++;
+  gtk_list_item_set_child (list_item, gtk_label_new (NULL));
+}
+
+static void
+bind_cb (GtkSignalListItemFactory *factory,
+         GtkListItem              *list_item,
+         Counts                   *counts)
+{
+  GtkStringObject *string = gtk_list_item_get_item (list_item);
+
+  counts->bind++;
+  g_assert_nonnull (string);
+  gtk_label_set_label (GTK_LABEL (gtk_list_item_get_child (list_item)),
+                       gtk_string_object_get_string (string));
+}
+
+static void
+unbind_cb (GtkSignalListItemFactory *factory,
+           GtkListItem              *list_item,
+           Counts                   *counts)
+{
+  counts->unbind++;
+  /* the item must still be available when unbinding */
+  g_assert_nonnull (gtk_list_item_get_item (list_item));
+}
+
+static void
+teardown_cb (GtkSignalListItemFactory *factory,
+             GtkListItem              *list_item,
+             Counts                   *counts)
+{
+  counts->teardown++;
+  gtk_list_item_set_child (list_item, NULL);
+}
+
+static GtkWidget *
+create_list_view (GtkListItemFactory *factory)
+{
+  GtkStringList *list;
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 100; i++)
+    {
+      char *s = g_strdup_printf ("%u", i);
+      gtk_string_list_take (list, s);
+    }
+
+  return gtk_list_view_new (GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (list))),
+                            g_object_ref (factory));
+}
+
+static void
+test_reuse (void)
+{
+  GtkListItemFactory *factory;
+  GtkWidget *window, *view1, *view2;
+  Counts counts = { 0, };
+  guint n_setup;
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_cb), &counts);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_cb), &counts);
+  g_signal_connect (factory, "unbind", G_CALLBACK (unbind_cb), &counts);
+  g_signal_connect (factory, "teardown", G_CALLBACK (teardown_cb), &counts);
+
+  window = gtk_window_new ();
+  view1 = g_object_ref_sink (create_list_view (factory));
+  view2 = g_object_ref_sink (create_list_view (factory));
+
+  gtk_window_set_child (GTK_WINDOW (window), view1);
+  n_setup = counts.setup;
+  g_assert_cmpuint (n_setup, >, 0);
+  g_assert_cmpuint (counts.bind, ==, n_setup);
+
+  /* Switching views rebinds the list items of the first one */
+  gtk_window_set_child (GTK_WINDOW (window), view2);
+  g_assert_cmpuint (counts.setup, ==, n_setup);
+  g_assert_cmpuint (counts.unbind, ==, n_setup);
+  g_assert_cmpuint (counts.bind, ==, 2 * n_setup);
+  g_assert_cmpuint (counts.teardown, ==, 0);
+
+  gtk_window_set_child (GTK_WINDOW (window), view1);
+  g_assert_cmpuint (counts.setup, ==, n_setup);
+  g_assert_cmpuint (counts.bind, ==, 3 * n_setup);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (view1);
+  g_object_unref (view2);
+
+  /* Everything set up gets torn down with the factory */
+  g_assert_cmpuint (counts.teardown, <, counts.setup);
+  g_object_unref (factory);
+  g_assert_cmpuint (counts.teardown, ==, counts.setup);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/listitemfactory/reuse", test_reuse);
+
+  return g_test_run ();
+}
@@ -732,6 +732,66 @@ test_empty_filter (void)
   g_object_unref (selection);
 }
 
+static gpointer
+count_map (gpointer item,
+           gpointer data)
+{
+  guint *count = data;
+
+  (*count)++;
+
+  return item;
+}
+
+/* Large selections survive items being readded, and unselecting
+ * them doesn't need to look at the items.
+ */
+static void
+test_select_all_large (void)
+{
+  GtkStringList *list;
+  GtkMapListModel *map;
+  GtkSelectionModel *selection;
+  GtkBitset *selected;
+  guint i, count = 0;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 100000; i++)
+    gtk_string_list_take (list, g_strdup_printf ("%u", i));
+  map = gtk_map_list_model_new (G_LIST_MODEL (list), count_map, &count, NULL);
+  selection = GTK_SELECTION_MODEL (gtk_multi_selection_new (G_LIST_MODEL (map)));
+
+  gtk_selection_model_select_all (selection);
+  selected = gtk_selection_model_get_selection (selection);
+  g_assert_cmpuint (gtk_bitset_get_size (selected), ==, 100000);
+  gtk_bitset_unref (selected);
+
+  /* Every selected item is looked up, so they all survive items
+   * being readded
+   */
+  g_assert_cmpuint (count, ==, 100000);
+  g_list_model_items_changed (G_LIST_MODEL (map), 50000, 1000, 1000);
+  selected = gtk_selection_model_get_selection (selection);
+  g_assert_cmpuint (gtk_bitset_get_size (selected), ==, 100000);
+  gtk_bitset_unref (selected);
+
+  /* Unselecting everything doesn't need to look at items */
+  count = 0;
+  gtk_selection_model_unselect_all (selection);
+  g_assert_cmpuint (count, ==, 0);
+  g_assert_false (gtk_selection_model_is_selected (selection, 0));
+
+  /* So do small selections */
+  gtk_selection_model_select_range (selection, 10, 5, FALSE);
+  g_list_model_items_changed (G_LIST_MODEL (map), 0, 20, 20);
+  selected = gtk_selection_model_get_selection (selection);
+  g_assert_cmpuint (gtk_bitset_get_size (selected), ==, 5);
+  g_assert_cmpuint (gtk_bitset_get_minimum (selected), ==, 10);
+  gtk_bitset_unref (selected);
+
+  g_object_unref (selection);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -756,6 +816,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/multiselection/set-model", test_set_model);
   g_test_add_func ("/multiselection/empty", test_empty);
   g_test_add_func ("/multiselection/selection-filter/empty", test_empty_filter);
+  g_test_add_func ("/multiselection/select-all-large", test_select_all_large);
 
   return g_test_run ();
 }
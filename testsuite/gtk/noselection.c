@@ -531,6 +531,104 @@ test_empty (void)
   g_object_unref (selection);
 }
 
+#define TEST_TYPE_PREFETCH_MODEL (test_prefetch_model_get_type ())
+G_DECLARE_FINAL_TYPE (TestPrefetchModel, test_prefetch_model, TEST, PREFETCH_MODEL, GObject)
+
+struct _TestPrefetchModel
+{
+  GObject parent_instance;
+
+  guint position;
+  guint n_items;
+};
+
+static GType
+test_prefetch_model_get_item_type (GListModel *list)
+{
+  return G_TYPE_OBJECT;
+}
+
+static guint
+test_prefetch_model_get_n_items (GListModel *list)
+{
+  return 100;
+}
+
+static gpointer
+test_prefetch_model_get_item (GListModel *list,
+                              guint       position)
+{
+  if (position >= 100)
+    return NULL;
+
+  return g_object_new (G_TYPE_OBJECT, NULL);
+}
+
+static void
+test_prefetch_model_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = test_prefetch_model_get_item_type;
+  iface->get_n_items = test_prefetch_model_get_n_items;
+  iface->get_item = test_prefetch_model_get_item;
+}
+
+static void
+test_prefetch_model_prefetch (GtkPrefetchModel *model,
+                              guint             position,
+                              guint             n_items)
+{
+  TestPrefetchModel *self = TEST_PREFETCH_MODEL (model);
+
+  self->position = position;
+  self->n_items = n_items;
+}
+
+static void
+test_prefetch_model_prefetch_model_init (GtkPrefetchModelInterface *iface)
+{
+  iface->prefetch = test_prefetch_model_prefetch;
+}
+
+G_DEFINE_TYPE_WITH_CODE (TestPrefetchModel, test_prefetch_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, test_prefetch_model_list_model_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_PREFETCH_MODEL, test_prefetch_model_prefetch_model_init))
+
+static void
+test_prefetch_model_class_init (TestPrefetchModelClass *klass)
+{
+}
+
+static void
+test_prefetch_model_init (TestPrefetchModel *self)
+{
+}
+
+static void
+test_prefetch (void)
+{
+  TestPrefetchModel *model;
+  GtkNoSelection *selection;
+  GListStore *store;
+
+  model = g_object_new (TEST_TYPE_PREFETCH_MODEL, NULL);
+  selection = gtk_no_selection_new (g_object_ref (G_LIST_MODEL (model)));
+
+  g_assert_true (GTK_IS_PREFETCH_MODEL (selection));
+  gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (selection), 20, 10);
+  g_assert_cmpuint (model->position, ==, 20);
+  g_assert_cmpuint (model->n_items, ==, 10);
+
+  /* models that can't prefetch are fine, too */
+  store = g_list_store_new (G_TYPE_OBJECT);
+  gtk_no_selection_set_model (selection, G_LIST_MODEL (store));
+  gtk_prefetch_model_prefetch (GTK_PREFETCH_MODEL (selection), 0, 10);
+  g_assert_cmpuint (model->position, ==, 20);
+  g_object_unref (store);
+
+  g_object_unref (selection);
+  g_object_unref (model);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -548,6 +646,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/noselection/changes", test_changes);
   g_test_add_func ("/noselection/set-model", test_set_model);
   g_test_add_func ("/noselection/empty", test_empty);
+  g_test_add_func ("/noselection/prefetch", test_prefetch);
 
   return g_test_run ();
 }
@@ -530,6 +530,149 @@ test_incremental_remove (void)
   g_object_unref (removed);
 }
 
+static void
+test_insert_items (void)
+{
+  GtkSortListModel *sort;
+  GListStore *store;
+  GtkSorter *sorter;
+
+  store = new_store ((guint[]) { 10, 20, 30, 40, 50, 0 });
+  sort = new_model (store);
+  assert_model (sort, "10 20 30 40 50");
+  assert_changes (sort, "");
+
+  /* only the range between the added items changes */
+  splice (store, 2, 0, (guint[]) { 35, 15 }, 2);
+  assert_model (sort, "10 15 20 30 35 40 50");
+  assert_changes (sort, "1-2+4*");
+
+  /* at both ends */
+  splice (store, 0, 0, (guint[]) { 60, 5 }, 2);
+  assert_model (sort, "5 10 15 20 30 35 40 50 60");
+  assert_changes (sort, "0-7+9*");
+
+  /* together with removals */
+  splice (store, 0, 2, (guint[]) { 25 }, 1);
+  assert_model (sort, "10 15 20 25 30 35 40 50");
+  assert_changes (sort, "0-9+8*");
+
+  /* equal items stay in model order */
+  sorter = GTK_SORTER (gtk_custom_sorter_new (compare_modulo, GUINT_TO_POINTER (5), NULL));
+  gtk_sort_list_model_set_sorter (sort, sorter);
+  g_object_unref (sorter);
+  ignore_changes (sort);
+  splice (store, 0, 8, (guint[]) { 1, 11, 21 }, 3);
+  assert_model (sort, "1 11 21");
+  ignore_changes (sort);
+  insert (store, 1, 31);
+  assert_model (sort, "1 31 11 21");
+  assert_changes (sort, "+1*");
+  add (store, 41);
+  assert_model (sort, "1 31 11 21 41");
+  assert_changes (sort, "+4*");
+
+  g_object_unref (store);
+  g_object_unref (sort);
+}
+
+static void
+test_insert_items_incremental (void)
+{
+  GtkSortListModel *sort;
+  GListStore *store;
+  GtkSorter *sorter;
+  guint i;
+
+  /* a finished incremental sort inserts directly, too */
+  store = new_store ((guint[]) { 10, 20, 30, 40, 50, 0 });
+  sort = new_model (store);
+  gtk_sort_list_model_set_incremental (sort, TRUE);
+  assert_model (sort, "10 20 30 40 50");
+  assert_changes (sort, "");
+
+  splice (store, 2, 0, (guint[]) { 35, 15 }, 2);
+  assert_model (sort, "10 15 20 30 35 40 50");
+  assert_changes (sort, "1-2+4*");
+
+  g_object_unref (store);
+  g_object_unref (sort);
+
+  /* but not while sorting */
+  store = new_shuffled_store (10000);
+  sort = new_model (NULL);
+  gtk_sort_list_model_set_incremental (sort, TRUE);
+  gtk_sort_list_model_set_model (sort, G_LIST_MODEL (store));
+  ignore_changes (sort);
+
+  sorter = GTK_SORTER (gtk_custom_sorter_new (compare, NULL, NULL));
+  gtk_sort_list_model_set_sorter (sort, sorter);
+  g_object_unref (sorter);
+  g_assert_cmpuint (gtk_sort_list_model_get_pending (sort), >, 0);
+
+  splice (store, 5000, 0, (guint[]) { 10002, 10001 }, 2);
+
+  while (gtk_sort_list_model_get_pending (sort) != 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (sort)), ==, 10002);
+  for (i = 0; i < 10002; i++)
+    g_assert_cmpuint (get (G_LIST_MODEL (sort), i), ==, i + 1);
+  ignore_changes (sort);
+
+  g_object_unref (store);
+  g_object_unref (sort);
+}
+
+static void
+test_insert_items_unsorted (void)
+{
+  GtkSortListModel *sort;
+  GListStore *store;
+
+  store = new_store ((guint[]) { 10, 20, 30, 40, 50, 0 });
+  sort = new_model (NULL);
+  gtk_sort_list_model_set_model (sort, G_LIST_MODEL (store));
+  assert_model (sort, "10 20 30 40 50");
+  ignore_changes (sort);
+
+  splice (store, 2, 0, (guint[]) { 35, 15 }, 2);
+  assert_model (sort, "10 20 35 15 30 40 50");
+  assert_changes (sort, "2+2*");
+
+  g_object_unref (store);
+  g_object_unref (sort);
+}
+
+static void
+test_insert_items_many (void)
+{
+  GtkSortListModel *sort;
+  GListStore *store;
+  guint *numbers;
+  guint i, n;
+
+  store = new_store ((guint[]) { 1, 0 });
+  sort = new_model (store);
+  assert_changes (sort, "");
+
+  /* too many to insert one by one, so they get sorted */
+  n = 3000;
+  numbers = g_new (guint, n);
+  for (i = 0; i < n; i++)
+    numbers[i] = n + 1 - i;
+  splice (store, 0, 0, numbers, n);
+  g_free (numbers);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (sort)), ==, n + 1);
+  for (i = 0; i <= n; i++)
+    g_assert_cmpuint (get (G_LIST_MODEL (sort), i), ==, i + 1);
+  ignore_changes (sort);
+
+  g_object_unref (store);
+  g_object_unref (sort);
+}
+
 static void
 test_out_of_bounds_access (void)
 {
@@ -570,6 +713,88 @@ test_add_remove_item (void)
   g_object_unref (sort);
 }
 
+static void
+assert_same_order (GListModel *model1,
+                   GListModel *model2)
+{
+  guint i, n;
+
+  n = g_list_model_get_n_items (model1);
+  g_assert_cmpuint (g_list_model_get_n_items (model2), ==, n);
+
+  for (i = 0; i < n; i++)
+    {
+      GObject *item1 = g_list_model_get_item (model1, i);
+      GObject *item2 = g_list_model_get_item (model2, i);
+
+      g_assert_true (item1 == item2);
+
+      g_object_unref (item1);
+      g_object_unref (item2);
+    }
+}
+
+static void
+wait_for_sort (GtkSortListModel *model)
+{
+  while (gtk_sort_list_model_get_pending (model) != 0)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+/* Large models are sorted on multiple threads when sorting in one go.
+ * Compare them to an incremental sort, which always uses one thread.
+ */
+static void
+test_parallel (void)
+{
+  GtkSortListModel *parallel, *serial;
+  GtkStringList *list;
+  GtkStringSorter *sorter;
+  char buffer[32];
+  char **strings;
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  /* Well above the threshold, with lots of equal strings that only
+   * differ in case to check the sort stays stable.
+   */
+  for (i = 0; i < 100000; i++)
+    {
+      g_snprintf (buffer, sizeof (buffer), i % 2 ? "Item %u" : "item %u", g_random_int_range (0, 1000));
+      gtk_string_list_append (list, buffer);
+    }
+
+  sorter = gtk_string_sorter_new (gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string"));
+
+  parallel = gtk_sort_list_model_new (g_object_ref (G_LIST_MODEL (list)), g_object_ref (GTK_SORTER (sorter)));
+  serial = gtk_sort_list_model_new (NULL, g_object_ref (GTK_SORTER (sorter)));
+  gtk_sort_list_model_set_incremental (serial, TRUE);
+  gtk_sort_list_model_set_model (serial, G_LIST_MODEL (list));
+  wait_for_sort (serial);
+
+  assert_same_order (G_LIST_MODEL (parallel), G_LIST_MODEL (serial));
+
+  /* resorting with new keys */
+  gtk_string_sorter_set_ignore_case (sorter, FALSE);
+  wait_for_sort (serial);
+  assert_same_order (G_LIST_MODEL (parallel), G_LIST_MODEL (serial));
+
+  /* and when replacing lots of items, so only some keys are new */
+  strings = g_new (char *, 50001);
+  for (i = 0; i < 50000; i++)
+    strings[i] = g_strdup_printf ("ITEM %u", g_random_int_range (0, 1000));
+  strings[50000] = NULL;
+  gtk_string_list_splice (list, 10000, 50000, (const char * const *) strings);
+  g_strfreev (strings);
+  wait_for_sort (serial);
+  assert_same_order (G_LIST_MODEL (parallel), G_LIST_MODEL (serial));
+
+  g_object_unref (parallel);
+  g_object_unref (serial);
+  g_object_unref (sorter);
+  g_object_unref (list);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -591,6 +816,13 @@ main (int argc, char *argv[])
   g_test_add_func ("/sortlistmodel/incremental/remove", test_incremental_remove);
   g_test_add_func ("/sortlistmodel/oob-access", test_out_of_bounds_access);
   g_test_add_func ("/sortlistmodel/add-remove-item", test_add_remove_item);
+  g_test_add_func ("/sortlistmodel/parallel", test_parallel);
+#if GLIB_CHECK_VERSION (2, 58, 0) /* g_list_store_splice() is broken before 2.58 */
+  g_test_add_func ("/sortlistmodel/insert-items", test_insert_items);
+  g_test_add_func ("/sortlistmodel/insert-items/incremental", test_insert_items_incremental);
+  g_test_add_func ("/sortlistmodel/insert-items/unsorted", test_insert_items_unsorted);
+  g_test_add_func ("/sortlistmodel/insert-items/many", test_insert_items_many);
+#endif
 
   return g_test_run ();
 }
@@ -17,6 +17,8 @@
  * License along with this library. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
+
 #include <gtk/gtk.h>
 
 static GQuark changes_quark;
@@ -242,6 +244,69 @@ test_take (void)
   g_object_unref (list);
 }
 
+static void
+test_append_strings (void)
+{
+  GtkStringList *list;
+
+  list = new_model ((const char *[]){ "a", NULL });
+
+  gtk_string_list_append_strings (list, (const char *[]){ "b", "c", "d", NULL }, -1);
+  assert_model (list, "a b c d");
+  assert_changes (list, "1+3");
+
+  gtk_string_list_append_strings (list, (const char *[]){ "e", "f", "g" }, 2);
+  assert_model (list, "a b c d e f");
+  assert_changes (list, "4+2");
+
+  gtk_string_list_append_strings (list, NULL, 0);
+  assert_changes (list, "");
+
+  g_object_unref (list);
+}
+
+static void
+test_items (void)
+{
+  GtkStringList *list;
+  GtkStringObject *item, *other;
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 10000; i++)
+    {
+      char *s = g_strdup_printf ("%u", i % 100);
+      gtk_string_list_append (list, s);
+      g_free (s);
+    }
+
+  item = g_list_model_get_item (G_LIST_MODEL (list), 42);
+  other = g_list_model_get_item (G_LIST_MODEL (list), 42);
+  g_assert_true (item == other);
+  g_object_unref (other);
+
+  /* Objects are kept, even when only the list references them */
+  g_object_set_data (G_OBJECT (item), "marker", GUINT_TO_POINTER (42));
+  g_object_unref (item);
+  for (i = 0; i < 10000; i++)
+    {
+      other = g_list_model_get_item (G_LIST_MODEL (list), i);
+      g_assert_cmpuint (atoi (gtk_string_object_get_string (other)), ==, i % 100);
+      g_object_unref (other);
+    }
+
+  item = g_list_model_get_item (G_LIST_MODEL (list), 42);
+  g_assert_cmpuint (GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (item), "marker")), ==, 42);
+
+  /* Items stay valid after being removed from the list */
+  gtk_string_list_splice (list, 0, 100, NULL);
+  g_assert_cmpstr (gtk_string_object_get_string (item), ==, "42");
+  g_assert_cmpstr (gtk_string_list_get_string (list, 42), ==, "42");
+  g_object_unref (item);
+
+  g_object_unref (list);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -257,6 +322,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/stringlist/splice", test_splice);
   g_test_add_func ("/stringlist/add_remove", test_add_remove);
   g_test_add_func ("/stringlist/take", test_take);
+  g_test_add_func ("/stringlist/append_strings", test_append_strings);
+  g_test_add_func ("/stringlist/items", test_items);
 
   return g_test_run ();
 }
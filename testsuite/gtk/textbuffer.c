@@ -19,10 +19,14 @@
 #include "config.h"
 #include <stdio.h>
 #include <string.h>
+#ifdef HAVE_MALLINFO2
+#include <malloc.h>
+#endif
 
 #include <gtk/gtk.h>
 #include "gtk/gtktexttypes.h" /* Private header, for UNKNOWN_CHAR */
 #include "gtk/gtktextbufferprivate.h" /* Private header */
+#include "gtk/gtktextlayoutprivate.h" /* Private header */
 
 static void
 gtk_text_iter_spew (const GtkTextIter *iter, const char *desc)
@@ -1295,6 +1299,511 @@ test_get_set(void)
   g_object_unref (buffer);
 }
 
+typedef struct {
+  gboolean done;
+  GError *error;
+} TaskResult;
+
+static void
+load_done (GObject      *source,
+           GAsyncResult *result,
+           gpointer      data)
+{
+  TaskResult *load = data;
+
+  gtk_text_buffer_load_finish (GTK_TEXT_BUFFER (source), result, &load->error);
+  load->done = TRUE;
+  g_main_context_wakeup (NULL);
+}
+
+static void
+search_done (GObject      *source,
+             GAsyncResult *result,
+             gpointer      data)
+{
+  TaskResult *search = data;
+
+  gtk_text_buffer_search_finish (GTK_TEXT_BUFFER (source), result, &search->error);
+  search->done = TRUE;
+  g_main_context_wakeup (NULL);
+}
+
+typedef struct {
+  goffset current;
+  gboolean destroyed;
+} ProgressResult;
+
+static void
+load_progress (goffset  current,
+               goffset  total,
+               gpointer data)
+{
+  ProgressResult *progress = data;
+
+  g_assert_false (progress->destroyed);
+  g_assert_cmpint (current, >=, progress->current);
+  g_assert_cmpint (current, <=, total);
+  progress->current = current;
+}
+
+static void
+set_destroyed (gpointer data)
+{
+  gboolean *destroyed = data;
+
+  g_assert_false (*destroyed);
+  *destroyed = TRUE;
+}
+
+static void
+progress_destroyed (gpointer data)
+{
+  ProgressResult *progress = data;
+
+  set_destroyed (&progress->destroyed);
+}
+
+static gboolean
+load_text (GtkTextBuffer *buffer,
+           const char    *text,
+           gsize          len,
+           GError       **error)
+{
+  GInputStream *stream;
+  TaskResult load = { FALSE, NULL };
+  ProgressResult progress = { 0, FALSE };
+
+  stream = g_memory_input_stream_new_from_data (text, len, NULL);
+  gtk_text_buffer_load_async (buffer, stream, G_PRIORITY_DEFAULT, NULL,
+                              load_progress, &progress, progress_destroyed,
+                              load_done, &load);
+  g_object_unref (stream);
+
+  while (!load.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* The progress data is released before the result is returned */
+  g_assert_true (progress.destroyed);
+
+  if (load.error)
+    {
+      g_propagate_error (error, load.error);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+append_lines (GString *text,
+              gsize    len)
+{
+  while (text->len < len)
+    g_string_append_c (text, text->len % 80 == 79 ? '\n' : 'a');
+}
+
+static void
+test_load (void)
+{
+  GtkTextBuffer *buffer, *compare;
+  GtkTextIter start, end;
+  GString *text;
+  GError *error = NULL;
+  char *result;
+
+  /* The stream is read in chunks of 64kB, make sure they split
+   * a multibyte character and a \r\n paragraph delimiter.
+   */
+  text = g_string_new (NULL);
+  append_lines (text, 65535);
+  g_string_append (text, "\xe2\x82\xac"); /* € */
+  append_lines (text, 131070);
+  g_string_append (text, "\r\n");
+  append_lines (text, 4 * 65536);
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "Some old text", -1);
+
+  g_assert_true (load_text (buffer, text->str, text->len, &error));
+  g_assert_no_error (error);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  result = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (result, ==, text->str);
+  g_free (result);
+
+  compare = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (compare, text->str, text->len);
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, gtk_text_buffer_get_line_count (compare));
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, gtk_text_buffer_get_char_count (compare));
+  g_assert_false (gtk_text_buffer_get_can_undo (buffer));
+  g_object_unref (compare);
+
+  /* invalid UTF-8 leaves the buffer alone */
+  g_string_append (text, "\xff");
+  g_assert_false (load_text (buffer, text->str, text->len, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+  g_clear_error (&error);
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, g_utf8_strlen (text->str, text->len - 1));
+
+  g_assert_true (load_text (buffer, "", 0, &error));
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, 0);
+
+  g_string_free (text, TRUE);
+  g_object_unref (buffer);
+}
+
+typedef struct {
+  GArray *matches;
+  gboolean destroyed;
+} SearchMatches;
+
+static void
+search_match (GtkTextBuffer     *buffer,
+              const GtkTextIter *match_start,
+              const GtkTextIter *match_end,
+              gpointer           data)
+{
+  SearchMatches *search = data;
+  int offsets[2] = { gtk_text_iter_get_offset (match_start), gtk_text_iter_get_offset (match_end) };
+
+  g_assert_false (search->destroyed);
+  g_array_append_vals (search->matches, offsets, 2);
+}
+
+static void
+search_matches_destroyed (gpointer data)
+{
+  SearchMatches *search = data;
+
+  set_destroyed (&search->destroyed);
+}
+
+static int
+compare_matches (gconstpointer a,
+                 gconstpointer b,
+                 gpointer      data)
+{
+  const int *ma = a, *mb = b;
+
+  return ma[0] - mb[0];
+}
+
+static GArray *
+search_text (GtkTextBuffer       *buffer,
+             const char          *pattern,
+             GRegexCompileFlags   flags,
+             GError             **error)
+{
+  TaskResult search = { FALSE, NULL };
+  SearchMatches data = { NULL, FALSE };
+  GArray *matches;
+  GRegex *regex;
+
+  regex = g_regex_new (pattern, flags, 0, NULL);
+  matches = g_array_new (FALSE, FALSE, sizeof (int));
+  data.matches = matches;
+  gtk_text_buffer_search_async (buffer, regex, NULL,
+                                search_match, &data, search_matches_destroyed,
+                                search_done, &search);
+  g_regex_unref (regex);
+
+  while (!search.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* The match data is released before the result is returned */
+  g_assert_true (data.destroyed);
+
+  if (search.error)
+    {
+      g_propagate_error (error, search.error);
+      g_array_unref (matches);
+      return NULL;
+    }
+
+  /* The parts of the buffer are searched in parallel */
+  g_qsort_with_data (matches->data, matches->len / 2, 2 * sizeof (int),
+                     compare_matches, NULL);
+
+  return matches;
+}
+
+static void
+check_search (GtkTextBuffer      *buffer,
+              const char         *pattern,
+              GRegexCompileFlags  flags,
+              const char         *search_string)
+{
+  GtkTextIter iter, match_start, match_end;
+  GError *error = NULL;
+  GArray *matches;
+  guint i;
+
+  matches = search_text (buffer, pattern, flags, &error);
+  g_assert_no_error (error);
+
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  for (i = 0; gtk_text_iter_forward_search (&iter, search_string, 0, &match_start, &match_end, NULL); i += 2)
+    {
+      g_assert_cmpuint (i, <, matches->len);
+      g_assert_cmpint (g_array_index (matches, int, i), ==, gtk_text_iter_get_offset (&match_start));
+      g_assert_cmpint (g_array_index (matches, int, i + 1), ==, gtk_text_iter_get_offset (&match_end));
+      iter = match_end;
+    }
+  g_assert_cmpuint (i, ==, matches->len);
+
+  g_array_unref (matches);
+}
+
+static void
+test_search (void)
+{
+  GtkTextBuffer *buffer;
+  GString *text;
+  guint i;
+
+  text = g_string_new (NULL);
+  for (i = 0; i < 20000; i++)
+    {
+      if (i % 7 == 0)
+        g_string_append (text, "€ a needle in ");
+      g_string_append_printf (text, "line %u of a haystack", i);
+      if (i % 13 == 0)
+        g_string_append (text, " needle needle");
+      g_string_append_c (text, '\n');
+    }
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+
+  check_search (buffer, "needle", 0, "needle");
+  check_search (buffer, "ne+dle", 0, "needle");
+  check_search (buffer, "NEEDLE", G_REGEX_CASELESS, "needle");
+  check_search (buffer, "nothing", 0, "nothing");
+
+  g_string_free (text, TRUE);
+  g_object_unref (buffer);
+}
+
+static void
+test_search_changed (void)
+{
+  TaskResult search = { FALSE, NULL };
+  SearchMatches data = { NULL, FALSE };
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  GArray *matches;
+  GRegex *regex;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "a needle\nand another needle", -1);
+
+  matches = g_array_new (FALSE, FALSE, sizeof (int));
+  data.matches = matches;
+  regex = g_regex_new ("needle", 0, 0, NULL);
+  gtk_text_buffer_search_async (buffer, regex, NULL,
+                                search_match, &data, search_matches_destroyed,
+                                search_done, &search);
+
+  /* The matches would be at the wrong offsets now */
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  gtk_text_buffer_insert (buffer, &iter, "x", 1);
+
+  while (!search.done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_error (search.error, G_IO_ERROR, G_IO_ERROR_FAILED);
+  g_assert_cmpuint (matches->len, ==, 0);
+  g_assert_true (data.destroyed);
+
+  g_clear_error (&search.error);
+  g_regex_unref (regex);
+  g_array_unref (matches);
+  g_object_unref (buffer);
+}
+
+static GtkTextTagRange *
+create_tag_ranges (GtkTextTag **tags,
+                   guint        n_tags,
+                   guint        n_ranges,
+                   int          n_chars)
+{
+  GtkTextTagRange *ranges;
+  guint i;
+
+  ranges = g_new (GtkTextTagRange, n_ranges);
+  for (i = 0; i < n_ranges; i++)
+    {
+      ranges[i].tag = tags[g_test_rand_int_range (0, n_tags)];
+      ranges[i].start = g_test_rand_int_range (0, n_chars);
+      ranges[i].end = MIN (ranges[i].start + g_test_rand_int_range (1, 20), n_chars);
+    }
+
+  return ranges;
+}
+
+static void
+test_apply_tag_ranges (void)
+{
+  GtkTextBuffer *buffer, *compare;
+  GtkTextTag *tags[3], *compare_tags[3];
+  GtkTextTagRange *ranges;
+  GtkTextIter iter, compare_iter;
+  int n_chars;
+  guint i;
+
+  buffer = gtk_text_buffer_new (NULL);
+  compare = gtk_text_buffer_new (NULL);
+  for (i = 0; i < G_N_ELEMENTS (tags); i++)
+    {
+      tags[i] = gtk_text_buffer_create_tag (buffer, NULL, "weight", 700 + 100 * i, NULL);
+      compare_tags[i] = gtk_text_buffer_create_tag (compare, NULL, "weight", 700 + 100 * i, NULL);
+    }
+
+  fill_buffer (buffer);
+  fill_buffer (compare);
+  n_chars = gtk_text_buffer_get_char_count (buffer);
+
+  ranges = create_tag_ranges (tags, G_N_ELEMENTS (tags), 500, n_chars);
+  /* Empty and reversed ranges are fine */
+  ranges[0].end = ranges[0].start;
+  ranges[1].start = ranges[1].end + 5;
+
+  gtk_text_buffer_apply_tag_ranges (buffer, ranges, 500);
+
+  for (i = 0; i < 500; i++)
+    {
+      GtkTextIter start, end;
+      guint t;
+
+      for (t = 0; ranges[i].tag != tags[t]; t++)
+        ;
+
+      gtk_text_buffer_get_iter_at_offset (compare, &start, ranges[i].start);
+      gtk_text_buffer_get_iter_at_offset (compare, &end, ranges[i].end);
+      gtk_text_buffer_apply_tag (compare, compare_tags[t], &start, &end);
+    }
+
+  /* Both buffers must toggle the same tags in the same places */
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  gtk_text_buffer_get_start_iter (compare, &compare_iter);
+  do
+    {
+      for (i = 0; i < G_N_ELEMENTS (tags); i++)
+        {
+          g_assert_cmpint (gtk_text_iter_toggles_tag (&iter, tags[i]), ==,
+                           gtk_text_iter_toggles_tag (&compare_iter, compare_tags[i]));
+          g_assert_cmpint (gtk_text_iter_has_tag (&iter, tags[i]), ==,
+                           gtk_text_iter_has_tag (&compare_iter, compare_tags[i]));
+        }
+
+      gtk_text_iter_forward_to_tag_toggle (&compare_iter, NULL);
+    }
+  while (gtk_text_iter_forward_to_tag_toggle (&iter, NULL));
+
+  g_assert_cmpint (gtk_text_iter_get_offset (&iter), ==, gtk_text_iter_get_offset (&compare_iter));
+
+  g_free (ranges);
+  g_object_unref (buffer);
+  g_object_unref (compare);
+}
+
+typedef struct {
+  int y;
+  int height;
+} LayoutChange;
+
+static void
+layout_changed (GtkTextLayout *layout,
+                int            y,
+                int            old_height,
+                int            new_height,
+                GArray        *changes)
+{
+  LayoutChange change = { y, old_height };
+
+  g_array_append_val (changes, change);
+}
+
+static void
+set_line_range (GtkTextBuffer   *buffer,
+                GtkTextTagRange *range,
+                GtkTextTag      *tag,
+                int              line)
+{
+  GtkTextIter iter;
+
+  range->tag = tag;
+  gtk_text_buffer_get_iter_at_line (buffer, &iter, line);
+  range->start = gtk_text_iter_get_offset (&iter);
+  gtk_text_iter_forward_line (&iter);
+  range->end = gtk_text_iter_get_offset (&iter);
+}
+
+/* Tagging far apart ranges in a batch must only redraw those,
+ * not everything between them.
+ */
+static void
+test_apply_tag_ranges_redisplay (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextLayout *layout;
+  GtkTextAttributes *style;
+  PangoContext *context;
+  GtkTextTagRange ranges[5];
+  GtkTextTag *tag;
+  GArray *changes;
+  GString *text;
+  int height;
+  guint i;
+
+  buffer = gtk_text_buffer_new (NULL);
+  text = g_string_new (NULL);
+  for (i = 0; i < 1000; i++)
+    g_string_append_printf (text, "line %u\n", i);
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+  g_string_free (text, TRUE);
+  tag = gtk_text_buffer_create_tag (buffer, NULL, "foreground", "red", NULL);
+
+  context = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+  layout = gtk_text_layout_new ();
+  gtk_text_layout_set_contexts (layout, context, context);
+  style = gtk_text_attributes_new ();
+  style->font = pango_font_description_from_string ("Sans 10");
+  gtk_text_layout_set_default_style (layout, style);
+  gtk_text_attributes_unref (style);
+  gtk_text_layout_set_buffer (layout, buffer);
+  gtk_text_layout_validate (layout, G_MAXINT);
+  gtk_text_layout_get_size (layout, NULL, &height);
+
+  changes = g_array_new (FALSE, FALSE, sizeof (LayoutChange));
+  g_signal_connect (layout, "changed", G_CALLBACK (layout_changed), changes);
+
+  /* Out of order, with the two ranges in the middle touching */
+  set_line_range (buffer, &ranges[0], tag, 999);
+  set_line_range (buffer, &ranges[1], tag, 501);
+  set_line_range (buffer, &ranges[2], tag, 0);
+  set_line_range (buffer, &ranges[3], tag, 500);
+  set_line_range (buffer, &ranges[4], tag, 999);
+  gtk_text_buffer_apply_tag_ranges (buffer, ranges, G_N_ELEMENTS (ranges));
+
+  g_assert_cmpuint (changes->len, ==, 3);
+  for (i = 0; i < changes->len; i++)
+    {
+      LayoutChange *change = &g_array_index (changes, LayoutChange, i);
+
+      if (i > 0)
+        g_assert_cmpint (change->y, >, g_array_index (changes, LayoutChange, i - 1).y);
+      g_assert_cmpint (change->height, <, height / 100);
+    }
+
+  g_array_unref (changes);
+  gtk_text_layout_set_buffer (layout, NULL);
+  g_object_unref (layout);
+  g_object_unref (context);
+  g_object_unref (buffer);
+}
+
 static void
 test_fill_empty (void)
 {
@@ -1770,6 +2279,34 @@ test_undo2 (void)
   g_object_unref (buffer);
 }
 
+/* Check that the byte budget drops the oldest actions */
+static void
+test_undo_max_bytes (void)
+{
+  GtkTextBuffer *buffer;
+  const char *text;
+
+  buffer = gtk_text_buffer_new (NULL);
+
+  g_assert_cmpuint (gtk_text_buffer_get_max_undo_bytes (buffer), ==, 64 * 1024 * 1024);
+
+  text = "The quick brown fox jumps over the lazy dog.";
+  gtk_text_buffer_insert_at_cursor (buffer, text, strlen (text));
+
+  text = "Θέλει αρετή και τόλμη η ελευθερία. (Ανδρέας Κάλβος)";
+  gtk_text_buffer_insert_at_cursor (buffer, text, strlen (text));
+
+  gtk_text_buffer_set_max_undo_bytes (buffer, 1);
+  g_assert_cmpuint (gtk_text_buffer_get_max_undo_bytes (buffer), ==, 1);
+  g_assert_true (gtk_text_buffer_get_can_undo (buffer));
+
+  gtk_text_buffer_undo (buffer);
+  check_buffer_contents (buffer, "The quick brown fox jumps over the lazy dog.");
+  g_assert_false (gtk_text_buffer_get_can_undo (buffer));
+
+  g_object_unref (buffer);
+}
+
 /* Simulate typing, check that words get batched togethe */
 static void
 test_undo3 (void)
@@ -1876,6 +2413,144 @@ test_serialize_wrap_mode (void)
   g_assert_finalize_object (buffer);
 }
 
+static gsize
+get_allocated_bytes (void)
+{
+#ifdef HAVE_MALLINFO2
+  return mallinfo2 ().uordblks;
+#else
+  return 0;
+#endif
+}
+
+static void
+test_performance (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  GString *text;
+  gint64 start, end;
+  gsize bytes;
+  guint flags;
+  int i, n_lines;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Run with -m perf to benchmark");
+      return;
+    }
+
+  /* checking the tree after every change is not what we want to measure */
+  flags = gtk_get_debug_flags ();
+  gtk_set_debug_flags (flags & ~GTK_DEBUG_TEXT);
+
+  /* something like a log file */
+  text = g_string_new (NULL);
+  for (i = 0; i < 1000000; i++)
+    g_string_append_printf (text, "%08d INFO something happened in module %d\n", i, i % 97);
+
+  bytes = get_allocated_bytes ();
+  start = g_get_monotonic_time ();
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, text->str, text->len);
+  end = g_get_monotonic_time ();
+  n_lines = gtk_text_buffer_get_line_count (buffer);
+  g_test_message ("set_text: %d lines in %uus, %zu bytes of text, %zu bytes allocated",
+                  n_lines, (guint) (end - start), text->len, get_allocated_bytes () - bytes);
+
+  start = g_get_monotonic_time ();
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  while (gtk_text_iter_forward_line (&iter))
+    ;
+  end = g_get_monotonic_time ();
+  g_test_message ("forward_line: %d lines in %uus", n_lines, (guint) (end - start));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < 100000; i++)
+    gtk_text_buffer_get_iter_at_line (buffer, &iter, g_test_rand_int_range (0, n_lines));
+  end = g_get_monotonic_time ();
+  g_test_message ("get_iter_at_line: 100000 lookups in %uus", (guint) (end - start));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < 100000; i++)
+    gtk_text_buffer_get_iter_at_offset (buffer, &iter, g_test_rand_int_range (0, gtk_text_buffer_get_char_count (buffer)));
+  end = g_get_monotonic_time ();
+  g_test_message ("get_iter_at_offset: 100000 lookups in %uus", (guint) (end - start));
+
+  g_object_unref (buffer);
+  g_string_free (text, TRUE);
+
+  gtk_set_debug_flags (flags);
+}
+
+static void
+test_tag_performance (void)
+{
+  GtkWidget *view;
+  GtkTextBuffer *buffer;
+  GtkTextTag *tags[8];
+  GtkTextTagRange *ranges;
+  gint64 start, end;
+  guint flags;
+  int i, n_chars;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Run with -m perf to benchmark");
+      return;
+    }
+
+  flags = gtk_get_debug_flags ();
+  gtk_set_debug_flags (flags & ~GTK_DEBUG_TEXT);
+
+  /* A view, so that tagging has layouts to invalidate */
+  view = g_object_ref_sink (gtk_text_view_new ());
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+  for (i = 0; i < 10000; i++)
+    {
+      GtkTextIter iter;
+
+      gtk_text_buffer_get_end_iter (buffer, &iter);
+      gtk_text_buffer_insert (buffer, &iter, "static int foo (const char *bar) { return strlen (bar); }\n", -1);
+    }
+  n_chars = gtk_text_buffer_get_char_count (buffer);
+
+  for (i = 0; i < G_N_ELEMENTS (tags); i++)
+    tags[i] = gtk_text_buffer_create_tag (buffer, NULL, "weight", 100 * (i + 1), NULL);
+
+  ranges = create_tag_ranges (tags, G_N_ELEMENTS (tags), 20000, n_chars);
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < 20000; i++)
+    {
+      GtkTextIter range_start, range_end;
+
+      gtk_text_buffer_get_iter_at_offset (buffer, &range_start, ranges[i].start);
+      gtk_text_buffer_get_iter_at_offset (buffer, &range_end, ranges[i].end);
+      gtk_text_buffer_apply_tag (buffer, ranges[i].tag, &range_start, &range_end);
+    }
+  end = g_get_monotonic_time ();
+  g_test_message ("apply_tag: 20000 ranges in %uus", (guint) (end - start));
+
+  for (i = 0; i < G_N_ELEMENTS (tags); i++)
+    {
+      GtkTextIter range_start, range_end;
+
+      gtk_text_buffer_get_bounds (buffer, &range_start, &range_end);
+      gtk_text_buffer_remove_tag (buffer, tags[i], &range_start, &range_end);
+    }
+
+  start = g_get_monotonic_time ();
+  gtk_text_buffer_apply_tag_ranges (buffer, ranges, 20000);
+  end = g_get_monotonic_time ();
+  g_test_message ("apply_tag_ranges: 20000 ranges in %uus", (guint) (end - start));
+
+  g_free (ranges);
+  g_object_unref (view);
+
+  gtk_set_debug_flags (flags);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1891,6 +2566,11 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Marks", test_marks);
   g_test_add_func ("/TextBuffer/Empty buffer", test_empty_buffer);
   g_test_add_func ("/TextBuffer/Get and Set", test_get_set);
+  g_test_add_func ("/TextBuffer/Load", test_load);
+  g_test_add_func ("/TextBuffer/Search", test_search);
+  g_test_add_func ("/TextBuffer/Search/changed", test_search_changed);
+  g_test_add_func ("/TextBuffer/Apply tag ranges", test_apply_tag_ranges);
+  g_test_add_func ("/TextBuffer/Apply tag ranges redisplay", test_apply_tag_ranges_redisplay);
   g_test_add_func ("/TextBuffer/Fill and Empty", test_fill_empty);
   g_test_add_func ("/TextBuffer/Tag", test_tag);
   g_test_add_func ("/TextBuffer/Clipboard", test_clipboard);
@@ -1901,7 +2581,10 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Undo 1", test_undo1);
   g_test_add_func ("/TextBuffer/Undo 2", test_undo2);
   g_test_add_func ("/TextBuffer/Undo 3", test_undo3);
+  g_test_add_func ("/TextBuffer/Undo max bytes", test_undo_max_bytes);
   g_test_add_func ("/TextBuffer/Serialize wrap-mode", test_serialize_wrap_mode);
+  g_test_add_func ("/TextBuffer/performance", test_performance);
+  g_test_add_func ("/TextBuffer/tag-performance", test_tag_performance);
 
   return g_test_run();
 }
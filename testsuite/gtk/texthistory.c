@@ -635,6 +635,95 @@ test_issue_4575 (void)
   run_test (commands, G_N_ELEMENTS (commands), 0);
 }
 
+static void
+test_max_bytes (void)
+{
+  Text *text = text_new ();
+  Command cmd = { INSERT, 0, -1, NULL, NULL, SET, UNSET, UNSET };
+  char *chunks[3];
+  GString *expected;
+  guint i;
+
+  /* Large enough to be compressed once they are not the last action */
+  expected = g_string_new (NULL);
+  for (i = 0; i < G_N_ELEMENTS (chunks); i++)
+    {
+      GString *str = g_string_new (NULL);
+
+      while (str->len < 64 * 1024)
+        g_string_append_printf (str, "line %u of chunk %u\n", str->len, i);
+      chunks[i] = g_string_free (str, FALSE);
+
+      cmd.location = expected->len;
+      cmd.text = chunks[i];
+      command_insert (&cmd, text);
+      g_string_append (expected, chunks[i]);
+    }
+
+  /* Undo and redo everything, the text must survive compression */
+  for (i = 0; i < G_N_ELEMENTS (chunks); i++)
+    gtk_text_history_undo (text->history);
+  g_assert_cmpstr (text->buf->str, ==, "");
+  g_assert_false (text->can_undo);
+
+  for (i = 0; i < G_N_ELEMENTS (chunks); i++)
+    gtk_text_history_redo (text->history);
+  g_assert_cmpstr (text->buf->str, ==, expected->str);
+  g_assert_false (text->can_redo);
+
+  /* Only the last action is kept when it doesn't fit */
+  gtk_text_history_set_max_bytes (text->history, 1);
+  gtk_text_history_undo (text->history);
+  g_assert_cmpuint (text->buf->len, ==, expected->len - strlen (chunks[2]));
+  g_assert_false (text->can_undo);
+  g_assert_true (text->can_redo);
+
+  for (i = 0; i < G_N_ELEMENTS (chunks); i++)
+    g_free (chunks[i]);
+  g_string_free (expected, TRUE);
+  text_free (text);
+}
+
+static void
+test_max_bytes_group (void)
+{
+  Text *text = text_new ();
+  Command cmd = { INSERT, 0, -1, NULL, NULL, SET, UNSET, UNSET };
+  GString *str;
+  char *chunk;
+
+  str = g_string_new (NULL);
+  while (str->len < 64 * 1024)
+    g_string_append_printf (str, "line %u\n", str->len);
+  chunk = g_string_free (str, FALSE);
+
+  /* Two inserts that don't chain, so the group is kept and its
+   * texts get compressed when the user action ends.
+   */
+  gtk_text_history_begin_user_action (text->history);
+  cmd.text = chunk;
+  command_insert (&cmd, text);
+  command_insert (&cmd, text);
+  gtk_text_history_end_user_action (text->history);
+
+  cmd.location = text->buf->len;
+  cmd.text = "end";
+  command_insert (&cmd, text);
+
+  gtk_text_history_undo (text->history);
+  gtk_text_history_undo (text->history);
+  g_assert_cmpstr (text->buf->str, ==, "");
+  g_assert_false (text->can_undo);
+
+  gtk_text_history_redo (text->history);
+  g_assert_cmpuint (text->buf->len, ==, 2 * strlen (chunk));
+  g_assert_true (g_str_has_prefix (text->buf->str, chunk));
+  g_assert_true (g_str_has_suffix (text->buf->str, chunk));
+
+  g_free (chunk);
+  text_free (text);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -657,6 +746,8 @@ main (int   argc,
   g_test_add_func ("/Gtk/TextHistory/test14", test14);
   g_test_add_func ("/Gtk/TextHistory/issue_4276", test_issue_4276);
   g_test_add_func ("/Gtk/TextHistory/issue_4575", test_issue_4575);
+  g_test_add_func ("/Gtk/TextHistory/max_bytes", test_max_bytes);
+  g_test_add_func ("/Gtk/TextHistory/max_bytes_group", test_max_bytes_group);
 
   return g_test_run ();
 }
@@ -242,6 +242,36 @@ test_steps (void)
   g_free (a);
 }
 
+static void
+test_parallel (void)
+{
+  GtkTimSortRun change;
+  GtkTimSort sort;
+  int *a, *b;
+  gsize i, n;
+
+  n = g_test_rand_int_range (200 * 1000, 500 * 1000);
+
+  a = g_new (int, n);
+  for (i = 0; i < n; i++)
+    a[i] = g_test_rand_int ();
+  b = g_memdup2 (a, sizeof (int) * n);
+
+  gtk_tim_sort_init (&sort, a, n, sizeof (int), compare_int, NULL);
+  gtk_tim_sort_presort_parallel (&sort, g_test_rand_int_range (2, 9), &change);
+  g_assert_true (change.base == a);
+  g_assert_cmpuint (change.len, ==, n);
+
+  while (gtk_tim_sort_step (&sort, NULL));
+  gtk_tim_sort_finish (&sort);
+
+  g_qsort_with_data (b, n, sizeof (int), compare_int, NULL);
+  assert_sort_equal (a, b, int, n);
+
+  g_free (b);
+  g_free (a);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -254,6 +284,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/timsort/pointers", test_pointers);
   g_test_add_func ("/timsort/pointers/huge", test_pointers_huge);
   g_test_add_func ("/timsort/steps", test_steps);
+  g_test_add_func ("/timsort/parallel", test_parallel);
 
   return g_test_run ();
 }
@@ -380,6 +380,166 @@ test_collapse_change (void)
   g_object_unref (a);
 }
 
+#define ensure_updated() G_STMT_START{ \
+  while (g_main_context_pending (NULL)) \
+    g_main_context_iteration (NULL, TRUE); \
+}G_STMT_END
+
+static void
+test_incremental (void)
+{
+  GtkTreeListModel *tree, *compare;
+  char *expected;
+
+  compare = gtk_tree_list_model_new (G_LIST_MODEL (new_store (1000, 1000, 1000)), TRUE, TRUE, create_sub_model_cb, NULL, NULL);
+  expected = model_to_string (G_LIST_MODEL (compare));
+  g_object_unref (compare);
+
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (new_store (1000, 1000, 1000)), TRUE, FALSE, create_sub_model_cb, NULL, NULL);
+  gtk_tree_list_model_set_incremental (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+  assert_model (tree, "1000");
+
+  ensure_updated ();
+  assert_model (tree, expected);
+  g_object_unref (tree);
+
+  /* turning it off expands everything right away */
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (new_store (1000, 1000, 1000)), TRUE, FALSE, create_sub_model_cb, NULL, NULL);
+  gtk_tree_list_model_set_incremental (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+  gtk_tree_list_model_set_incremental (tree, FALSE);
+  assert_model (tree, expected);
+  g_object_unref (tree);
+
+  g_free (expected);
+}
+
+static void
+test_incremental_collapse (void)
+{
+  GtkTreeListModel *tree;
+  GtkTreeListRow *row;
+
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (new_store (100, 100, 100)), TRUE, FALSE, create_sub_model_cb, NULL, NULL);
+  gtk_tree_list_model_set_incremental (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+
+  /* collapsing a row that is waiting to be expanded keeps it collapsed */
+  row = gtk_tree_list_model_get_row (tree, 0);
+  g_assert_false (gtk_tree_list_row_get_expanded (row));
+  gtk_tree_list_row_set_expanded (row, FALSE);
+  ensure_updated ();
+  g_assert_false (gtk_tree_list_row_get_expanded (row));
+  assert_model (tree, "100");
+
+  gtk_tree_list_row_set_expanded (row, TRUE);
+  assert_model (tree, "100 100 90 80 70 60 50 40 30 20 10");
+  ensure_updated ();
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (tree)), ==, 111);
+
+  g_object_unref (row);
+  g_object_unref (tree);
+}
+
+static void
+collapse_first_row_cb (GListModel *model,
+                       guint       position,
+                       guint       removed,
+                       guint       added,
+                       gpointer    data)
+{
+  GtkTreeListRow *row;
+
+  /* collapse the parent of the row that was just expanded */
+  if (position != 2)
+    return;
+
+  row = gtk_tree_list_model_get_row (GTK_TREE_LIST_MODEL (model), 0);
+  gtk_tree_list_row_set_expanded (row, FALSE);
+  g_object_unref (row);
+}
+
+static void
+test_incremental_collapse_in_handler (void)
+{
+  GtkTreeListModel *tree;
+  GtkTreeListRow *row;
+
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (new_store (100, 100, 100)), TRUE, FALSE, create_sub_model_cb, NULL, NULL);
+
+  /* the first pending row will be the first child of the first row */
+  row = gtk_tree_list_model_get_row (tree, 0);
+  gtk_tree_list_row_set_expanded (row, TRUE);
+  g_object_unref (row);
+  row = gtk_tree_list_model_get_row (tree, 1);
+
+  gtk_tree_list_model_set_incremental (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+  g_signal_connect (tree, "items-changed", G_CALLBACK (collapse_first_row_cb), NULL);
+  ensure_updated ();
+
+  g_object_unref (row);
+  g_object_unref (tree);
+}
+
+static void
+test_incremental_stop (void)
+{
+  GtkTreeListModel *tree;
+
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (new_store (1000, 1000, 1000)), TRUE, FALSE, create_sub_model_cb, NULL, NULL);
+  gtk_tree_list_model_set_incremental (tree, TRUE);
+  gtk_tree_list_model_set_autoexpand (tree, TRUE);
+  assert_model (tree, "1000");
+
+  /* turning off autoexpand drops the rows that are still waiting */
+  gtk_tree_list_model_set_autoexpand (tree, FALSE);
+  ensure_updated ();
+  assert_model (tree, "1000");
+
+  g_object_unref (tree);
+}
+
+static void
+test_performance (void)
+{
+  GtkTreeListModel *tree;
+  GtkTreeListRow *row;
+  gint64 start, end;
+  guint i, n_items;
+  GListStore *store;
+
+  if (!g_test_perf ())
+    {
+      g_test_skip ("Run with -m perf to benchmark");
+      return;
+    }
+
+  /* 1,111,111 nodes, 7 levels deep */
+  store = new_store (1000000, 1000000, 1000000);
+
+  start = g_get_monotonic_time ();
+  tree = gtk_tree_list_model_new (G_LIST_MODEL (store), TRUE, TRUE, create_sub_model_cb, NULL, NULL);
+  end = g_get_monotonic_time ();
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (tree));
+  g_test_message ("expanded %u items in %uus", n_items, (guint) (end - start));
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < 100000; i++)
+    {
+      guint pos = g_test_rand_int_range (0, n_items);
+
+      row = gtk_tree_list_model_get_row (tree, pos);
+      g_assert_cmpuint (gtk_tree_list_row_get_position (row), ==, pos);
+      g_object_unref (row);
+    }
+  end = g_get_monotonic_time ();
+  g_test_message ("100000 row lookups in %uus", (guint) (end - start));
+
+  g_object_unref (tree);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -392,6 +552,11 @@ main (int argc, char *argv[])
   g_test_add_func ("/treelistmodel/expand", test_expand);
   g_test_add_func ("/treelistmodel/remove_some", test_remove_some);
   g_test_add_func ("/treelistmodel/collapse-change", test_collapse_change);
+  g_test_add_func ("/treelistmodel/incremental", test_incremental);
+  g_test_add_func ("/treelistmodel/incremental-collapse", test_incremental_collapse);
+  g_test_add_func ("/treelistmodel/incremental-collapse-in-handler", test_incremental_collapse_in_handler);
+  g_test_add_func ("/treelistmodel/incremental-stop", test_incremental_stop);
+  g_test_add_func ("/treelistmodel/performance", test_performance);
 
   return g_test_run ();
 }